@@ -1,29 +1,144 @@
 #include "booking/book_keeper.hpp"
 
+#include <algorithm>
+
 namespace tradecore::booking {
 
-void BookKeeper::book_trade(const Trade& trade) {
+void BookKeeper::book_trade(const Trade& trade, const instrument::Instrument& instrument) {
     trades_.push_back(trade);
+    keep_time_order(trades_.size() - 1);
+    index_.add(trades_, trades_.size() - 1);
+    double fx_rate = fx_.rate(instrument.currency);
+    auto rows = ledger_.rows_for(trade, instrument, fx_rate);
+    ledger_.apply(rows, trade);
+    after_fills(rows, trade);
+    update_fx(instrument, trade);
+}
+
+void BookKeeper::book_trades(const std::vector<Trade>& trades,
+                             const instrument::Instrument& instrument) {
+    if (trades.empty()) return;
+    size_t first = trades_.size();
+    trades_.insert(trades_.end(), trades.begin(), trades.end());
+    keep_time_order(first);
+    index_.add(trades_, first);
+    double fx_rate = fx_.rate(instrument.currency);
+
+    const Trade* prev = nullptr;
+    Ledger::Rows rows{};
+    for (const auto& trade : trades) {
+        bool same = prev && prev->symbol == trade.symbol && prev->account == trade.account &&
+                    prev->strategy_id == trade.strategy_id;
+        if (!same) {
+            if (prev) after_fills(rows, *prev);
+            rows = ledger_.rows_for(trade, instrument, fx_rate);
+        }
+        ledger_.apply(rows, trade);
+        prev = &trade;
+    }
+    after_fills(rows, *prev);
+    update_fx(instrument, trades.back());
+}
+
+void BookKeeper::set_snapshots(PositionSnapshots* snapshots) {
+    snapshots_ = snapshots;
+    snapshot_slots_.clear();
+}
+
+std::string BookKeeper::account_key(const std::string& account, const std::string& symbol) {
+    return account + '|' + symbol;
+}
+
+std::string BookKeeper::strategy_key(const std::string& account, const std::string& strategy_id,
+                                     const std::string& symbol) {
+    return account + '|' + strategy_id + '|' + symbol;
+}
+
+void BookKeeper::after_fills(const Ledger::Rows& rows, const Trade& trade) {
+    if (valuation_) valuation_->on_position(ledger_.row(rows.firm));
+    if (!snapshots_) return;
+    store_snapshot(rows.firm, trade, 0);
+    store_snapshot(rows.account, trade, 1);
+    store_snapshot(rows.strategy, trade, 2);
+}
+
+void BookKeeper::store_snapshot(uint32_t row, const Trade& trade, int level) {
+    if (row >= snapshot_slots_.size()) snapshot_slots_.resize(row + 1, PositionSnapshots::kFull);
+    auto& slot = snapshot_slots_[row];
+    if (slot == PositionSnapshots::kFull) {
+        slot = snapshots_->slot(
+            level == 0 ? trade.symbol
+            : level == 1 ? account_key(trade.account, trade.symbol)
+            : strategy_key(trade.account, trade.strategy_id, trade.symbol));
+        if (slot == PositionSnapshots::kFull) return;
+    }
+    publish_row(row);
+}
+
+void BookKeeper::publish_row(uint32_t row) {
+    const auto& pos = ledger_.row(row);
+    snapshots_->store(snapshot_slots_[row],
+                      PositionSnapshot{pos.quantity, pos.avg_price, pos.realized_pnl,
+                                       pos.realized_pnl_base, pos.multiplier, pos.fx_rate});
+}
+
+void BookKeeper::set_fx_rate(const std::string& currency, double to_base) {
+    fx_.set_rate(currency, to_base);
+    publish_fx(currency);
+}
+
+void BookKeeper::update_fx(const instrument::Instrument& instrument, const Trade& last) {
+    if (instrument.asset_class != instrument::AssetClass::FX) return;
+    if (auto currency = fx_.on_trade(instrument, last.price.to_double())) publish_fx(*currency);
+}
 
-    auto& pos = positions_[trade.symbol];
-    if (pos.symbol.empty()) {
-        pos.symbol = trade.symbol;
+void BookKeeper::publish_fx(const std::string& currency) {
+    double rate = fx_.rate(currency);
+    ledger_.set_fx_rate(currency, rate);
+    if (valuation_) valuation_->on_fx_rate(currency, rate);
+    if (!snapshots_) return;
+    for (uint32_t row = 0; row < snapshot_slots_.size(); ++row) {
+        if (snapshot_slots_[row] != PositionSnapshots::kFull &&
+            ledger_.row(row).currency == currency) {
+            publish_row(row);
+        }
     }
-    pos.apply_fill(trade.side, trade.quantity, trade.price);
 }
 
 const Position* BookKeeper::get_position(const std::string& symbol) const {
-    auto it = positions_.find(symbol);
-    return (it != positions_.end()) ? &it->second : nullptr;
+    return ledger_.position(ledger_.firm(), symbol);
 }
 
 std::vector<Position> BookKeeper::get_all_positions() const {
+    return positions_of(&ledger_.firm());
+}
+
+std::vector<Position> BookKeeper::get_account_positions(const std::string& account) const {
+    return positions_of(ledger_.account(account));
+}
+
+std::vector<Position> BookKeeper::get_strategy_positions(const std::string& account,
+                                                         const std::string& strategy_id) const {
+    return positions_of(ledger_.strategy(account, strategy_id));
+}
+
+std::vector<Position> BookKeeper::positions_of(const Ledger::Node* node) const {
     std::vector<Position> result;
-    result.reserve(positions_.size());
-    for (const auto& [_, pos] : positions_) {
-        result.push_back(pos);
+    if (!node) return result;
+    result.reserve(node->rows.size());
+    for (uint32_t row : node->rows) {
+        result.push_back(ledger_.row(row));
     }
     return result;
 }
 
+void BookKeeper::keep_time_order(size_t first) {
+    // Wall-clock stamps can step back (NTP); clamp so the log stays sorted
+    for (size_t i = std::max<size_t>(first, 1); i < trades_.size(); ++i) {
+        if (trades_[i].timestamp < trades_[i - 1].timestamp) {
+            trades_[i].timestamp = trades_[i - 1].timestamp;
+        }
+    }
+}
+
 }  // namespace tradecore::booking
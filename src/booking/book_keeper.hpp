@@ -1,34 +1,121 @@
 #pragma once
 
 #include <string>
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "booking/fx_rates.hpp"
+#include "booking/ledger.hpp"
+#include "booking/mark_to_market.hpp"
 #include "booking/position.hpp"
 #include "booking/trade.hpp"
+#include "booking/trade_index.hpp"
 
 namespace tradecore::booking {
 
 class BookKeeper {
 public:
-    /// Record a trade and update positions.
-    void book_trade(const Trade& trade);
+    /// PnL at the account and firm level is reported in base_currency.
+    explicit BookKeeper(std::string base_currency = "USD") : fx_(std::move(base_currency)) {}
 
-    /// Get current position for a symbol. Returns nullptr if no position.
+    /// Keep valuation's positions in step with every booked fill (optional).
+    void set_valuation(MarkToMarket* valuation) { valuation_ = valuation; }
+
+    /// Record a trade in instrument and update positions. A trade in an FX
+    /// spot pair also updates the conversion rate it implies.
+    void book_trade(const Trade& trade, const instrument::Instrument& instrument = {});
+
+    /// Record a batch of trades (e.g. every fill of one order) in order.
+    /// Consecutive trades on the same account, strategy and symbol share one
+    /// position lookup.
+    void book_trades(const std::vector<Trade>& trades,
+                     const instrument::Instrument& instrument = {});
+
+    /// Get current firm-wide position for a symbol. Returns nullptr if no position.
     const Position* get_position(const std::string& symbol) const;
 
-    /// Get all positions.
+    /// Get all firm-wide positions.
     std::vector<Position> get_all_positions() const;
 
+    /// An account's positions netted across its strategies (empty if unknown).
+    std::vector<Position> get_account_positions(const std::string& account) const;
+
+    /// One strategy's positions within an account (empty if unknown).
+    std::vector<Position> get_strategy_positions(const std::string& account,
+                                                 const std::string& strategy_id) const;
+
+    /// Positions and realized PnL at every level.
+    const Ledger& ledger() const { return ledger_; }
+
+    /// Publish every position touched by a fill, or by a new FX rate for its
+    /// currency, to snapshots for reader threads (nullptr stops). Set before
+    /// trading starts: rows are published when they next change.
+    void set_snapshots(PositionSnapshots* snapshots);
+
+    /// Snapshot keys: the bare symbol firm-wide, then these for one account
+    /// netted and for one strategy within an account.
+    static std::string account_key(const std::string& account, const std::string& symbol);
+    static std::string strategy_key(const std::string& account, const std::string& strategy_id,
+                                    const std::string& symbol);
+
+    /// Positions changed since the last drain, at every level; see
+    /// Ledger::drain_changed.
+    template <typename Fn>
+    void drain_changed(Fn&& fn) { ledger_.drain_changed(std::forward<Fn>(fn)); }
+
+    /// Rates into the base currency, as learned from FX spot trades.
+    const FxRates& fx_rates() const { return fx_; }
+
+    /// Set a conversion rate directly (e.g. a reference fixing) and re-cache it
+    /// on every position held in currency.
+    void set_fx_rate(const std::string& currency, double to_base);
+
     /// Get trade history (book of records).
     const std::vector<Trade>& get_trades() const { return trades_; }
 
+    /// Indexed views of the trade history, in booking order, without copies
+    /// (see TradeIndex). Time bounds are [from, to) in the booking timestamp
+    /// format; empty means open-ended. Valid until the next trade is booked.
+    TradeRange trades_between(const std::string& from, const std::string& to = {}) const {
+        return index_.all(trades_, from, to);
+    }
+    TradeRange trades_for_symbol(const std::string& symbol, const std::string& from = {},
+                                 const std::string& to = {}) const {
+        return index_.for_symbol(trades_, symbol, from, to);
+    }
+    TradeRange trades_for_strategy(const std::string& strategy_id, const std::string& from = {},
+                                   const std::string& to = {}) const {
+        return index_.for_strategy(trades_, strategy_id, from, to);
+    }
+    TradeRange trades_for_strategy_symbol(const std::string& strategy_id,
+                                          const std::string& symbol,
+                                          const std::string& from = {},
+                                          const std::string& to = {}) const {
+        return index_.for_strategy_symbol(trades_, strategy_id, symbol, from, to);
+    }
+    TradeRange trades_for_order(const std::string& order_id) const {
+        return index_.for_order(trades_, order_id);
+    }
+
     /// Get number of trades booked.
     size_t trade_count() const { return trades_.size(); }
 
 private:
+    std::vector<Position> positions_of(const Ledger::Node* node) const;
+    void after_fills(const Ledger::Rows& rows, const Trade& trade);
+    void keep_time_order(size_t first);
+    void store_snapshot(uint32_t row, const Trade& trade, int level);
+    void publish_row(uint32_t row);
+    void update_fx(const instrument::Instrument& instrument, const Trade& last);
+    void publish_fx(const std::string& currency);
+
     std::vector<Trade> trades_;
-    std::unordered_map<std::string, Position> positions_;
+    TradeIndex index_;
+    Ledger ledger_;
+    FxRates fx_;
+    MarkToMarket* valuation_ = nullptr;
+    PositionSnapshots* snapshots_ = nullptr;
+    std::vector<uint32_t> snapshot_slots_;  // ledger row -> snapshot slot (kFull = none yet)
 };
 
 }  // namespace tradecore::booking
@@ -0,0 +1,61 @@
+#include "booking/fx_rates.hpp"
+
+namespace tradecore::booking {
+
+std::optional<std::string> FxRates::on_trade(const instrument::Instrument& pair, double price) {
+    if (pair.asset_class != instrument::AssetClass::FX || price <= 0.0) return std::nullopt;
+    auto currencies = split_pair(pair);
+    if (!currencies) return std::nullopt;
+    const auto& [ccy1, ccy2] = *currencies;
+
+    // price = units of ccy2 per unit of ccy1
+    std::string currency;
+    double to_base = 0.0;
+    if (ccy2 == base_) {
+        currency = ccy1;
+        to_base = price;
+    } else if (ccy1 == base_) {
+        currency = ccy2;
+        to_base = 1.0 / price;
+    } else if (has_rate(ccy2)) {
+        currency = ccy1;
+        to_base = price * rate(ccy2);
+    } else if (has_rate(ccy1)) {
+        currency = ccy2;
+        to_base = rate(ccy1) / price;
+    } else {
+        return std::nullopt;
+    }
+
+    auto it = rates_.find(currency);
+    if (it != rates_.end() && it->second == to_base) return std::nullopt;
+    set_rate(currency, to_base);
+    return currency;
+}
+
+void FxRates::set_rate(const std::string& currency, double to_base) {
+    if (currency == base_ || to_base <= 0.0) return;
+    rates_[currency] = to_base;
+}
+
+double FxRates::rate(const std::string& currency) const {
+    auto it = rates_.find(currency);
+    return (it != rates_.end()) ? it->second : 1.0;
+}
+
+bool FxRates::has_rate(const std::string& currency) const {
+    return currency == base_ || rates_.count(currency) > 0;
+}
+
+std::optional<std::pair<std::string, std::string>> FxRates::split_pair(
+    const instrument::Instrument& pair) {
+    if (pair.base_currency && pair.quote_currency) {
+        return std::make_pair(*pair.base_currency, *pair.quote_currency);
+    }
+    const auto& s = pair.symbol;
+    if (s.size() == 7 && s[3] == '/') return std::make_pair(s.substr(0, 3), s.substr(4, 3));
+    if (s.size() == 6) return std::make_pair(s.substr(0, 3), s.substr(3, 3));
+    return std::nullopt;
+}
+
+}  // namespace tradecore::booking
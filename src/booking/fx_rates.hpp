@@ -0,0 +1,44 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "instrument/instrument.hpp"
+
+namespace tradecore::booking {
+
+/// Conversion rates from each currency into one base currency, learned from
+/// FX spot trades. A pair trades as quote currency per unit of its base
+/// currency (EURUSD at 1.10 = 1.10 USD per EUR). A pair quoted against the
+/// base currency sets a rate directly. A cross pair sets one side from the other
+/// once either is known.
+class FxRates {
+public:
+    explicit FxRates(std::string base_currency = "USD") : base_(std::move(base_currency)) {}
+
+    const std::string& base_currency() const { return base_; }
+
+    /// Learn from an FX spot trade at price. Returns the currency whose rate
+    /// changed, if any. Non-FX instruments and unparseable pairs are ignored.
+    std::optional<std::string> on_trade(const instrument::Instrument& pair, double price);
+
+    void set_rate(const std::string& currency, double to_base);
+
+    /// Base-currency value of one unit of currency. Amounts in a currency
+    /// with no rate yet pass through unconverted (1.0).
+    double rate(const std::string& currency) const;
+    bool has_rate(const std::string& currency) const;
+
+    /// The two currencies of a pair: base/quote currencies when given, else
+    /// the symbol as "EUR/USD" or "EURUSD".
+    static std::optional<std::pair<std::string, std::string>> split_pair(
+        const instrument::Instrument& pair);
+
+private:
+    std::string base_;
+    std::unordered_map<std::string, double> rates_;
+};
+
+}  // namespace tradecore::booking
@@ -0,0 +1,91 @@
+#include "booking/ledger.hpp"
+
+namespace tradecore::booking {
+
+Ledger::Ledger() : nodes_(1) {}
+
+Ledger::Rows Ledger::rows_for(const Trade& trade, const instrument::Instrument& instrument,
+                             double fx_rate) {
+    auto [it, inserted] = accounts_.try_emplace(trade.account, 0);
+    if (inserted) {
+        it->second = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+    uint32_t account = it->second;
+    uint32_t strategy = child(account, trade.strategy_id);
+    return {row_in(strategy, trade.symbol, instrument, fx_rate),
+            row_in(account, trade.symbol, instrument, fx_rate),
+            row_in(0, trade.symbol, instrument, fx_rate)};
+}
+
+const Position& Ledger::apply(const Rows& rows, const Trade& trade) {
+    apply_row(rows.strategy, trade);
+    apply_row(rows.account, trade);
+    apply_row(rows.firm, trade);
+    return rows_[rows.firm];
+}
+
+void Ledger::set_fx_rate(const std::string& currency, double fx_rate) {
+    auto it = by_currency_.find(currency);
+    if (it == by_currency_.end()) return;
+    for (uint32_t row : it->second) {
+        rows_[row].fx_rate = fx_rate;
+        touch(row);
+    }
+}
+
+const Ledger::Node* Ledger::account(const std::string& account) const {
+    auto it = accounts_.find(account);
+    return (it != accounts_.end()) ? &nodes_[it->second] : nullptr;
+}
+
+const Ledger::Node* Ledger::strategy(const std::string& account,
+                                     const std::string& strategy) const {
+    const auto* parent = this->account(account);
+    if (!parent) return nullptr;
+    auto it = parent->children.find(strategy);
+    return (it != parent->children.end()) ? &nodes_[it->second] : nullptr;
+}
+
+const Position* Ledger::position(const Node& node, const std::string& symbol) const {
+    auto it = node.by_symbol.find(symbol);
+    return (it != node.by_symbol.end()) ? &rows_[it->second] : nullptr;
+}
+
+uint32_t Ledger::child(uint32_t parent, const std::string& key) {
+    auto& children = nodes_[parent].children;
+    auto it = children.find(key);
+    if (it != children.end()) return it->second;
+    auto id = static_cast<uint32_t>(nodes_.size());
+    children.emplace(key, id);
+    nodes_.emplace_back();  // invalidates `children`; not used again
+    return id;
+}
+
+uint32_t Ledger::row_in(uint32_t node, const std::string& symbol,
+                        const instrument::Instrument& instrument, double fx_rate) {
+    auto [it, inserted] = nodes_[node].by_symbol.try_emplace(symbol, 0);
+    if (inserted) {
+        it->second = static_cast<uint32_t>(rows_.size());
+        auto& pos = rows_.emplace_back();
+        pos.symbol = symbol;
+        pos.currency = instrument.currency;
+        pos.multiplier = instrument.contract_size;
+        pos.fx_rate = fx_rate;
+        by_currency_[pos.currency].push_back(it->second);
+        owners_.push_back(node);
+        pending_.push_back(0);
+        nodes_[node].rows.push_back(it->second);
+    }
+    return it->second;
+}
+
+void Ledger::apply_row(uint32_t row, const Trade& trade) {
+    auto& pos = rows_[row];
+    double realized = pos.realized_pnl_base;
+    pos.apply_fill(trade.side, trade.quantity, trade.price);
+    nodes_[owners_[row]].realized_pnl += pos.realized_pnl_base - realized;
+    touch(row);
+}
+
+}  // namespace tradecore::booking
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "booking/position.hpp"
+#include "booking/trade.hpp"
+#include "instrument/instrument.hpp"
+
+namespace tradecore::booking {
+
+/// Positions at three levels: (account, strategy, symbol), netted per
+/// (account, symbol), and netted firm-wide per symbol. Every fill is applied
+/// to its row at each level as it is booked, so any level is one hash lookup
+/// away and no request ever aggregates by scanning.
+///
+/// All rows live in one table and never move, so a Position pointer (as the
+/// risk engine caches) stays valid as the ledger grows. A node (the firm, an
+/// account, or an account's strategy) lists its rows, one per symbol, and
+/// carries the sum of their realized PnL in the base currency. Each row
+/// caches its instrument's contract multiplier and its currency's FX rate,
+/// so valuing it in the base currency is a multiply, not a lookup.
+class Ledger {
+public:
+    struct Node {
+        std::vector<uint32_t> rows;                          // into the row table
+        std::unordered_map<std::string, uint32_t> by_symbol; // symbol -> row
+        std::unordered_map<std::string, uint32_t> children;  // account: strategy -> node
+        double realized_pnl = 0.0;                           // base currency
+    };
+
+    /// The row of one trade at each level.
+    struct Rows {
+        uint32_t strategy;
+        uint32_t account;
+        uint32_t firm;
+    };
+
+    Ledger();
+
+    /// Rows for a trade's account, strategy and symbol, created on first use
+    /// with the instrument's terms and the current rate for its currency.
+    Rows rows_for(const Trade& trade, const instrument::Instrument& instrument = {},
+                  double fx_rate = 1.0);
+
+    /// Re-cache a currency's rate on every row held in it.
+    void set_fx_rate(const std::string& currency, double fx_rate);
+
+    /// Call fn(node, position) once for every row changed since the last
+    /// drain, in order of first change, and forget them.
+    template <typename Fn>
+    void drain_changed(Fn&& fn);
+
+    /// Apply a fill to all three rows. Returns the firm-level position.
+    const Position& apply(const Rows& rows, const Trade& trade);
+
+    const Node& firm() const { return nodes_[0]; }
+    /// nullptr if the account (or its strategy) has never traded.
+    const Node* account(const std::string& account) const;
+    const Node* strategy(const std::string& account, const std::string& strategy) const;
+
+    /// A node's position in symbol, or nullptr.
+    const Position* position(const Node& node, const std::string& symbol) const;
+    const Position& row(uint32_t index) const { return rows_[index]; }
+    /// Stable index of a node (pointers move as the ledger grows).
+    uint32_t index_of(const Node& node) const {
+        return static_cast<uint32_t>(&node - nodes_.data());
+    }
+
+private:
+    uint32_t child(uint32_t parent, const std::string& key);
+    uint32_t row_in(uint32_t node, const std::string& symbol,
+                    const instrument::Instrument& instrument, double fx_rate);
+    void apply_row(uint32_t row, const Trade& trade);
+    void touch(uint32_t row) {
+        if (pending_[row]) return;
+        pending_[row] = 1;
+        changed_.push_back(row);
+    }
+
+    std::vector<Node> nodes_;        // [0] is the firm
+    std::deque<Position> rows_;
+    std::vector<uint32_t> owners_;   // row -> node
+    std::unordered_map<std::string, uint32_t> accounts_;  // account -> node
+    std::unordered_map<std::string, std::vector<uint32_t>> by_currency_;  // currency -> rows
+    std::vector<uint8_t> pending_;   // row -> listed in changed_
+    std::vector<uint32_t> changed_;  // each row at most once, so bounded by the row count
+};
+
+template <typename Fn>
+void Ledger::drain_changed(Fn&& fn) {
+    for (uint32_t row : changed_) {
+        pending_[row] = 0;
+        fn(owners_[row], static_cast<const Position&>(rows_[row]));
+    }
+    changed_.clear();
+}
+
+}  // namespace tradecore::booking
@@ -0,0 +1,86 @@
+#include "booking/mark_to_market.hpp"
+
+#include <numeric>
+
+namespace tradecore::booking {
+
+uint32_t MarkToMarket::row(const std::string& symbol) {
+    uint32_t id = symbols_.intern(symbol);
+    if (id > qty_.size()) {
+        qty_.push_back(0.0);
+        avg_.push_back(0.0);
+        mark_.push_back(0.0);
+        factor_.push_back(1.0);
+        upnl_.push_back(0.0);
+        multiplier_.push_back(1.0);
+        currency_.emplace_back();
+    }
+    return id - 1;
+}
+
+void MarkToMarket::on_position(const Position& pos) {
+    uint32_t i = row(pos.symbol);
+    qty_[i] = pos.quantity.to_double();
+    avg_[i] = pos.avg_price;
+    factor_[i] = pos.multiplier * pos.fx_rate;
+    multiplier_[i] = pos.multiplier;
+    if (currency_[i] != pos.currency) currency_[i] = pos.currency;
+    update_row(i);
+}
+
+void MarkToMarket::on_fx_rate(const std::string& currency, double fx_rate) {
+    for (uint32_t i = 0; i < currency_.size(); ++i) {
+        if (currency_[i] != currency) continue;
+        factor_[i] = multiplier_[i] * fx_rate;
+        update_row(i);
+    }
+}
+
+void MarkToMarket::on_mark(const std::string& symbol, double mark) {
+    on_mark(row(symbol), mark);
+}
+
+void MarkToMarket::on_mark(uint32_t row, double mark) {
+    if (row >= mark_.size() || mark_[row] == mark) return;
+    mark_[row] = mark;
+    update_row(row);
+}
+
+double MarkToMarket::mark(const std::string& symbol) const {
+    uint32_t id = symbols_.find(symbol);
+    return id ? mark_[id - 1] : 0.0;
+}
+
+double MarkToMarket::unrealized_pnl(const std::string& symbol) const {
+    uint32_t id = symbols_.find(symbol);
+    return id ? upnl_[id - 1] : 0.0;
+}
+
+double MarkToMarket::unrealized_pnl(const Position& pos) const {
+    double m = mark(pos.symbol);
+    return (m - pos.avg_price) * pos.quantity.to_double() * pos.multiplier * pos.fx_rate *
+           (m > 0.0);
+}
+
+void MarkToMarket::update_row(uint32_t i) {
+    double upnl = (mark_[i] - avg_[i]) * qty_[i] * factor_[i] * (mark_[i] > 0.0);
+    total_ += upnl - upnl_[i];
+    upnl_[i] = upnl;
+}
+
+double MarkToMarket::revalue() {
+    const size_t n = qty_.size();
+    const double* qty = qty_.data();
+    const double* avg = avg_.data();
+    const double* mark = mark_.data();
+    const double* factor = factor_.data();
+    double* upnl = upnl_.data();
+    // Branch-free so the loop vectorizes
+    for (size_t i = 0; i < n; ++i) {
+        upnl[i] = (mark[i] - avg[i]) * qty[i] * factor[i] * (mark[i] > 0.0);
+    }
+    total_ = std::accumulate(upnl, upnl + n, 0.0);
+    return total_;
+}
+
+}  // namespace tradecore::booking
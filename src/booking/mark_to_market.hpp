@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "booking/position.hpp"
+#include "instrument/symbol_table.hpp"
+
+namespace tradecore::booking {
+
+/// Unrealized PnL for every open position, kept current as fills and marks
+/// arrive. Positions live in parallel arrays (structure of arrays) indexed by
+/// a dense symbol row, so a fill or a price change touches one row and
+/// adjusts the running total in O(1), and a full revaluation is a straight
+/// pass over contiguous doubles the compiler vectorizes. Values are in the
+/// base currency: each row carries one factor, contract multiplier times
+/// FX rate, refreshed only when that currency's rate moves.
+class MarkToMarket {
+public:
+    /// Row for a symbol, adding an empty one on first sight.
+    uint32_t row(const std::string& symbol);
+
+    /// Take a position's new size and cost after a fill.
+    void on_position(const Position& pos);
+
+    /// A currency's rate into the base currency moved; revalue its rows.
+    void on_fx_rate(const std::string& currency, double fx_rate);
+
+    /// New mark price (BBO mid, else last trade). A mark of 0 means unknown
+    /// and values the position at 0.
+    void on_mark(const std::string& symbol, double mark);
+    void on_mark(uint32_t row, double mark);
+
+    double mark(const std::string& symbol) const;
+    double unrealized_pnl(const std::string& symbol) const;
+    /// Any position (e.g. one account's) valued at its symbol's mark.
+    double unrealized_pnl(const Position& pos) const;
+    double total_unrealized_pnl() const { return total_; }
+
+    /// Recompute every row and the total from scratch (snapshots); also clears
+    /// any rounding drift the running total picked up. Returns the total.
+    double revalue();
+
+    size_t size() const { return qty_.size(); }
+
+private:
+    void update_row(uint32_t row);
+
+    instrument::SymbolTable symbols_;  // row = ID - 1
+    std::vector<double> qty_;          // signed position
+    std::vector<double> avg_;          // average entry price
+    std::vector<double> mark_;
+    std::vector<double> factor_;       // multiplier * FX rate
+    std::vector<double> upnl_;
+    std::vector<double> multiplier_;   // cold: only read when a rate moves
+    std::vector<std::string> currency_;
+    double total_ = 0.0;
+};
+
+}  // namespace tradecore::booking
@@ -1,61 +1,66 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <string>
 
+#include "core/fixed_point.hpp"
+#include "core/snapshot_table.hpp"
+#include "orders/order.hpp"
+
 namespace tradecore::booking {
 
+using core::Price;
+using core::Qty;
+
 struct Position {
     std::string symbol;
-    double quantity = 0.0;      // positive = long, negative = short
+    Qty quantity;               // positive = long, negative = short
     double avg_price = 0.0;
-    double realized_pnl = 0.0;
-    double cost_basis = 0.0;
-
-    void apply_fill(const std::string& side, double fill_qty, double fill_price) {
-        if (side == "buy") {
-            if (quantity >= 0) {
-                // Adding to long
-                cost_basis += fill_qty * fill_price;
-                quantity += fill_qty;
-                avg_price = (quantity != 0.0) ? cost_basis / quantity : 0.0;
-            } else {
-                // Closing short
-                double pnl = fill_qty * (avg_price - fill_price);
-                realized_pnl += pnl;
-                quantity += fill_qty;
-                if (quantity > 0) {
-                    avg_price = fill_price;
-                    cost_basis = quantity * fill_price;
-                } else if (quantity == 0) {
-                    avg_price = 0.0;
-                    cost_basis = 0.0;
-                } else {
-                    cost_basis = -quantity * avg_price;
-                }
-            }
-        } else {  // sell
-            if (quantity > 0) {
-                // Closing long
-                double pnl = fill_qty * (fill_price - avg_price);
-                realized_pnl += pnl;
-                quantity -= fill_qty;
-                if (quantity < 0) {
-                    avg_price = fill_price;
-                    cost_basis = -quantity * fill_price;
-                } else if (quantity == 0) {
-                    avg_price = 0.0;
-                    cost_basis = 0.0;
-                } else {
-                    cost_basis = quantity * avg_price;
-                }
-            } else {
-                // Adding to short
-                cost_basis += fill_qty * fill_price;
-                quantity -= fill_qty;
-                avg_price = (quantity != 0.0) ? cost_basis / -quantity : 0.0;
-            }
-        }
+    double realized_pnl = 0.0;  // in currency, contract multiplier applied
+    double cost_basis = 0.0;    // |quantity| * avg_price
+
+    std::string currency = "USD";
+    double multiplier = 1.0;        // instrument contract size
+    double fx_rate = 1.0;           // currency -> base currency, kept current by the Ledger
+    double realized_pnl_base = 0.0; // each realization converted at the rate of the day
+
+    /// Open exposure at entry prices, in the base currency.
+    double notional_base() const { return cost_basis * multiplier * fx_rate; }
+
+    /// One formula for open, add, reduce, close and flip. The fill first
+    /// closes up to |quantity| against the open side at avg_price; whatever
+    /// is left opens at fill_price. No per-case branches.
+    void apply_fill(orders::Side side, Qty fill_qty, Price fill_price) {
+        Qty delta = (side == orders::Side::Buy) ? fill_qty : -fill_qty;
+        int64_t dir = (quantity.raw() > 0) - (quantity.raw() < 0);
+        bool against = (quantity.raw() ^ delta.raw()) < 0;
+        Qty closed = against ? std::min(fill_qty, core::abs(quantity)) : Qty{};
+        Qty opened = fill_qty - closed;
+        double px = fill_price.to_double();
+
+        double realized = closed.to_double() * (px - avg_price) * static_cast<double>(dir) *
+                          multiplier;
+        realized_pnl += realized;
+        realized_pnl_base += realized * fx_rate;
+        quantity += delta;
+
+        double size = core::abs(quantity).to_double();
+        cost_basis = (size - opened.to_double()) * avg_price + opened.to_double() * px;
+        avg_price = quantity.is_zero() ? 0.0 : cost_basis / size;
     }
 };
 
+/// A position as published for reader threads (BookKeeper::set_snapshots).
+struct PositionSnapshot {
+    Qty quantity;
+    double avg_price = 0.0;
+    double realized_pnl = 0.0;
+    double realized_pnl_base = 0.0;
+    double multiplier = 1.0;
+    double fx_rate = 1.0;  // republished when the currency's rate moves
+};
+
+using PositionSnapshots = core::SnapshotTable<PositionSnapshot>;
+
 }  // namespace tradecore::booking
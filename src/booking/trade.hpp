@@ -2,6 +2,9 @@
 
 #include <string>
 
+#include "core/fixed_point.hpp"
+#include "orders/order.hpp"
+
 namespace tradecore::booking {
 
 struct Trade {
@@ -9,12 +12,13 @@ struct Trade {
     std::string order_id;
     std::string cl_ord_id;
     std::string symbol;
-    std::string side;  // "buy" / "sell"
-    double quantity = 0.0;
-    double price = 0.0;
+    orders::Side side = orders::Side::Buy;
+    core::Qty quantity;
+    core::Price price;
     double commission = 0.0;
     std::string timestamp;
     std::string strategy_id;
+    std::string account;
 };
 
 }  // namespace tradecore::booking
@@ -0,0 +1,570 @@
+#include "booking/trade_archive.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unordered_map>
+
+namespace tradecore::booking {
+
+namespace {
+
+constexpr char kMagic[4] = {'T', 'C', 'A', 'R'};
+constexpr uint32_t kVersion = 1;
+
+enum Codec : uint8_t { kRaw = 0, kLz = 1 };
+
+enum Column : uint8_t {
+    kTime, kPrice, kQuantity, kSide, kSymbol, kStrategy, kAccount, kCommission,
+    kTradeId, kOrderId, kClOrdId, kSymbolDict, kStrategyDict, kAccountDict,
+    kColumnCount
+};
+
+// First byte of the time column
+enum TimeEncoding : uint8_t { kTimeMs = 0, kTimeText = 1 };
+
+constexpr size_t kColumnHeader = 1 + 4 + 4;
+
+// ---------------------------------------------------------------------------
+// Encoding primitives
+
+void put_varint(std::string& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+uint64_t zigzag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+int64_t unzigzag(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+void put_u32(std::string& out, uint32_t v) {
+    char b[4];
+    std::memcpy(b, &v, 4);
+    out.append(b, 4);
+}
+
+void put_string(std::string& out, const std::string& s) {
+    put_varint(out, s.size());
+    out.append(s);
+}
+
+/// Length of the prefix shared with the previous value, then the rest.
+void put_front_coded(std::string& out, const std::string& prev, const std::string& s) {
+    size_t shared = 0;
+    size_t max = std::min(prev.size(), s.size());
+    while (shared < max && prev[shared] == s[shared]) ++shared;
+    put_varint(out, shared);
+    put_varint(out, s.size() - shared);
+    out.append(s, shared, std::string::npos);
+}
+
+/// Bounds-checked cursor; any overrun clears ok and reads zeros from then on.
+struct ByteReader {
+    const uint8_t* p;
+    const uint8_t* end;
+    bool ok = true;
+
+    uint64_t varint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p == end) break;
+            uint8_t b = *p++;
+            v |= static_cast<uint64_t>(b & 0x7f) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        ok = false;
+        return 0;
+    }
+
+    uint8_t u8() {
+        if (p == end) {
+            ok = false;
+            return 0;
+        }
+        return *p++;
+    }
+
+    uint32_t u32() {
+        uint32_t v = 0;
+        if (end - p < 4) {
+            ok = false;
+            return 0;
+        }
+        std::memcpy(&v, p, 4);
+        p += 4;
+        return v;
+    }
+
+    void bytes(size_t n, std::string& out) {
+        if (static_cast<size_t>(end - p) < n) {
+            ok = false;
+            return;
+        }
+        out.append(reinterpret_cast<const char*>(p), n);
+        p += n;
+    }
+
+    void string(std::string& out) {
+        out.clear();
+        bytes(varint(), out);
+    }
+
+    /// prev holds the previous value and is replaced by this one.
+    void front_coded(std::string& prev) {
+        uint64_t shared = varint();
+        uint64_t rest = varint();
+        if (shared > prev.size()) {
+            ok = false;
+            return;
+        }
+        prev.resize(shared);
+        bytes(rest, prev);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Block compression: greedy LZ77 over 4-byte hash matches. A stream of
+// (literal count, literals, match length, match offset) with a zero match
+// length after the last literals. Columns are already varint-packed, so this
+// mostly removes repeats: the same side, dictionary ID or price delta run.
+
+constexpr size_t kMinMatch = 4;
+constexpr int kHashBits = 14;
+
+std::string lz_compress(const std::string& in) {
+    const auto* src = reinterpret_cast<const uint8_t*>(in.data());
+    size_t n = in.size();
+    std::vector<int64_t> table(size_t{1} << kHashBits, -1);
+    auto hash = [&](size_t at) {
+        uint32_t v;
+        std::memcpy(&v, src + at, 4);
+        return (v * 2654435761u) >> (32 - kHashBits);
+    };
+
+    std::string out;
+    out.reserve(n / 2);
+    size_t literal = 0;
+    size_t i = 0;
+    while (i + kMinMatch <= n) {
+        uint32_t h = hash(i);
+        int64_t candidate = table[h];
+        table[h] = static_cast<int64_t>(i);
+        if (candidate < 0 || std::memcmp(src + candidate, src + i, kMinMatch) != 0) {
+            ++i;
+            continue;
+        }
+        auto from = static_cast<size_t>(candidate);
+        size_t len = kMinMatch;
+        while (i + len < n && src[from + len] == src[i + len]) ++len;
+
+        put_varint(out, i - literal);
+        out.append(in, literal, i - literal);
+        put_varint(out, len);
+        put_varint(out, i - from);
+        i += len;
+        literal = i;
+    }
+    put_varint(out, n - literal);
+    out.append(in, literal, std::string::npos);
+    put_varint(out, 0);
+    return out;
+}
+
+bool lz_decompress(const uint8_t* data, size_t size, size_t raw_size, std::string& out) {
+    ByteReader r{data, data + size};
+    out.clear();
+    out.reserve(raw_size);
+    for (;;) {
+        uint64_t literal = r.varint();
+        if (!r.ok || literal > raw_size - out.size()) return false;
+        r.bytes(literal, out);
+        uint64_t len = r.varint();
+        if (!r.ok) return false;
+        if (len == 0) break;
+        uint64_t offset = r.varint();
+        if (!r.ok || offset == 0 || offset > out.size() || len > raw_size - out.size()) {
+            return false;
+        }
+        // Byte by byte: a match may overlap the bytes it produces
+        size_t from = out.size() - offset;
+        for (size_t k = 0; k < len; ++k) out.push_back(out[from + k]);
+    }
+    return out.size() == raw_size && r.p == r.end;
+}
+
+// ---------------------------------------------------------------------------
+// Booking timestamps: YYYYMMDD-HH:MM:SS.sss (UTC)
+
+int64_t days_from_civil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    auto yoe = static_cast<unsigned>(y - era * 400);
+    unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+std::string format_timestamp(int64_t ms) {
+    int64_t days = (ms >= 0 ? ms : ms - 86'399'999) / 86'400'000;
+    int64_t in_day = ms - days * 86'400'000;
+
+    int64_t z = days + 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    auto doe = static_cast<unsigned>(z - era * 146097);
+    unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned mp = (5 * doy + 2) / 153;
+    unsigned d = doy - (153 * mp + 2) / 5 + 1;
+    unsigned m = mp < 10 ? mp + 3 : mp - 9;
+    int64_t y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%04lld%02u%02u-%02lld:%02lld:%02lld.%03lld",
+                  static_cast<long long>(y), m, d,
+                  static_cast<long long>(in_day / 3'600'000),
+                  static_cast<long long>(in_day / 60'000 % 60),
+                  static_cast<long long>(in_day / 1000 % 60),
+                  static_cast<long long>(in_day % 1000));
+    return buf;
+}
+
+/// ms since the epoch, or false unless formatting it back gives s exactly.
+bool parse_timestamp(const std::string& s, int64_t& ms) {
+    if (s.size() != 21 || s[8] != '-' || s[11] != ':' || s[14] != ':' || s[17] != '.') {
+        return false;
+    }
+    auto num = [&](size_t at, size_t len, int64_t& out) {
+        out = 0;
+        for (size_t i = at; i < at + len; ++i) {
+            if (s[i] < '0' || s[i] > '9') return false;
+            out = out * 10 + (s[i] - '0');
+        }
+        return true;
+    };
+    int64_t y, mo, d, h, mi, sec, milli;
+    if (!num(0, 4, y) || !num(4, 2, mo) || !num(6, 2, d) || !num(9, 2, h) ||
+        !num(12, 2, mi) || !num(15, 2, sec) || !num(18, 3, milli)) {
+        return false;
+    }
+    if (mo < 1 || mo > 12 || d < 1 || d > 31) return false;
+    ms = days_from_civil(y, static_cast<unsigned>(mo), static_cast<unsigned>(d)) * 86'400'000 +
+         ((h * 60 + mi) * 60 + sec) * 1000 + milli;
+    return format_timestamp(ms) == s;
+}
+
+/// Strings to dense IDs in first-seen order.
+struct Dictionary {
+    std::unordered_map<std::string, uint32_t> ids;
+    std::vector<const std::string*> values;
+
+    uint32_t id(const std::string& s) {
+        auto [it, inserted] = ids.try_emplace(s, static_cast<uint32_t>(values.size()));
+        if (inserted) values.push_back(&it->first);
+        return it->second;
+    }
+
+    void encode(std::string& out) const {
+        put_varint(out, values.size());
+        for (const auto* v : values) put_string(out, *v);
+    }
+};
+
+bool decode_dictionary(ByteReader& r, std::vector<std::string>& out) {
+    uint64_t n = r.varint();
+    if (!r.ok || n > static_cast<uint64_t>(r.end - r.p)) return false;
+    out.resize(n);
+    for (auto& s : out) r.string(s);
+    return r.ok;
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// Writer
+
+std::string TradeArchiveWriter::open(const std::string& path) {
+    close();
+    error_.clear();
+    rows_ = 0;
+    bytes_ = 0;
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) return "cannot create " + path + ": " + std::strerror(errno);
+    write(kMagic, sizeof(kMagic));
+    write(&kVersion, sizeof(kVersion));
+    pending_.reserve(chunk_rows_);
+    return error_;
+}
+
+void TradeArchiveWriter::append(const Trade& trade) {
+    if (!file_) return;
+    pending_.push_back(trade);
+    if (pending_.size() >= chunk_rows_) flush_chunk();
+}
+
+std::string TradeArchiveWriter::close() {
+    if (!file_) return error_;
+    flush_chunk();
+    if (std::fclose(file_) != 0 && error_.empty()) error_ = std::strerror(errno);
+    file_ = nullptr;
+    return error_;
+}
+
+void TradeArchiveWriter::write(const void* data, size_t size) {
+    if (!error_.empty()) return;
+    if (std::fwrite(data, 1, size, file_) != size) {
+        error_ = std::string("write failed: ") + std::strerror(errno);
+        return;
+    }
+    bytes_ += size;
+}
+
+void TradeArchiveWriter::flush_chunk() {
+    if (pending_.empty()) return;
+
+    std::vector<std::string> cols(kColumnCount);
+    Dictionary symbols, strategies, accounts;
+
+    std::vector<int64_t> times(pending_.size());
+    bool all_ms = true;
+    for (size_t i = 0; i < pending_.size() && all_ms; ++i) {
+        all_ms = parse_timestamp(pending_[i].timestamp, times[i]);
+    }
+    cols[kTime].push_back(static_cast<char>(all_ms ? kTimeMs : kTimeText));
+
+    int64_t prev_time = 0;
+    int64_t prev_price = 0;
+    const Trade* prev = nullptr;
+    static const Trade kEmpty;
+    for (size_t i = 0; i < pending_.size(); ++i) {
+        const auto& t = pending_[i];
+        const Trade& last = prev ? *prev : kEmpty;
+        if (all_ms) {
+            put_varint(cols[kTime], zigzag(times[i] - prev_time));
+            prev_time = times[i];
+        } else {
+            put_front_coded(cols[kTime], last.timestamp, t.timestamp);
+        }
+        put_varint(cols[kPrice], zigzag(t.price.raw() - prev_price));
+        prev_price = t.price.raw();
+        put_varint(cols[kQuantity], zigzag(t.quantity.raw()));
+        cols[kSide].push_back(static_cast<char>(t.side == orders::Side::Sell));
+        put_varint(cols[kSymbol], symbols.id(t.symbol));
+        put_varint(cols[kStrategy], strategies.id(t.strategy_id));
+        put_varint(cols[kAccount], accounts.id(t.account));
+        char bits[8];
+        std::memcpy(bits, &t.commission, 8);
+        cols[kCommission].append(bits, 8);
+        put_front_coded(cols[kTradeId], last.trade_id, t.trade_id);
+        put_front_coded(cols[kOrderId], last.order_id, t.order_id);
+        put_front_coded(cols[kClOrdId], last.cl_ord_id, t.cl_ord_id);
+        prev = &t;
+    }
+    symbols.encode(cols[kSymbolDict]);
+    strategies.encode(cols[kStrategyDict]);
+    accounts.encode(cols[kAccountDict]);
+
+    // Header, then each column stored compressed only where that is smaller
+    std::string& chunk = scratch_;
+    chunk.clear();
+    put_u32(chunk, static_cast<uint32_t>(pending_.size()));
+    chunk.push_back(static_cast<char>(kColumnCount));
+    std::vector<std::string> stored(kColumnCount);
+    for (size_t c = 0; c < kColumnCount; ++c) {
+        std::string packed = lz_compress(cols[c]);
+        bool use_lz = packed.size() < cols[c].size();
+        stored[c] = use_lz ? std::move(packed) : std::move(cols[c]);
+        chunk.push_back(static_cast<char>(use_lz ? kLz : kRaw));
+        put_u32(chunk, static_cast<uint32_t>(use_lz ? cols[c].size() : stored[c].size()));
+        put_u32(chunk, static_cast<uint32_t>(stored[c].size()));
+    }
+    for (const auto& s : stored) chunk.append(s);
+
+    auto chunk_bytes = static_cast<uint32_t>(chunk.size());
+    write(&chunk_bytes, sizeof(chunk_bytes));
+    write(chunk.data(), chunk.size());
+    rows_ += pending_.size();
+    pending_.clear();
+}
+
+// ---------------------------------------------------------------------------
+// Reader
+
+std::string TradeArchiveReader::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return "cannot open " + path + ": " + std::strerror(errno);
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || st.st_size < 8) {
+        ::close(fd);
+        return path + " is not a trade archive";
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    void* map = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // the mapping stays valid
+    if (map == MAP_FAILED) {
+        size_ = 0;
+        return "cannot map " + path + ": " + std::strerror(errno);
+    }
+    map_ = static_cast<const uint8_t*>(map);
+    ::madvise(map, size_, MADV_SEQUENTIAL);
+
+    uint32_t version = 0;
+    std::memcpy(&version, map_ + 4, 4);
+    if (std::memcmp(map_, kMagic, 4) != 0 || version != kVersion) {
+        close();
+        return path + " is not a trade archive (or an unsupported version)";
+    }
+
+    ByteReader r{map_ + 8, map_ + size_};
+    while (r.p != r.end) {
+        uint32_t chunk_bytes = r.u32();
+        if (!r.ok || chunk_bytes < 5 || chunk_bytes > static_cast<size_t>(r.end - r.p)) {
+            close();
+            return path + ": truncated chunk";
+        }
+        ChunkRef ref{};
+        std::memcpy(&ref.rows, r.p, 4);
+        ref.columns = r.p[4];
+        ref.data = r.p + 5;
+        ref.size = chunk_bytes - 5;
+        chunks_.push_back(ref);
+        rows_ += ref.rows;
+        r.p += chunk_bytes;
+    }
+    return {};
+}
+
+void TradeArchiveReader::close() {
+    if (map_) ::munmap(const_cast<uint8_t*>(map_), size_);
+    map_ = nullptr;
+    size_ = 0;
+    chunks_.clear();
+    rows_ = 0;
+}
+
+bool TradeArchiveReader::read_chunk(size_t index, TradeColumns& out) const {
+    if (index >= chunks_.size()) return false;
+    const auto& ref = chunks_[index];
+    if (ref.columns < kColumnCount) return false;
+
+    // Locate each column; decompress only those stored compressed
+    size_t header = static_cast<size_t>(ref.columns) * kColumnHeader;
+    if (header > ref.size) return false;
+    ByteReader head{ref.data, ref.data + header};
+    const uint8_t* payload = ref.data + header;
+    const uint8_t* end = ref.data + ref.size;
+    std::string inflated[kColumnCount];
+    ByteReader cols[kColumnCount] = {};
+    for (size_t c = 0; c < ref.columns; ++c) {
+        uint8_t codec = head.u8();
+        uint32_t raw_size = head.u32();
+        uint32_t stored = head.u32();
+        if (!head.ok || stored > static_cast<size_t>(end - payload)) return false;
+        if (c < kColumnCount) {  // later versions may append columns
+            if (codec == kLz) {
+                if (!lz_decompress(payload, stored, raw_size, inflated[c])) return false;
+                const auto* p = reinterpret_cast<const uint8_t*>(inflated[c].data());
+                cols[c] = ByteReader{p, p + inflated[c].size()};
+            } else if (codec == kRaw) {
+                cols[c] = ByteReader{payload, payload + stored};
+            } else {
+                return false;
+            }
+        }
+        payload += stored;
+    }
+
+    if (!decode_dictionary(cols[kSymbolDict], out.symbols) ||
+        !decode_dictionary(cols[kStrategyDict], out.strategies) ||
+        !decode_dictionary(cols[kAccountDict], out.accounts)) {
+        return false;
+    }
+
+    size_t n = ref.rows;
+    out.time_ms.resize(n);
+    out.price.resize(n);
+    out.quantity.resize(n);
+    out.side.resize(n);
+    out.symbol.resize(n);
+    out.strategy.resize(n);
+    out.account.resize(n);
+    out.commission.resize(n);
+    out.trade_id.resize(n);
+    out.order_id.resize(n);
+    out.cl_ord_id.resize(n);
+    out.timestamp.clear();
+
+    bool text_time = cols[kTime].u8() == kTimeText;
+    if (text_time) out.timestamp.resize(n);
+
+    auto id = [&](ByteReader& r, size_t dict_size, uint32_t& dst) {
+        uint64_t v = r.varint();
+        if (v >= dict_size) r.ok = false;
+        dst = static_cast<uint32_t>(v);
+    };
+
+    int64_t time = 0;
+    int64_t price = 0;
+    std::string trade_id, order_id, cl_ord_id, timestamp;
+    for (size_t i = 0; i < n; ++i) {
+        if (text_time) {
+            cols[kTime].front_coded(timestamp);
+            out.timestamp[i] = timestamp;
+            if (!parse_timestamp(timestamp, out.time_ms[i])) out.time_ms[i] = 0;
+        } else {
+            time += unzigzag(cols[kTime].varint());
+            out.time_ms[i] = time;
+        }
+        price += unzigzag(cols[kPrice].varint());
+        out.price[i] = core::Price::from_raw(price);
+        out.quantity[i] = core::Qty::from_raw(unzigzag(cols[kQuantity].varint()));
+        out.side[i] = cols[kSide].u8() ? orders::Side::Sell : orders::Side::Buy;
+        id(cols[kSymbol], out.symbols.size(), out.symbol[i]);
+        id(cols[kStrategy], out.strategies.size(), out.strategy[i]);
+        id(cols[kAccount], out.accounts.size(), out.account[i]);
+        auto& commission = cols[kCommission];
+        if (commission.end - commission.p < 8) return false;
+        std::memcpy(&out.commission[i], commission.p, 8);
+        commission.p += 8;
+        cols[kTradeId].front_coded(trade_id);
+        cols[kOrderId].front_coded(order_id);
+        cols[kClOrdId].front_coded(cl_ord_id);
+        out.trade_id[i] = trade_id;
+        out.order_id[i] = order_id;
+        out.cl_ord_id[i] = cl_ord_id;
+    }
+    for (const auto& c : cols) {
+        if (!c.ok) return false;
+    }
+    return true;
+}
+
+Trade TradeColumns::row(size_t i) const {
+    Trade t;
+    t.trade_id = trade_id[i];
+    t.order_id = order_id[i];
+    t.cl_ord_id = cl_ord_id[i];
+    t.symbol = symbols[symbol[i]];
+    t.side = side[i];
+    t.quantity = quantity[i];
+    t.price = price[i];
+    t.commission = commission[i];
+    t.timestamp = timestamp.empty() ? format_timestamp(time_ms[i]) : timestamp[i];
+    t.strategy_id = strategies[strategy[i]];
+    t.account = accounts[account[i]];
+    return t;
+}
+
+}  // namespace tradecore::booking
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "booking/trade.hpp"
+
+namespace tradecore::booking {
+
+/// Columnar trade archive for end-of-day export to analytics.
+///
+/// Trades are written in chunks of up to chunk_rows. Within a chunk each
+/// field is its own column:
+/// - timestamps and prices are delta-encoded;
+/// - symbols, strategies and accounts are dictionary-encoded;
+/// - ids are front-coded against the previous row.
+/// Integers are zigzag varints. Each column is then block-compressed (LZ77)
+/// when that makes it smaller.
+/// Chunks are self-contained, so the writer streams and never holds more
+/// than one chunk. Multi-byte fields are little-endian.
+///
+/// File: "TCAR" u32 version, then chunks:
+///   u32 bytes-after-this-field, u32 rows, u8 columns,
+///   per column {u8 codec, u32 raw size, u32 stored size}, column payloads.
+class TradeArchiveWriter {
+public:
+    explicit TradeArchiveWriter(size_t chunk_rows = 65536) : chunk_rows_(chunk_rows) {}
+    ~TradeArchiveWriter() { close(); }
+
+    TradeArchiveWriter(const TradeArchiveWriter&) = delete;
+    TradeArchiveWriter& operator=(const TradeArchiveWriter&) = delete;
+
+    /// Start a new archive at path. Returns empty string on success, else the reason.
+    std::string open(const std::string& path);
+
+    void append(const Trade& trade);
+    template <typename Range>
+    void append_all(const Range& trades) {
+        for (const auto& trade : trades) append(trade);
+    }
+
+    /// Write the pending chunk and close the file. Returns empty string on
+    /// success, else the reason (the first write error seen).
+    std::string close();
+
+    uint64_t rows_written() const { return rows_; }
+    uint64_t bytes_written() const { return bytes_; }
+
+private:
+    void flush_chunk();
+    void write(const void* data, size_t size);
+
+    size_t chunk_rows_;
+    std::FILE* file_ = nullptr;
+    std::string error_;
+    std::vector<Trade> pending_;
+    std::string scratch_;
+    uint64_t rows_ = 0;
+    uint64_t bytes_ = 0;
+};
+
+/// One decoded chunk, column by column.
+struct TradeColumns {
+    std::vector<int64_t> time_ms;       // ms since the Unix epoch (0 if unparseable)
+    std::vector<core::Price> price;
+    std::vector<core::Qty> quantity;
+    std::vector<orders::Side> side;
+    std::vector<uint32_t> symbol;       // into symbols
+    std::vector<uint32_t> strategy;     // into strategies
+    std::vector<uint32_t> account;      // into accounts
+    std::vector<double> commission;
+    std::vector<std::string> trade_id;
+    std::vector<std::string> order_id;
+    std::vector<std::string> cl_ord_id;
+    std::vector<std::string> timestamp; // only when a timestamp did not fit time_ms
+    std::vector<std::string> symbols;
+    std::vector<std::string> strategies;
+    std::vector<std::string> accounts;
+
+    size_t size() const { return price.size(); }
+    /// Row i as a Trade.
+    Trade row(size_t i) const;
+};
+
+/// Reads an archive through a read-only memory map: chunk headers are found
+/// by one pass over the file at open, and each chunk decodes straight from
+/// the mapping without further reads.
+class TradeArchiveReader {
+public:
+    TradeArchiveReader() = default;
+    ~TradeArchiveReader() { close(); }
+
+    TradeArchiveReader(const TradeArchiveReader&) = delete;
+    TradeArchiveReader& operator=(const TradeArchiveReader&) = delete;
+
+    /// Returns empty string on success, else the reason.
+    std::string open(const std::string& path);
+    void close();
+
+    size_t chunk_count() const { return chunks_.size(); }
+    uint64_t row_count() const { return rows_; }
+
+    /// Decode chunk i into out (reusing its capacity). False if corrupt.
+    bool read_chunk(size_t i, TradeColumns& out) const;
+
+    /// Visit every row in file order. False if a chunk is corrupt.
+    template <typename Fn>
+    bool for_each(Fn&& fn) const {
+        TradeColumns cols;
+        for (size_t c = 0; c < chunks_.size(); ++c) {
+            if (!read_chunk(c, cols)) return false;
+            for (size_t i = 0; i < cols.size(); ++i) fn(cols.row(i));
+        }
+        return true;
+    }
+
+private:
+    struct ChunkRef {
+        const uint8_t* data;  // first column header
+        size_t size;          // header bytes + payloads
+        uint32_t rows;
+        uint8_t columns;
+    };
+
+    const uint8_t* map_ = nullptr;
+    size_t size_ = 0;
+    std::vector<ChunkRef> chunks_;
+    uint64_t rows_ = 0;
+};
+
+}  // namespace tradecore::booking
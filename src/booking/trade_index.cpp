@@ -0,0 +1,70 @@
+#include "booking/trade_index.hpp"
+
+#include <algorithm>
+
+namespace tradecore::booking {
+
+void TradeIndex::add(const std::vector<Trade>& log, size_t first) {
+    for (size_t i = first; i < log.size(); ++i) {
+        const auto& trade = log[i];
+        auto pos = static_cast<uint32_t>(i);
+        all_.push_back(pos);
+        by_symbol_[trade.symbol].push_back(pos);
+        by_strategy_[trade.strategy_id].push_back(pos);
+        by_strategy_symbol_[trade.strategy_id][trade.symbol].push_back(pos);
+        by_order_[trade.order_id].push_back(pos);
+    }
+}
+
+TradeRange TradeIndex::all(const std::vector<Trade>& log, const std::string& from,
+                           const std::string& to) const {
+    return window(log, &all_, from, to);
+}
+
+TradeRange TradeIndex::for_symbol(const std::vector<Trade>& log, const std::string& symbol,
+                                  const std::string& from, const std::string& to) const {
+    auto it = by_symbol_.find(symbol);
+    return window(log, it != by_symbol_.end() ? &it->second : nullptr, from, to);
+}
+
+TradeRange TradeIndex::for_strategy(const std::vector<Trade>& log, const std::string& strategy_id,
+                                    const std::string& from, const std::string& to) const {
+    auto it = by_strategy_.find(strategy_id);
+    return window(log, it != by_strategy_.end() ? &it->second : nullptr, from, to);
+}
+
+TradeRange TradeIndex::for_strategy_symbol(const std::vector<Trade>& log,
+                                           const std::string& strategy_id,
+                                           const std::string& symbol, const std::string& from,
+                                           const std::string& to) const {
+    auto it = by_strategy_symbol_.find(strategy_id);
+    if (it == by_strategy_symbol_.end()) return {};
+    auto sym = it->second.find(symbol);
+    return window(log, sym != it->second.end() ? &sym->second : nullptr, from, to);
+}
+
+TradeRange TradeIndex::for_order(const std::vector<Trade>& log,
+                                 const std::string& order_id) const {
+    auto it = by_order_.find(order_id);
+    return window(log, it != by_order_.end() ? &it->second : nullptr, {}, {});
+}
+
+TradeRange TradeIndex::window(const std::vector<Trade>& log, const Postings* postings,
+                              const std::string& from, const std::string& to) {
+    if (!postings || postings->empty()) return {};
+    const uint32_t* first = postings->data();
+    const uint32_t* last = first + postings->size();
+    if (!from.empty()) {
+        first = std::partition_point(first, last, [&](uint32_t pos) {
+            return log[pos].timestamp < from;
+        });
+    }
+    if (!to.empty()) {
+        last = std::partition_point(first, last, [&](uint32_t pos) {
+            return log[pos].timestamp < to;
+        });
+    }
+    return {log.data(), first, last};
+}
+
+}  // namespace tradecore::booking
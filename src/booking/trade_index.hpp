@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "booking/trade.hpp"
+
+namespace tradecore::booking {
+
+/// Some trades of the log, in booking order. Iterating dereferences straight
+/// into the log; nothing is copied. Valid until the next trade is booked.
+class TradeRange {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Trade;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Trade*;
+        using reference = const Trade&;
+
+        iterator() = default;
+        iterator(const Trade* log, const uint32_t* pos) : log_(log), pos_(pos) {}
+
+        reference operator*() const { return log_[*pos_]; }
+        pointer operator->() const { return &log_[*pos_]; }
+        iterator& operator++() { ++pos_; return *this; }
+        iterator operator++(int) { auto it = *this; ++pos_; return it; }
+        bool operator==(const iterator& o) const { return pos_ == o.pos_; }
+        bool operator!=(const iterator& o) const { return pos_ != o.pos_; }
+
+    private:
+        const Trade* log_ = nullptr;
+        const uint32_t* pos_ = nullptr;
+    };
+
+    TradeRange() = default;
+    TradeRange(const Trade* log, const uint32_t* first, const uint32_t* last)
+        : log_(log), first_(first), last_(last) {}
+
+    iterator begin() const { return {log_, first_}; }
+    iterator end() const { return {log_, last_}; }
+    size_t size() const { return static_cast<size_t>(last_ - first_); }
+    bool empty() const { return first_ == last_; }
+    const Trade& operator[](size_t i) const { return log_[first_[i]]; }
+    /// Position of the i-th trade in the full log (BookKeeper::get_trades()).
+    uint32_t position(size_t i) const { return first_[i]; }
+
+private:
+    const Trade* log_ = nullptr;
+    const uint32_t* first_ = nullptr;
+    const uint32_t* last_ = nullptr;
+};
+
+/// Secondary indexes over the trade log by symbol, strategy, strategy and
+/// symbol together, and order, extended as trades are booked. Each index is
+/// a list of log positions in booking order. Timestamps are stamped at booking
+/// in fixed-width UTC form (YYYYMMDD-HH:MM:SS.sss), so within any list they
+/// sort as strings and a time window is two binary searches. That relies on
+/// the log never going back in time: BookKeeper clamps each trade's stamp to
+/// at least its predecessor's, so a wall-clock step backwards cannot reorder it.
+///
+/// Time bounds are half-open [from, to), in the same format; an empty bound
+/// is open-ended.
+class TradeIndex {
+public:
+    /// Index log[first..] (trades just appended to the log).
+    void add(const std::vector<Trade>& log, size_t first);
+
+    TradeRange all(const std::vector<Trade>& log, const std::string& from = {},
+                   const std::string& to = {}) const;
+    TradeRange for_symbol(const std::vector<Trade>& log, const std::string& symbol,
+                          const std::string& from = {}, const std::string& to = {}) const;
+    TradeRange for_strategy(const std::vector<Trade>& log, const std::string& strategy_id,
+                            const std::string& from = {}, const std::string& to = {}) const;
+    TradeRange for_strategy_symbol(const std::vector<Trade>& log, const std::string& strategy_id,
+                                   const std::string& symbol, const std::string& from = {},
+                                   const std::string& to = {}) const;
+    /// Every fill of one order.
+    TradeRange for_order(const std::vector<Trade>& log, const std::string& order_id) const;
+
+private:
+    using Postings = std::vector<uint32_t>;
+
+    static TradeRange window(const std::vector<Trade>& log, const Postings* postings,
+                             const std::string& from, const std::string& to);
+
+    Postings all_;
+    std::unordered_map<std::string, Postings> by_symbol_;
+    std::unordered_map<std::string, Postings> by_strategy_;
+    std::unordered_map<std::string, std::unordered_map<std::string, Postings>> by_strategy_symbol_;
+    std::unordered_map<std::string, Postings> by_order_;
+};
+
+}  // namespace tradecore::booking
@@ -8,16 +8,60 @@
 
 namespace tradecore::core {
 
+namespace {
+
+void parse_limits(const toml::table& tbl, risk::Limits& limits) {
+    if (auto v = tbl["max_order_qty"].value<double>())
+        limits.max_order_qty = *v;
+    if (auto v = tbl["max_order_notional"].value<double>())
+        limits.max_order_notional = *v;
+    if (auto v = tbl["price_collar_bps"].value<double>())
+        limits.price_collar_bps = *v;
+    if (auto v = tbl["max_position"].value<double>())
+        limits.max_position = *v;
+    if (auto v = tbl["max_orders_per_sec"].value<int64_t>())
+        limits.max_orders_per_sec = static_cast<uint32_t>(*v);
+}
+
+// Overrides start from the defaults, so unset keys inherit them
+void parse_limit_overrides(const toml::table* tbl, const risk::Limits& defaults,
+                           std::unordered_map<std::string, risk::Limits>& out) {
+    if (!tbl) return;
+    for (const auto& [name, node] : *tbl) {
+        if (auto entry = node.as_table()) {
+            auto limits = defaults;
+            parse_limits(*entry, limits);
+            out[std::string(name.str())] = limits;
+        }
+    }
+}
+
+}  // namespace
+
 Config Config::defaults() {
     return Config{};
 }
 
 Config Config::load(const std::string& path) {
+    if (!std::filesystem::exists(path)) {
+        spdlog::warn("Config file not found: {}, using defaults", path);
+        return Config{};
+    }
+    std::string error;
+    auto cfg = try_load(path, error);
+    if (!cfg) {
+        spdlog::error("Failed to parse config: {}", error);
+        return Config{};
+    }
+    return *cfg;
+}
+
+std::optional<Config> Config::try_load(const std::string& path, std::string& error) {
     Config cfg;
 
     if (!std::filesystem::exists(path)) {
-        spdlog::warn("Config file not found: {}, using defaults", path);
-        return cfg;
+        error = "file not found: " + path;
+        return std::nullopt;
     }
 
     try {
@@ -29,6 +73,28 @@ Config Config::load(const std::string& path) {
                 cfg.server.bind_address = *v;
             if (auto v = (*server)["poll_timeout_ms"].value<int>())
                 cfg.server.poll_timeout_ms = *v;
+            if (auto v = (*server)["rate_limit_per_sec"].value<double>())
+                cfg.server.rate_limit_per_sec = *v;
+            if (auto v = (*server)["rate_limit_burst"].value<double>())
+                cfg.server.rate_limit_burst = *v;
+            if (auto v = (*server)["max_queue_depth"].value<int>())
+                cfg.server.max_queue_depth = *v;
+            if (auto v = (*server)["session_timeout_ms"].value<int>())
+                cfg.server.session_timeout_ms = *v;
+            if (auto v = (*server)["query_bind_address"].value<std::string>())
+                cfg.server.query_bind_address = *v;
+        }
+
+        // [binary]
+        if (auto binary = tbl["binary"].as_table()) {
+            if (auto v = (*binary)["enabled"].value<bool>())
+                cfg.binary.enabled = *v;
+            if (auto arr = (*binary)["symbols"].as_array()) {
+                for (const auto& el : *arr) {
+                    if (auto v = el.value<std::string>())
+                        cfg.binary.symbols.push_back(*v);
+                }
+            }
         }
 
         // [matching]
@@ -41,6 +107,83 @@ Config Config::load(const std::string& path) {
                 cfg.matching.qty_per_level = *v;
             if (auto v = (*matching)["auto_seed_book"].value<bool>())
                 cfg.matching.auto_seed_book = *v;
+            if (auto v = (*matching)["depth_profile"].value<std::string>())
+                cfg.matching.depth_profile = *v;
+            if (auto v = (*matching)["depth_decay"].value<double>())
+                cfg.matching.depth_decay = *v;
+            if (auto v = (*matching)["tick_aligned"].value<bool>())
+                cfg.matching.tick_aligned = *v;
+            if (auto v = (*matching)["replenish"].value<bool>())
+                cfg.matching.replenish = *v;
+            if (auto v = (*matching)["self_trade_prevention"].value<std::string>())
+                cfg.matching.self_trade_prevention = *v;
+            if (auto v = (*matching)["self_trade_key"].value<std::string>())
+                cfg.matching.self_trade_key = *v;
+        }
+
+        // [fix_gateway]
+        if (auto gw = tbl["fix_gateway"].as_table()) {
+            if (auto v = (*gw)["enabled"].value<bool>())
+                cfg.fix_gateway.enabled = *v;
+            if (auto v = (*gw)["port"].value<int>())
+                cfg.fix_gateway.port = *v;
+            if (auto v = (*gw)["comp_id"].value<std::string>())
+                cfg.fix_gateway.comp_id = *v;
+            if (auto v = (*gw)["heartbeat_interval_s"].value<int>())
+                cfg.fix_gateway.heartbeat_interval_s = *v;
+            if (auto v = (*gw)["cancel_on_disconnect"].value<bool>())
+                cfg.fix_gateway.cancel_on_disconnect = *v;
+        }
+
+        // [market_data]
+        if (auto md = tbl["market_data"].as_table()) {
+            if (auto v = (*md)["enabled"].value<bool>())
+                cfg.market_data.enabled = *v;
+            if (auto v = (*md)["bind_address"].value<std::string>())
+                cfg.market_data.bind_address = *v;
+            if (auto v = (*md)["snapshot_interval_ms"].value<int>())
+                cfg.market_data.snapshot_interval_ms = *v;
+            if (auto v = (*md)["snapshot_depth"].value<int>())
+                cfg.market_data.snapshot_depth = *v;
+            if (auto v = (*md)["conflated_bind_address"].value<std::string>())
+                cfg.market_data.conflated_bind_address = *v;
+            if (auto v = (*md)["conflate_interval_ms"].value<int>())
+                cfg.market_data.conflate_interval_ms = *v;
+        }
+
+        // [risk]
+        if (auto risk = tbl["risk"].as_table()) {
+            if (auto v = (*risk)["enabled"].value<bool>())
+                cfg.risk.enabled = *v;
+            parse_limits(*risk, cfg.risk.limits.defaults);
+            parse_limit_overrides((*risk)["symbols"].as_table(), cfg.risk.limits.defaults,
+                                  cfg.risk.limits.symbols);
+            parse_limit_overrides((*risk)["accounts"].as_table(), cfg.risk.limits.defaults,
+                                  cfg.risk.limits.accounts);
+        }
+
+        // [instruments]
+        if (auto instruments = tbl["instruments"].as_table()) {
+            if (auto v = (*instruments)["reference_file"].value<std::string>())
+                cfg.instruments.reference_file = *v;
+        }
+
+        // [orders]
+        if (auto orders = tbl["orders"].as_table()) {
+            if (auto v = (*orders)["day_end_utc"].value<std::string>())
+                cfg.orders.day_end_utc = *v;
+        }
+
+        // [auction]
+        if (auto auction = tbl["auction"].as_table()) {
+            if (auto arr = (*auction)["symbols"].as_array()) {
+                for (const auto& el : *arr) {
+                    if (auto v = el.value<std::string>())
+                        cfg.auction.symbols.push_back(*v);
+                }
+            }
+            if (auto v = (*auction)["interval_ms"].value<int>())
+                cfg.auction.interval_ms = *v;
         }
 
         // [commission]
@@ -51,6 +194,16 @@ Config Config::load(const std::string& path) {
                 cfg.commission.min = *v;
         }
 
+        // [booking]
+        if (auto booking = tbl["booking"].as_table()) {
+            if (auto v = (*booking)["base_currency"].value<std::string>())
+                cfg.booking.base_currency = *v;
+            if (auto v = (*booking)["position_update_interval_ms"].value<int>())
+                cfg.booking.position_update_interval_ms = *v;
+            if (auto v = (*booking)["archive_path"].value<std::string>())
+                cfg.booking.archive_path = *v;
+        }
+
         // [logging]
         if (auto logging = tbl["logging"].as_table()) {
             if (auto v = (*logging)["level"].value<std::string>())
@@ -67,7 +220,8 @@ Config Config::load(const std::string& path) {
                 cfg.metrics.enabled = *v;
         }
     } catch (const toml::parse_error& e) {
-        spdlog::error("Failed to parse config: {}", e.what());
+        error = e.what();
+        return std::nullopt;
     }
 
     return cfg;
@@ -87,6 +241,9 @@ Config Config::load_with_overrides(const std::string& path, int argc, char* argv
             cfg.commission.rate = std::stod(arg.substr(18));
         } else if (arg.rfind("--spread-bps=", 0) == 0) {
             cfg.matching.spread_bps = std::stod(arg.substr(13));
+        } else if (arg.rfind("--fix-port=", 0) == 0) {
+            cfg.fix_gateway.enabled = true;
+            cfg.fix_gateway.port = std::stoi(arg.substr(11));
         } else if (arg.rfind("--config=", 0) == 0) {
             // already handled via path
         }
@@ -1,12 +1,29 @@
 #pragma once
 
+#include <optional>
 #include <string>
+#include <vector>
+
+#include "risk/risk_limits.hpp"
 
 namespace tradecore::core {
 
 struct ServerConfig {
     std::string bind_address = "tcp://*:5555";
     int poll_timeout_ms = 100;
+    double rate_limit_per_sec = 0.0;  // per client identity; 0 = unlimited
+    double rate_limit_burst = 100.0;
+    int max_queue_depth = 1024;       // queued messages per client before rejecting
+    int session_timeout_ms = 0;       // cancel-on-disconnect after silence; 0 = off
+    std::string query_bind_address;   // snapshot queries on their own thread; empty = off
+};
+
+struct FixGatewayConfig {
+    bool enabled = false;
+    int port = 9878;
+    std::string comp_id = "TRADECORE";
+    int heartbeat_interval_s = 30;
+    bool cancel_on_disconnect = true;
 };
 
 struct MatchingConfig {
@@ -14,6 +31,44 @@ struct MatchingConfig {
     int depth_levels = 5;
     double qty_per_level = 1000.0;
     bool auto_seed_book = true;
+    std::string depth_profile = "flat";
+    double depth_decay = 0.7;
+    bool tick_aligned = false;
+    bool replenish = false;
+    std::string self_trade_prevention = "none";  // none, cancel_resting, cancel_aggressor, decrement
+    std::string self_trade_key = "strategy";     // strategy or account
+};
+
+struct InstrumentsConfig {
+    std::string reference_file;  // instrument master CSV, only its symbols trade; empty = learn
+};
+
+struct OrdersConfig {
+    std::string day_end_utc;  // "HH:MM" when Day orders expire; empty = never
+};
+
+struct AuctionConfig {
+    std::vector<std::string> symbols;  // traded in periodic call auctions instead of continuously
+    int interval_ms = 1000;            // length of each call period
+};
+
+struct BinaryWireConfig {
+    bool enabled = false;
+    std::vector<std::string> symbols;  // symbol IDs are 1-based positions in this list
+};
+
+struct MarketDataConfig {
+    bool enabled = false;
+    std::string bind_address = "tcp://*:5556";
+    int snapshot_interval_ms = 1000;
+    int snapshot_depth = 10;
+    std::string conflated_bind_address;  // empty = conflated feed disabled
+    int conflate_interval_ms = 250;
+};
+
+struct RiskConfig {
+    bool enabled = false;
+    risk::LimitSet limits;  // [risk] keys are the defaults; [risk.symbols.X] / [risk.accounts.X] override
 };
 
 struct CommissionConfig {
@@ -21,6 +76,12 @@ struct CommissionConfig {
     double min = 0.0;
 };
 
+struct BookingConfig {
+    std::string base_currency = "USD";  // PnL, exposure and risk limits are in this currency
+    int position_update_interval_ms = 1000;  // coalescing window for position subscriptions
+    std::string archive_path;  // columnar trade export at shutdown; empty = off
+};
+
 struct LoggingConfig {
     std::string level = "info";
     std::string file = "logs/tradecore.log";
@@ -33,12 +94,24 @@ struct MetricsConfig {
 
 struct Config {
     ServerConfig server;
+    BinaryWireConfig binary;
+    FixGatewayConfig fix_gateway;
     MatchingConfig matching;
+    InstrumentsConfig instruments;
+    OrdersConfig orders;
+    AuctionConfig auction;
+    MarketDataConfig market_data;
+    RiskConfig risk;
     CommissionConfig commission;
+    BookingConfig booking;
     LoggingConfig logging;
     MetricsConfig metrics;
 
+    /// Defaults if the file is missing or does not parse (logged).
     static Config load(const std::string& path);
+    /// nullopt with the reason in error if the file is missing or does not
+    /// parse; for reloads, where falling back to defaults would clear limits.
+    static std::optional<Config> try_load(const std::string& path, std::string& error);
     static Config load_with_overrides(const std::string& path, int argc, char* argv[]);
     static Config defaults();
 };
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cmath>
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+
+namespace tradecore::core {
+
+/// Decimal fixed-point value: a signed count of 10^-8 units. Every tick and
+/// lot size in use is a whole number of units, so book prices and quantities
+/// add, subtract and compare exactly and a fully consumed order is exactly
+/// zero. Each Tag is a distinct type: prices and quantities do not mix.
+/// Doubles appear only at the edges (protocol messages, config, reports).
+template <typename Tag>
+class Fixed {
+public:
+    static constexpr int64_t kScale = 100'000'000;
+
+    constexpr Fixed() = default;
+
+    /// Largest magnitude a double may have to convert: 1e17 raw, so that level
+    /// depth, positions and auction totals summing many such values still fit
+    /// in int64 (which tops out near 9.2e18 raw, i.e. 9.2e10).
+    static constexpr double kMaxDouble = 1.0e9;
+
+    /// Nearest representable value. value must satisfy fits().
+    explicit Fixed(double value) : raw_(std::llround(value * kScale)) {}
+
+    /// Whether value converts: finite and within ±kMaxDouble. Check doubles
+    /// from outside (protocol fields) before constructing from them.
+    static bool fits(double value) {
+        return std::isfinite(value) && std::fabs(value) <= kMaxDouble;
+    }
+
+    static constexpr Fixed from_raw(int64_t raw) {
+        Fixed f;
+        f.raw_ = raw;
+        return f;
+    }
+    static constexpr Fixed max() { return from_raw(std::numeric_limits<int64_t>::max()); }
+
+    constexpr int64_t raw() const { return raw_; }
+    double to_double() const { return static_cast<double>(raw_) / kScale; }
+
+    constexpr bool is_zero() const { return raw_ == 0; }
+    constexpr bool positive() const { return raw_ > 0; }
+
+    constexpr auto operator<=>(const Fixed&) const = default;
+
+    constexpr Fixed operator+(Fixed o) const { return from_raw(raw_ + o.raw_); }
+    constexpr Fixed operator-(Fixed o) const { return from_raw(raw_ - o.raw_); }
+    constexpr Fixed operator-() const { return from_raw(-raw_); }
+    constexpr Fixed& operator+=(Fixed o) { raw_ += o.raw_; return *this; }
+    constexpr Fixed& operator-=(Fixed o) { raw_ -= o.raw_; return *this; }
+
+    /// Scale by an integer (also a bool, for branch-free masking).
+    constexpr Fixed operator*(int64_t n) const { return from_raw(raw_ * n); }
+
+    /// Nearest multiple of step (a tick or lot size), halves away from zero.
+    constexpr Fixed round_to(Fixed step) const {
+        if (step.raw_ <= 0) return *this;
+        int64_t half = step.raw_ / 2;
+        int64_t n = (raw_ >= 0 ? raw_ + half : raw_ - half) / step.raw_;
+        return from_raw(n * step.raw_);
+    }
+
+private:
+    int64_t raw_ = 0;
+};
+
+template <typename Tag>
+constexpr Fixed<Tag> abs(Fixed<Tag> v) {
+    return v.raw() < 0 ? -v : v;
+}
+
+template <typename Tag>
+std::ostream& operator<<(std::ostream& os, Fixed<Tag> v) {
+    return os << v.to_double();
+}
+
+struct PriceTag {};
+struct QtyTag {};
+
+using Price = Fixed<PriceTag>;
+using Qty = Fixed<QtyTag>;
+
+/// price * qty as a currency amount.
+inline double notional(Price price, Qty qty) {
+    return price.to_double() * qty.to_double();
+}
+
+/// price * qty in whole cents, exact (128-bit intermediate), rounded half up.
+inline int64_t notional_cents(Price price, Qty qty) {
+    constexpr __int128 kPerCent = static_cast<__int128>(Price::kScale) * Qty::kScale / 100;
+    __int128 product = static_cast<__int128>(price.raw()) * qty.raw();
+    return static_cast<int64_t>((product + kPerCent / 2) / kPerCent);
+}
+
+}  // namespace tradecore::core
@@ -8,6 +8,8 @@
 #include <string>
 #include <vector>
 
+#include "core/fixed_point.hpp"
+
 namespace tradecore::core {
 
 class Metrics {
@@ -25,6 +27,7 @@ public:
     std::atomic<uint64_t> partial_fills{0};
     std::atomic<uint64_t> messages_in{0};
     std::atomic<uint64_t> messages_out{0};
+    std::atomic<uint64_t> messages_throttled{0};
     std::atomic<uint64_t> total_notional_x100{0};  // store as integer cents for atomicity
 
     void add_notional(double notional) {
@@ -32,6 +35,12 @@ public:
             static_cast<uint64_t>(notional * 100.0), std::memory_order_relaxed);
     }
 
+    /// Exact: the cents come straight from the fixed-point product.
+    void add_notional(Price price, Qty qty) {
+        total_notional_x100.fetch_add(
+            static_cast<uint64_t>(notional_cents(price, qty)), std::memory_order_relaxed);
+    }
+
     double get_notional() const {
         return static_cast<double>(total_notional_x100.load(std::memory_order_relaxed)) / 100.0;
     }
@@ -82,6 +91,7 @@ public:
            << " partial_fills=" << partial_fills.load()
            << " messages_in=" << messages_in.load()
            << " messages_out=" << messages_out.load()
+           << " messages_throttled=" << messages_throttled.load()
            << " total_notional=$" << get_notional()
            << " latency_avg=" << lat.avg_us << "us"
            << " latency_p99=" << lat.p99_us << "us"
@@ -98,6 +108,7 @@ public:
         partial_fills = 0;
         messages_in = 0;
         messages_out = 0;
+        messages_throttled = 0;
         total_notional_x100 = 0;
         std::lock_guard<std::mutex> lock(latency_mutex_);
         latency_idx_ = 0;
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+namespace tradecore::core {
+
+/// Latest value of T per key, written by one thread and read by any number
+/// of others without locks.
+///
+/// Each slot is a seqlock: the writer bumps the sequence to odd, overwrites
+/// the value and bumps it back to even. A reader copies the value and retries
+/// if the sequence moved, so it always gets one whole published value, never
+/// a mix, and never delays the writer. The value is copied as relaxed atomic
+/// words, so readers and the writer never race in the memory-model sense.
+///
+/// Keys are added by the writer and never removed. Readers find them through
+/// an open-addressed index whose entries are published with release stores,
+/// so a key is either fully visible or absent. Capacity is fixed up front.
+template <typename T>
+class SnapshotTable {
+    static_assert(std::is_trivially_copyable_v<T>, "snapshots are copied as raw words");
+
+public:
+    static constexpr uint32_t kFull = std::numeric_limits<uint32_t>::max();
+
+    explicit SnapshotTable(size_t capacity = 4096)
+        : capacity_(capacity), slots_(std::make_unique<Slot[]>(capacity)) {
+        size_t buckets = 1;
+        while (buckets < capacity * 2) buckets <<= 1;
+        mask_ = buckets - 1;
+        buckets_ = std::make_unique<std::atomic<uint32_t>[]>(buckets);
+        for (size_t i = 0; i < buckets; ++i) buckets_[i].store(0, std::memory_order_relaxed);
+        index_.reserve(capacity);
+    }
+
+    SnapshotTable(const SnapshotTable&) = delete;
+    SnapshotTable& operator=(const SnapshotTable&) = delete;
+
+    /// Writer: the slot for key, adding it on first use. kFull when the table
+    /// is full. Slots are stable, so writers can cache them.
+    uint32_t slot(const std::string& key) {
+        auto it = index_.find(key);
+        if (it != index_.end()) return it->second;
+        size_t n = size_.load(std::memory_order_relaxed);
+        if (n == capacity_) return kFull;
+
+        auto id = static_cast<uint32_t>(n);
+        slots_[id].key = key;
+        index_.emplace(key, id);
+        size_.store(n + 1, std::memory_order_release);
+        size_t b = std::hash<std::string>{}(key) & mask_;
+        while (buckets_[b].load(std::memory_order_relaxed) != 0) b = (b + 1) & mask_;
+        buckets_[b].store(id + 1, std::memory_order_release);
+        return id;
+    }
+
+    /// Writer: publish a new value.
+    void store(uint32_t slot, const T& value) {
+        auto& s = slots_[slot];
+        uint64_t words[kWords] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        uint64_t seq = s.seq.load(std::memory_order_relaxed);
+        s.seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i) {
+            s.words[i].store(words[i], std::memory_order_relaxed);
+        }
+        s.seq.store(seq + 2, std::memory_order_release);
+    }
+
+    /// Writer: publish a new value for key. False if the table is full.
+    bool store(const std::string& key, const T& value) {
+        uint32_t id = slot(key);
+        if (id == kFull) return false;
+        store(id, value);
+        return true;
+    }
+
+    /// Any thread: the latest value for key. False if the key was never stored.
+    bool load(const std::string& key, T& out) const {
+        size_t b = std::hash<std::string>{}(key) & mask_;
+        for (;; b = (b + 1) & mask_) {
+            uint32_t entry = buckets_[b].load(std::memory_order_acquire);
+            if (entry == 0) return false;
+            if (slots_[entry - 1].key == key) return read(slots_[entry - 1], out);
+        }
+    }
+
+    /// Any thread: fn(key, value) for every key stored so far.
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        size_t n = size_.load(std::memory_order_acquire);
+        T value;
+        for (size_t i = 0; i < n; ++i) {
+            if (read(slots_[i], value)) fn(static_cast<const std::string&>(slots_[i].key),
+                                           static_cast<const T&>(value));
+        }
+    }
+
+    size_t size() const { return size_.load(std::memory_order_acquire); }
+    size_t capacity() const { return capacity_; }
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + 7) / 8;
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> seq{0};  // odd while a write is in progress; 0 = never written
+        std::atomic<uint64_t> words[kWords];
+        std::string key;  // written once before the slot is published
+    };
+
+    /// Spins only while the writer is mid-store, which is a few dozen stores.
+    bool read(const Slot& s, T& out) const {
+        uint64_t words[kWords];
+        for (;;) {
+            uint64_t before = s.seq.load(std::memory_order_acquire);
+            if (before == 0) return false;
+            if (before & 1) continue;
+            for (size_t i = 0; i < kWords; ++i) {
+                words[i] = s.words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s.seq.load(std::memory_order_relaxed) == before) break;
+        }
+        std::memcpy(&out, words, sizeof(T));
+        return true;
+    }
+
+    size_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<size_t> size_{0};
+    size_t mask_ = 0;
+    std::unique_ptr<std::atomic<uint32_t>[]> buckets_;  // slot + 1, 0 = empty
+    std::unordered_map<std::string, uint32_t> index_;   // writer-only
+};
+
+}  // namespace tradecore::core
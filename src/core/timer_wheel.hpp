@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tradecore::core {
+
+/// Hashed timing wheel for many timers that are mostly pushed back before they
+/// fire (liveness, expiry). Deadlines are rounded up to `tick`; a timer fires
+/// on the first advance() at or after its deadline, at most one tick late.
+///
+/// Re-arming a timer to a later deadline only updates its recorded deadline;
+/// the wheel entry is moved lazily when its slot comes round. Scheduling is
+/// therefore one hash update. Not thread-safe; owned by the thread that polls.
+template <typename Key, typename Hash = std::hash<Key>>
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    TimerWheel(Clock::duration tick, size_t slots, Clock::time_point now = Clock::now())
+        : tick_(std::max(tick, Clock::duration(1))), origin_(now),
+          slots_(std::max<size_t>(slots, 1)) {}
+
+    /// Arm the timer for key, or move an armed one to the new deadline.
+    void schedule(const Key& key, Clock::time_point deadline) {
+        uint64_t tick = std::max(tick_ceil(deadline), current_ + 1);
+        auto [it, inserted] = timers_.try_emplace(key, Timer{tick, tick});
+        if (inserted) {
+            enqueue(key, tick);
+            return;
+        }
+        it->second.deadline = tick;
+        // Later deadlines are picked up when the queued slot fires
+        if (tick < it->second.queued) {
+            it->second.queued = tick;
+            enqueue(key, tick);
+        }
+    }
+
+    /// Disarm a timer. Returns false if it was not armed.
+    bool cancel(const Key& key) { return timers_.erase(key) > 0; }
+
+    bool contains(const Key& key) const { return timers_.count(key) > 0; }
+    size_t size() const { return timers_.size(); }
+
+    /// Fire on_expire(key) for every timer due at or before now; a fired
+    /// timer is disarmed before its callback runs.
+    template <typename F>
+    void advance(Clock::time_point now, F&& on_expire) {
+        uint64_t target = tick_floor(now);
+        if (target <= current_) return;
+
+        // After a long stall one pass over every slot covers all due timers
+        uint64_t steps = std::min<uint64_t>(target - current_, slots_.size());
+        bool stalled = target - current_ > slots_.size();
+        for (uint64_t i = 1; i <= steps; ++i) {
+            uint64_t tick = stalled ? target : current_ + i;
+            fire_slot((current_ + i) % slots_.size(), tick, on_expire);
+        }
+        current_ = target;
+    }
+
+private:
+    struct Timer {
+        uint64_t deadline;  // tick the timer is due
+        uint64_t queued;    // tick of its live wheel entry (older entries are stale)
+    };
+    struct Entry {
+        Key key;
+        uint64_t tick;
+    };
+
+    uint64_t tick_floor(Clock::time_point t) const {
+        return t <= origin_ ? 0 : static_cast<uint64_t>((t - origin_) / tick_);
+    }
+    uint64_t tick_ceil(Clock::time_point t) const {
+        if (t <= origin_) return 0;
+        auto elapsed = t - origin_;
+        return static_cast<uint64_t>((elapsed + tick_ - Clock::duration(1)) / tick_);
+    }
+
+    void enqueue(const Key& key, uint64_t tick) {
+        slots_[tick % slots_.size()].push_back(Entry{key, tick});
+    }
+
+    template <typename F>
+    void fire_slot(size_t index, uint64_t now_tick, F& on_expire) {
+        auto& slot = slots_[index];
+        if (slot.empty()) return;
+
+        // Swap buffers so firing never allocates once both have grown
+        scratch_.swap(slot);
+        for (auto& entry : scratch_) {
+            if (entry.tick > now_tick) {  // a later lap round the wheel
+                slot.push_back(std::move(entry));
+                continue;
+            }
+            auto it = timers_.find(entry.key);
+            if (it == timers_.end() || it->second.queued != entry.tick) continue;  // stale
+
+            if (it->second.deadline <= now_tick) {
+                timers_.erase(it);
+                on_expire(entry.key);
+            } else {
+                it->second.queued = it->second.deadline;
+                enqueue(entry.key, it->second.deadline);
+            }
+        }
+        scratch_.clear();
+    }
+
+    Clock::duration tick_;
+    Clock::time_point origin_;
+    uint64_t current_ = 0;
+    std::vector<std::vector<Entry>> slots_;
+    std::vector<Entry> scratch_;
+    std::unordered_map<Key, Timer, Hash> timers_;
+};
+
+}  // namespace tradecore::core
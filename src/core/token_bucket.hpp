@@ -0,0 +1,37 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+
+namespace tradecore::core {
+
+/// Classic token bucket: refills at `rate` tokens per second up to `burst`.
+/// Starts full. Not thread-safe; owned by the thread that polls.
+class TokenBucket {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    TokenBucket() = default;
+    TokenBucket(double rate, double burst, Clock::time_point now = Clock::now())
+        : rate_(rate), burst_(burst), tokens_(burst), last_(now) {}
+
+    /// Take one token if available.
+    bool try_take(Clock::time_point now) {
+        double elapsed = std::chrono::duration<double>(now - last_).count();
+        last_ = now;
+        tokens_ = std::min(burst_, tokens_ + elapsed * rate_);
+        if (tokens_ < 1.0) return false;
+        tokens_ -= 1.0;
+        return true;
+    }
+
+    double tokens() const { return tokens_; }
+
+private:
+    double rate_ = 0.0;
+    double burst_ = 0.0;
+    double tokens_ = 0.0;
+    Clock::time_point last_{};
+};
+
+}  // namespace tradecore::core
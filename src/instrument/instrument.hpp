@@ -1,11 +1,15 @@
 #pragma once
 
 #include <fix_messages.pb.h>
+#include <cstdint>
 #include <optional>
 #include <string>
 
 namespace tradecore::instrument {
 
+/// Dense ID assigned by InstrumentRegistry, from 1; 0 = not registered.
+using InstrumentId = uint32_t;
+
 enum class AssetClass { Equity, Future, Option, FX };
 
 inline AssetClass asset_class_from_security_type(fix::SecurityType st) {
@@ -38,6 +42,7 @@ inline std::string asset_class_to_string(AssetClass ac) {
 }
 
 struct Instrument {
+    InstrumentId id = 0;
     std::string symbol;
     AssetClass asset_class = AssetClass::Equity;
     std::string exchange;
@@ -94,4 +99,7 @@ struct Instrument {
     }
 };
 
+/// What an unresolved Order points at.
+inline const Instrument kUnknownInstrument{};
+
 }  // namespace tradecore::instrument
@@ -0,0 +1,141 @@
+#include "instrument/instrument_registry.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+namespace tradecore::instrument {
+
+namespace {
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+bool parse_asset_class(std::string_view s, AssetClass& out) {
+    if (s == "equity") out = AssetClass::Equity;
+    else if (s == "future") out = AssetClass::Future;
+    else if (s == "option") out = AssetClass::Option;
+    else if (s == "fx") out = AssetClass::FX;
+    else return false;
+    return true;
+}
+
+bool parse_positive(std::string_view s, double& out) {
+    auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), out);
+    return ec == std::errc() && end == s.data() + s.size() && out > 0;
+}
+
+/// Fill inst from one line's fields. Returns the reason if the line is bad.
+std::string parse_row(const std::vector<std::string_view>& f, Instrument& inst) {
+    if (f.size() < 6) return "expected at least 6 fields, got " + std::to_string(f.size());
+    if (f[0].empty()) return "missing symbol";
+    inst.symbol = f[0];
+    if (!parse_asset_class(f[1], inst.asset_class)) {
+        return "unknown asset class '" + std::string(f[1]) + "'";
+    }
+    inst.exchange = f[2];
+    if (!f[3].empty()) inst.currency = f[3];
+    if (!f[4].empty() && !parse_positive(f[4], inst.tick_size)) {
+        return "bad tick size '" + std::string(f[4]) + "'";
+    }
+    if (!f[5].empty() && !parse_positive(f[5], inst.contract_size)) {
+        return "bad multiplier '" + std::string(f[5]) + "'";
+    }
+    if (f.size() > 6 && !f[6].empty()) inst.expiry = std::string(f[6]);
+    if (f.size() > 7 && !f[7].empty()) inst.underlying = std::string(f[7]);
+    if (f.size() > 8 && !f[8].empty()) {
+        double strike = 0.0;
+        if (!parse_positive(f[8], strike)) return "bad strike '" + std::string(f[8]) + "'";
+        inst.strike = strike;
+    }
+    if (f.size() > 9 && !f[9].empty()) inst.option_type = std::string(f[9]);
+    if (inst.asset_class == AssetClass::FX) inst.pip_size = inst.tick_size;
+    return {};
+}
+
+}  // namespace
+
+std::string InstrumentRegistry::load(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return path + ": " + std::strerror(errno);
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return path + ": " + std::strerror(errno);
+    }
+    auto size = static_cast<size_t>(st.st_size);
+    if (size == 0) {
+        ::close(fd);
+        return {};
+    }
+    void* map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    ::close(fd);  // the mapping stays valid
+    if (map == MAP_FAILED) return path + ": " + std::strerror(errno);
+
+    // Parse straight from the mapping; only the kept fields are copied
+    std::string_view text(static_cast<const char*>(map), size);
+    std::vector<std::string_view> fields;
+    std::string error;
+    size_t line_no = 0;
+    while (!text.empty() && error.empty()) {
+        size_t eol = text.find('\n');
+        std::string_view line = text.substr(0, eol);
+        text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+        ++line_no;
+
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+        fields.clear();
+        for (;;) {
+            size_t comma = line.find(',');
+            fields.push_back(trim(line.substr(0, comma)));
+            if (comma == std::string_view::npos) break;
+            line.remove_prefix(comma + 1);
+        }
+
+        Instrument inst;
+        error = parse_row(fields, inst);
+        if (error.empty()) add(std::move(inst));
+    }
+    ::munmap(map, size);
+    if (!error.empty()) return path + ":" + std::to_string(line_no) + ": " + error;
+    return {};
+}
+
+const Instrument& InstrumentRegistry::intern(const std::string& symbol) {
+    auto it = ids_.find(symbol);
+    if (it != ids_.end()) return rows_[it->second - 1];
+    Instrument inst;
+    inst.symbol = symbol;
+    return add(std::move(inst));
+}
+
+const Instrument& InstrumentRegistry::add(Instrument inst) {
+    if (inst.symbol.empty()) return kUnknownInstrument;
+    auto next = static_cast<InstrumentId>(rows_.size() + 1);
+    auto [it, inserted] = ids_.try_emplace(inst.symbol, next);
+    inst.id = it->second;
+    if (inserted) return rows_.emplace_back(std::move(inst));
+    auto& row = rows_[inst.id - 1];
+    row = std::move(inst);
+    return row;
+}
+
+const Instrument* InstrumentRegistry::find(const std::string& symbol) const {
+    auto it = ids_.find(symbol);
+    return (it != ids_.end()) ? &rows_[it->second - 1] : nullptr;
+}
+
+}  // namespace tradecore::instrument
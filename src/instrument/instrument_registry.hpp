@@ -0,0 +1,55 @@
+#pragma once
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+#include "instrument/instrument.hpp"
+
+namespace tradecore::instrument {
+
+/// Instrument master: one row per symbol with a dense ID (from 1), loaded at
+/// startup from a reference file. Orders point at their row instead of
+/// carrying a copy, so resolving a NewOrderSingle's instrument is one hash
+/// lookup on the symbol with nothing copied.
+///
+/// Rows are never moved or removed, so references stay valid for the life of
+/// the registry. Lookups never register anything; callers add a symbol
+/// explicitly (OrderManager does so only for an order that passed its checks).
+///
+/// Reference file: CSV, one instrument per line, '#' starts a comment:
+///   symbol,asset_class,exchange,currency,tick_size,multiplier
+/// optionally followed by expiry, then underlying,strike,put_or_call for
+/// options. asset_class is equity, future, option or fx. Empty fields keep
+/// the defaults.
+class InstrumentRegistry {
+public:
+    /// Memory-map the file at path and add (or update) its instruments.
+    /// Returns empty string on success, else "path:line: reason". Rows before
+    /// a bad line are kept.
+    std::string load(const std::string& path);
+
+    /// The row for symbol, registering a default equity if new.
+    const Instrument& intern(const std::string& symbol);
+
+    /// Add inst, or replace the data of the row with its symbol (keeping its
+    /// ID and address). Returns the row; kUnknownInstrument, unregistered,
+    /// for an empty symbol.
+    const Instrument& add(Instrument inst);
+
+    /// nullptr if the symbol is not registered.
+    const Instrument* find(const std::string& symbol) const;
+
+    /// Row for an ID. kUnknownInstrument for unknown IDs.
+    const Instrument& get(InstrumentId id) const {
+        return (id >= 1 && id <= rows_.size()) ? rows_[id - 1] : kUnknownInstrument;
+    }
+
+    size_t size() const { return rows_.size(); }
+
+private:
+    std::deque<Instrument> rows_;  // row = ID - 1
+    std::unordered_map<std::string, InstrumentId> ids_;
+};
+
+}  // namespace tradecore::instrument
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tradecore::instrument {
+
+/// Dense symbol <-> integer ID mapping used by compact wire formats.
+/// IDs start at 1; 0 means "unknown symbol".
+class SymbolTable {
+public:
+    /// Return the symbol's ID, assigning the next one on first sight.
+    uint32_t intern(const std::string& symbol) {
+        auto [it, inserted] = ids_.try_emplace(symbol, static_cast<uint32_t>(names_.size() + 1));
+        if (inserted) names_.push_back(symbol);
+        return it->second;
+    }
+
+    /// Look up a symbol's ID. Returns 0 if the symbol was never interned.
+    uint32_t find(const std::string& symbol) const {
+        auto it = ids_.find(symbol);
+        return (it != ids_.end()) ? it->second : 0;
+    }
+
+    /// Symbol for an ID. Returns an empty string for unknown IDs.
+    const std::string& name(uint32_t id) const {
+        static const std::string kUnknown;
+        return (id >= 1 && id <= names_.size()) ? names_[id - 1] : kUnknown;
+    }
+
+    size_t size() const { return names_.size(); }
+
+private:
+    std::unordered_map<std::string, uint32_t> ids_;
+    std::vector<std::string> names_;
+};
+
+}  // namespace tradecore::instrument
@@ -1,22 +1,56 @@
+#include <algorithm>
+#include <chrono>
 #include <csignal>
+#include <cstdio>
+#include <memory>
+#include <optional>
 #include <string>
 
 #include <spdlog/spdlog.h>
 
 #include "booking/book_keeper.hpp"
+#include "booking/mark_to_market.hpp"
+#include "booking/trade_archive.hpp"
 #include "core/config.hpp"
 #include "core/logging.hpp"
 #include "core/metrics.hpp"
+#include "instrument/instrument_registry.hpp"
+#include "instrument/symbol_table.hpp"
 #include "matching/matching_engine.hpp"
+#include "messaging/fix_gateway.hpp"
+#include "messaging/md_publisher.hpp"
+#include "messaging/position_publisher.hpp"
+#include "messaging/query_server.hpp"
 #include "messaging/zmq_server.hpp"
 #include "orders/order_manager.hpp"
+#include "risk/risk_engine.hpp"
 
 static tradecore::messaging::ZmqServer* g_server = nullptr;
+static volatile std::sig_atomic_t g_reload_risk = 0;
 
 void signal_handler(int) {
     if (g_server) g_server->stop();
 }
 
+void reload_handler(int) {
+    g_reload_risk = 1;
+}
+
+// Next occurrence of "HH:MM" UTC after now; nullopt if unset or malformed.
+std::optional<std::chrono::system_clock::time_point> next_day_end(
+    const std::string& hhmm, std::chrono::system_clock::time_point now) {
+    int hh = 0, mm = 0;
+    if (std::sscanf(hhmm.c_str(), "%d:%d", &hh, &mm) != 2 ||
+        hh < 0 || hh > 23 || mm < 0 || mm > 59) {
+        return std::nullopt;
+    }
+    constexpr std::chrono::hours kDay{24};
+    auto since_epoch = now.time_since_epoch();
+    auto midnight = now - (since_epoch % kDay);
+    auto end = midnight + std::chrono::hours(hh) + std::chrono::minutes(mm);
+    return (end > now) ? end : end + kDay;
+}
+
 int main(int argc, char* argv[]) {
     GOOGLE_PROTOBUF_VERIFY_VERSION;
 
@@ -33,16 +67,88 @@ int main(int argc, char* argv[]) {
 
     tradecore::core::init_logging(cfg.logging.level, cfg.logging.file);
 
-    tradecore::matching::MatchingEngine matcher;
-    tradecore::booking::BookKeeper book_keeper;
+    tradecore::matching::LiquidityModel liquidity;
+    liquidity.spread_bps = cfg.matching.spread_bps;
+    liquidity.depth_levels = cfg.matching.depth_levels;
+    liquidity.qty_per_level = cfg.matching.qty_per_level;
+    liquidity.profile = tradecore::matching::depth_profile_from_string(cfg.matching.depth_profile);
+    liquidity.decay = cfg.matching.depth_decay;
+    liquidity.tick_aligned = cfg.matching.tick_aligned;
+    liquidity.replenish = cfg.matching.replenish;
+    liquidity.auto_seed = cfg.matching.auto_seed_book;
+
+    tradecore::matching::MatchingEngine matcher(liquidity);
+    matcher.set_self_trade_prevention(
+        tradecore::matching::self_trade_prevention_from_string(cfg.matching.self_trade_prevention));
+    tradecore::booking::BookKeeper book_keeper(cfg.booking.base_currency);
+    tradecore::booking::MarkToMarket valuation;
+    book_keeper.set_valuation(&valuation);
+    matcher.set_mark_listener([&](const std::string& symbol, double mark) {
+        valuation.on_mark(symbol, mark);
+    });
+    tradecore::instrument::InstrumentRegistry instruments;
+    if (!cfg.instruments.reference_file.empty()) {
+        auto error = instruments.load(cfg.instruments.reference_file);
+        if (!error.empty()) {
+            spdlog::error("instrument master: {}", error);
+            return 1;
+        }
+        spdlog::info("instrument master: {} instruments from {}", instruments.size(),
+                     cfg.instruments.reference_file);
+    }
     tradecore::orders::OrderManager order_mgr(matcher, book_keeper, cfg.commission.rate);
+    // With a master configured, it is the whole universe: unlisted symbols are rejected
+    order_mgr.set_instruments(&instruments, !cfg.instruments.reference_file.empty());
+    order_mgr.set_self_trade_key(
+        tradecore::orders::self_trade_key_from_string(cfg.matching.self_trade_key));
+
+    std::unique_ptr<tradecore::risk::RiskEngine> risk;
+    if (cfg.risk.enabled) {
+        risk = std::make_unique<tradecore::risk::RiskEngine>(book_keeper, cfg.risk.limits);
+        order_mgr.set_risk_engine(risk.get());
+    }
+
+    tradecore::messaging::PositionPublisher positions(
+        book_keeper, valuation, std::chrono::milliseconds(cfg.booking.position_update_interval_ms));
+
+    // Depth and position queries read snapshots published by this thread,
+    // from a thread of their own
+    std::unique_ptr<tradecore::matching::BookSnapshots> book_snapshots;
+    std::unique_ptr<tradecore::booking::PositionSnapshots> position_snapshots;
+    std::unique_ptr<tradecore::messaging::QueryServer> query_server;
+    if (!cfg.server.query_bind_address.empty()) {
+        book_snapshots = std::make_unique<tradecore::matching::BookSnapshots>();
+        position_snapshots = std::make_unique<tradecore::booking::PositionSnapshots>();
+        matcher.set_snapshots(book_snapshots.get());
+        book_keeper.set_snapshots(position_snapshots.get());
+        query_server = std::make_unique<tradecore::messaging::QueryServer>(
+            cfg.server.query_bind_address, *book_snapshots, *position_snapshots);
+        query_server->start();
+        spdlog::info("snapshot queries on {}", cfg.server.query_bind_address);
+    }
 
     auto& metrics = tradecore::core::Metrics::instance();
 
     tradecore::messaging::ZmqServer server(cfg.server.bind_address);
     g_server = &server;
+    server.set_max_queue_depth(static_cast<size_t>(cfg.server.max_queue_depth));
+    if (cfg.server.rate_limit_per_sec > 0.0) {
+        server.set_rate_limit(cfg.server.rate_limit_per_sec, cfg.server.rate_limit_burst);
+        spdlog::info("per-client rate limit {}/s (burst {})",
+                     cfg.server.rate_limit_per_sec, cfg.server.rate_limit_burst);
+    }
+
+    tradecore::instrument::SymbolTable wire_symbols;
+    if (cfg.binary.enabled) {
+        for (const auto& symbol : cfg.binary.symbols) {
+            wire_symbols.intern(symbol);
+        }
+        server.enable_binary(wire_symbols);
+        spdlog::info("binary wire format enabled ({} symbols)", wire_symbols.size());
+    }
 
-    server.set_handler(
+    // Shared by the ZMQ endpoint and the native FIX gateway
+    auto dispatch =
         [&](const std::string& client_id,
             const fix::FixMessage& msg)
             -> std::vector<fix::FixMessage> {
@@ -62,7 +168,7 @@ int main(int argc, char* argv[]) {
 
             metrics.orders_received++;
             tradecore::core::ScopedTimer timer;
-            auto responses = order_mgr.handle_new_order(msg);
+            auto responses = order_mgr.handle_new_order(msg, client_id);
 
             for (const auto& r : responses) {
                 metrics.messages_out++;
@@ -70,10 +176,12 @@ int main(int argc, char* argv[]) {
                     const auto& er = r.execution_report();
                     if (er.exec_type() == fix::EXEC_TYPE_FILL) {
                         metrics.orders_filled++;
-                        metrics.add_notional(er.last_px() * er.last_qty());
+                        metrics.add_notional(tradecore::core::Price(er.last_px()),
+                                             tradecore::core::Qty(er.last_qty()));
                     } else if (er.exec_type() == fix::EXEC_TYPE_PARTIAL_FILL) {
                         metrics.partial_fills++;
-                        metrics.add_notional(er.last_px() * er.last_qty());
+                        metrics.add_notional(tradecore::core::Price(er.last_px()),
+                                             tradecore::core::Qty(er.last_qty()));
                     }
                 } else if (r.has_reject()) {
                     metrics.orders_rejected++;
@@ -99,6 +207,48 @@ int main(int argc, char* argv[]) {
             return responses;
         }
 
+        if (msg.has_order_cancel_replace_request()) {
+            const auto& replace = msg.order_cancel_replace_request();
+            spdlog::info("[RECV] OrderCancelReplaceRequest from={} orig_cl_ord_id={}",
+                         client_id, replace.orig_cl_ord_id());
+
+            auto responses = order_mgr.handle_cancel_replace(msg);
+            for (const auto& r : responses) {
+                metrics.messages_out++;
+                if (r.has_execution_report()) {
+                    const auto& er = r.execution_report();
+                    if (er.exec_type() == fix::EXEC_TYPE_FILL) {
+                        metrics.orders_filled++;
+                        metrics.add_notional(tradecore::core::Price(er.last_px()),
+                                             tradecore::core::Qty(er.last_qty()));
+                    } else if (er.exec_type() == fix::EXEC_TYPE_PARTIAL_FILL) {
+                        metrics.partial_fills++;
+                        metrics.add_notional(tradecore::core::Price(er.last_px()),
+                                             tradecore::core::Qty(er.last_qty()));
+                    }
+                } else if (r.has_reject()) {
+                    metrics.orders_rejected++;
+                }
+            }
+            return responses;
+        }
+
+        if (msg.has_order_mass_cancel_request()) {
+            const auto& mass = msg.order_mass_cancel_request();
+            spdlog::info("[RECV] OrderMassCancelRequest from={} type={} symbol={}",
+                         client_id, static_cast<int>(mass.mass_cancel_request_type()),
+                         mass.instrument().symbol());
+
+            auto responses = order_mgr.handle_mass_cancel(msg, client_id);
+            for (const auto& r : responses) {
+                metrics.messages_out++;
+                if (r.has_order_mass_cancel_report()) {
+                    metrics.orders_cancelled += r.order_mass_cancel_report().total_affected_orders();
+                }
+            }
+            return responses;
+        }
+
         if (msg.has_heartbeat()) {
             spdlog::debug("[RECV] Heartbeat from={}", client_id);
             metrics.messages_out++;
@@ -107,23 +257,7 @@ int main(int argc, char* argv[]) {
 
         if (msg.has_position_request()) {
             spdlog::info("[RECV] PositionRequest from={}", client_id);
-            auto response = tradecore::messaging::make_position_report(
-                msg, tradecore::messaging::generate_uuid());
-
-            auto* pr = response.mutable_position_report();
-            for (const auto& pos : book_keeper.get_all_positions()) {
-                auto* entry = pr->add_positions();
-                entry->mutable_instrument()->set_symbol(pos.symbol);
-                entry->mutable_instrument()->set_security_type(fix::SECURITY_TYPE_COMMON_STOCK);
-                if (pos.quantity >= 0) {
-                    entry->set_long_qty(pos.quantity);
-                } else {
-                    entry->set_short_qty(-pos.quantity);
-                }
-                entry->set_avg_price(pos.avg_price);
-                entry->set_realized_pnl(pos.realized_pnl);
-            }
-
+            auto response = positions.handle_request(client_id, msg);
             metrics.messages_out++;
             return {response};
         }
@@ -131,15 +265,127 @@ int main(int argc, char* argv[]) {
         spdlog::warn("[RECV] Unknown message from={}", client_id);
         metrics.messages_out++;
         return {tradecore::messaging::make_reject(msg, "Unknown message type")};
+    };
+    server.set_handler(dispatch);
+
+    // Pull a vanished client's quotes in one sweep; quotes that already
+    // traded are not counted
+    auto cancel_session = [&](const std::string& client_id) {
+        positions.unsubscribe(client_id);
+        auto cancelled = order_mgr.cancel_orders({client_id, "", ""});
+        metrics.orders_cancelled += cancelled;
+        spdlog::warn("[CANCEL] {} disconnected, {} resting orders cancelled", client_id, cancelled);
+    };
+    if (cfg.server.session_timeout_ms > 0) {
+        server.set_session_timeout(std::chrono::milliseconds(cfg.server.session_timeout_ms),
+                                   cancel_session);
+        spdlog::info("cancel-on-disconnect after {}ms of silence", cfg.server.session_timeout_ms);
+    }
+
+    std::unique_ptr<tradecore::messaging::FixGateway> fix_gateway;
+    if (cfg.fix_gateway.enabled) {
+        fix_gateway = std::make_unique<tradecore::messaging::FixGateway>(
+            static_cast<uint16_t>(cfg.fix_gateway.port), cfg.fix_gateway.comp_id,
+            cfg.fix_gateway.heartbeat_interval_s);
+        fix_gateway->set_handler(dispatch);
+        if (cfg.fix_gateway.cancel_on_disconnect) {
+            fix_gateway->set_disconnect_handler(cancel_session);
+        }
+        server.watch_fd(fix_gateway->poll_fd(), [&] { fix_gateway->poll_once(0); });
+        spdlog::info("FIX gateway listening on port {} as {}",
+                     fix_gateway->port(), cfg.fix_gateway.comp_id);
+    }
+
+    // Reports sent outside their owner's request (triggered stops, position updates)
+    auto send_report = [&](const std::string& session, const fix::FixMessage& report) {
+        metrics.messages_out++;
+        if (fix_gateway && fix_gateway->send(session, report)) return;
+        server.send(session, report);
+    };
+    order_mgr.set_report_sink(send_report);
+    positions.set_sink(send_report);
+
+    std::unique_ptr<tradecore::messaging::MarketDataPublisher> md_publisher;
+    if (cfg.market_data.enabled) {
+        matcher.set_publish_updates(true);
+        md_publisher = std::make_unique<tradecore::messaging::MarketDataPublisher>(
+            cfg.market_data.bind_address,
+            static_cast<size_t>(cfg.market_data.snapshot_depth),
+            std::chrono::milliseconds(cfg.market_data.snapshot_interval_ms));
+        if (!cfg.market_data.conflated_bind_address.empty()) {
+            md_publisher->enable_conflated_feed(
+                cfg.market_data.conflated_bind_address,
+                std::chrono::milliseconds(cfg.market_data.conflate_interval_ms));
+            spdlog::info("conflated top-of-book on {}", cfg.market_data.conflated_bind_address);
+        }
+        spdlog::info("market data publishing on {}", cfg.market_data.bind_address);
+    }
+
+    auto day_end = next_day_end(cfg.orders.day_end_utc, std::chrono::system_clock::now());
+    if (day_end) {
+        spdlog::info("Day orders expire daily at {} UTC", cfg.orders.day_end_utc);
+    } else if (!cfg.orders.day_end_utc.empty()) {
+        spdlog::warn("ignoring malformed orders.day_end_utc \"{}\" (expected HH:MM)",
+                     cfg.orders.day_end_utc);
+    }
+
+    // Periodic call auctions: each period's orders uncross together
+    auto auction_period = std::chrono::milliseconds(std::max(cfg.auction.interval_ms, 1));
+    auto next_uncross = std::chrono::steady_clock::now() + auction_period;
+    for (const auto& symbol : cfg.auction.symbols) order_mgr.open_auction(symbol);
+    if (!cfg.auction.symbols.empty()) {
+        spdlog::info("call auctions every {}ms for {} symbols", auction_period.count(),
+                     cfg.auction.symbols.size());
+    }
+
+    server.set_idle_handler([&] {
+        auto now = std::chrono::steady_clock::now();
+        if (!cfg.auction.symbols.empty() && now >= next_uncross) {
+            for (const auto& symbol : cfg.auction.symbols) order_mgr.uncross(symbol);
+            next_uncross = now + auction_period;
+        }
+        if (md_publisher) md_publisher->on_tick(matcher);
+        matcher.publish_snapshots();
+        positions.on_tick(now);
+        if (day_end && std::chrono::system_clock::now() >= *day_end) {
+            order_mgr.expire_day_orders();
+            day_end = next_day_end(cfg.orders.day_end_utc, std::chrono::system_clock::now());
+        }
+        if (g_reload_risk) {
+            g_reload_risk = 0;
+            // A missing or broken file must not publish the all-zero (disabled) defaults
+            std::string error;
+            auto reloaded = tradecore::core::Config::try_load(config_path, error);
+            if (!reloaded) {
+                spdlog::error("[RISK] reload failed, keeping current limits: {}", error);
+            } else if (risk) {
+                risk->publish(reloaded->risk.limits);
+            }
+        }
     });
 
     std::signal(SIGINT, signal_handler);
     std::signal(SIGTERM, signal_handler);
+    std::signal(SIGHUP, reload_handler);
 
     spdlog::info("tradecore listening on {} (FIX/protobuf)", cfg.server.bind_address);
     server.run();
 
     spdlog::info("Shutdown. Trades booked: {}", book_keeper.trade_count());
+    if (!cfg.booking.archive_path.empty()) {
+        tradecore::booking::TradeArchiveWriter archive;
+        auto error = archive.open(cfg.booking.archive_path);
+        if (error.empty()) {
+            archive.append_all(book_keeper.get_trades());
+            error = archive.close();
+        }
+        if (error.empty()) {
+            spdlog::info("Archived {} trades to {} ({} bytes)", archive.rows_written(),
+                         cfg.booking.archive_path, archive.bytes_written());
+        } else {
+            spdlog::error("Trade archive failed: {}", error);
+        }
+    }
     spdlog::info("{}", metrics.to_string());
     google::protobuf::ShutdownProtobufLibrary();
     return 0;
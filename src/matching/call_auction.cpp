@@ -0,0 +1,92 @@
+#include "matching/call_auction.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tradecore::matching {
+
+void CallAuction::add_market(const orders::Order& order) {
+    OrderEntry entry;
+    entry.order_id = order.order_id;
+    entry.cl_ord_id = order.cl_ord_id;
+    entry.remaining_quantity = order.quantity;
+    entry.original_quantity = order.quantity;
+    market_orders(order.side).push_back(std::move(entry));
+}
+
+bool CallAuction::cancel(const std::string& order_id) {
+    for (auto* queue : {&market_buys_, &market_sells_}) {
+        auto it = std::find_if(queue->begin(), queue->end(),
+            [&](const OrderEntry& e) { return e.order_id == order_id; });
+        if (it != queue->end()) {
+            queue->erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+Qty CallAuction::market_quantity(orders::Side side) const {
+    const auto& queue = (side == orders::Side::Buy) ? market_buys_ : market_sells_;
+    Qty total;
+    for (const auto& e : queue) total += e.remaining_quantity;
+    return total;
+}
+
+AuctionPrice CallAuction::equilibrium(const OrderBook& book, Price reference_price) const {
+    struct Step {
+        Price price;
+        Qty bid;  // buy quantity limited at exactly this price
+        Qty ask;
+    };
+
+    // Both sides' levels merged into one ascending ladder
+    std::vector<Step> steps;
+    steps.reserve(book.bid_levels() + book.ask_levels());
+    Qty demand_total = market_quantity(orders::Side::Buy);
+    book.for_each_level(BookSide::Bid, [&](const PriceLevel& level) {
+        steps.push_back({level.price, level.leaves_quantity(), Qty{}});
+        demand_total += level.leaves_quantity();
+    });
+    std::reverse(steps.begin(), steps.end());
+    size_t bids = steps.size();
+    book.for_each_level(BookSide::Ask, [&](const PriceLevel& level) {
+        steps.push_back({level.price, Qty{}, level.leaves_quantity()});
+    });
+    std::inplace_merge(steps.begin(), steps.begin() + static_cast<std::ptrdiff_t>(bids), steps.end(),
+                       [](const Step& a, const Step& b) { return a.price < b.price; });
+
+    // Walking up the ladder supply only grows and demand only shrinks
+    AuctionPrice best;
+    Qty supply = market_quantity(orders::Side::Sell);
+    Qty demand = demand_total;
+    for (size_t i = 0; i < steps.size();) {
+        Price price = steps[i].price;
+        Qty bid_here;
+        for (; i < steps.size() && steps[i].price == price; ++i) {
+            supply += steps[i].ask;
+            bid_here += steps[i].bid;
+        }
+        Qty volume = std::min(demand, supply);
+        Qty imbalance = demand - supply;
+        demand -= bid_here;  // bids limited here do not buy any higher
+        if (!volume.positive()) continue;
+
+        bool better = volume > best.volume ||
+            (volume == best.volume && (core::abs(imbalance) < core::abs(best.imbalance) ||
+             (core::abs(imbalance) == core::abs(best.imbalance) &&
+              core::abs(price - reference_price) < core::abs(best.price - reference_price))));
+        if (better) best = {price, volume, imbalance};
+    }
+
+    if (!best.volume.positive() && reference_price.positive()) {
+        Qty buys = market_quantity(orders::Side::Buy);
+        Qty sells = market_quantity(orders::Side::Sell);
+        if (buys.positive() && sells.positive()) {
+            best = {reference_price, std::min(buys, sells), buys - sells};
+        }
+    }
+    return best;
+}
+
+}  // namespace tradecore::matching
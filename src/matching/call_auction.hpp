@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "matching/order_book.hpp"
+#include "orders/order.hpp"
+
+namespace tradecore::matching {
+
+/// Clearing price of a call auction and the volume it executes.
+struct AuctionPrice {
+    Price price;      // 0 when nothing crosses
+    Qty volume;
+    Qty imbalance;    // demand minus supply left unmatched at the price
+};
+
+/// Orders collected for one symbol's call auction that the book cannot hold:
+/// market orders (no price, so they execute ahead of every limit) and the IOC
+/// limits whose leftover must not rest. Priced orders wait in the OrderBook
+/// itself, unmatched, until the uncross.
+class CallAuction {
+public:
+    void add_market(const orders::Order& order);
+    void add_ioc(const std::string& order_id) { ioc_.push_back(order_id); }
+
+    /// Drop a collected market order. Returns false if it is not held here.
+    bool cancel(const std::string& order_id);
+
+    /// Price maximizing executable volume, from one cumulative demand/supply
+    /// sweep over the book's levels (hidden orders and iceberg reserves
+    /// included) plus the market orders. Ties go to the smaller imbalance,
+    /// then to the price nearest reference_price. With only market orders on
+    /// both sides they cross at reference_price.
+    AuctionPrice equilibrium(const OrderBook& book, Price reference_price) const;
+
+    std::vector<OrderEntry>& market_orders(orders::Side side) {
+        return (side == orders::Side::Buy) ? market_buys_ : market_sells_;
+    }
+    std::vector<std::string>& ioc_orders() { return ioc_; }
+
+    Qty market_quantity(orders::Side side) const;
+
+private:
+    std::vector<OrderEntry> market_buys_;  // arrival order
+    std::vector<OrderEntry> market_sells_;
+    std::vector<std::string> ioc_;
+};
+
+}  // namespace tradecore::matching
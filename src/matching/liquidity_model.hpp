@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cmath>
+#include <string>
+
+namespace tradecore::matching {
+
+enum class DepthProfile { Flat, Decaying };
+
+inline DepthProfile depth_profile_from_string(const std::string& s) {
+    if (s == "decay" || s == "decaying") return DepthProfile::Decaying;
+    return DepthProfile::Flat;
+}
+
+/// Shape of the synthetic liquidity seeded into books for backtest simulation.
+struct LiquidityModel {
+    double spread_bps = 10.0;
+    int depth_levels = 5;
+    double qty_per_level = 1000.0;
+    DepthProfile profile = DepthProfile::Flat;
+    double decay = 0.7;          // qty multiplier per level away from the touch
+    bool tick_aligned = false;   // snap levels onto the instrument tick grid
+    bool replenish = false;      // restore consumed seed levels before the next match
+    bool auto_seed = true;       // seed a book from the market price on first use
+
+    double level_quantity(int level) const {
+        if (profile == DepthProfile::Decaying) {
+            return qty_per_level * std::pow(decay, level);
+        }
+        return qty_per_level;
+    }
+};
+
+}  // namespace tradecore::matching
@@ -1,39 +1,274 @@
 #include "matching/matching_engine.hpp"
 
+#include <algorithm>
 #include <cmath>
-#include <sstream>
 
 namespace tradecore::matching {
 
+namespace {
+
+OrderEntry make_seed_entry(const std::string& order_id, Price price,
+                           Qty quantity, uint32_t slot) {
+    OrderEntry entry;
+    entry.order_id = order_id;
+    entry.cl_ord_id = order_id;
+    entry.price = price;
+    entry.remaining_quantity = quantity;
+    entry.original_quantity = quantity;
+    entry.seed_slot = slot;
+    return entry;
+}
+
+}  // namespace
+
+MatchingEngine::MatchingEngine(LiquidityModel model) : model_(model) {}
+
 MatchResult MatchingEngine::try_match(const orders::Order& order) {
-    const auto& symbol = order.instrument.symbol;
+    const auto& symbol = order.instrument->symbol;
 
-    // Backward compatibility: auto-seed book if market_prices_ has a price but no book
-    auto price_it = market_prices_.find(symbol);
-    if (books_.find(symbol) == books_.end() && price_it != market_prices_.end()) {
-        seed_book(symbol, price_it->second);
+    auto book_it = books_.find(symbol);
+    if (book_it == books_.end()) {
+        // Backward compatibility: auto-seed book if market_prices_ has a price but no book
+        auto price_it = market_prices_.find(symbol);
+        if (model_.auto_seed && price_it != market_prices_.end()) {
+            seed_book_from_model(symbol, price_it->second, order.instrument->tick_size);
+        }
+    } else if (model_.replenish) {
+        replenish_seeds(symbol, book_it->second);
     }
 
-    if (order.order_type == orders::OrderType::Market) {
-        return match_market_order(order);
-    } else if (order.order_type == orders::OrderType::Limit) {
-        return match_limit_order(order);
+    auto auction_it = auctions_.find(symbol);
+    if (auction_it != auctions_.end()) {
+        MatchResult result = collect(order, auction_it->second);
+        mark_dirty(symbol);
+        return result;
     }
 
+    MatchResult result = orders::is_stop(order.order_type) ? submit_stop(order)
+                                                           : match_order(order);
+    run_triggers(symbol, result);
+
+    mark_dirty(symbol);
+    return result;
+}
+
+MatchResult MatchingEngine::match_order(const orders::Order& order) {
+    if (order.order_type == orders::OrderType::Market) return match_market_order(order);
+    if (order.order_type == orders::OrderType::Limit) return match_limit_order(order);
     return {};
 }
 
+MatchResult MatchingEngine::submit_stop(const orders::Order& order) {
+    const auto& symbol = order.instrument->symbol;
+    Price last = get_last_trade_price(symbol);
+    if (!last.positive()) last = Price(get_market_price(symbol));
+
+    bool reached = last.positive() && (order.side == orders::Side::Buy ? last >= order.stop_price
+                                                                  : last <= order.stop_price);
+    if (reached) return match_order(orders::to_triggered(order));
+
+    stops_[symbol].add(order);
+    MatchResult result;
+    result.parked = true;
+    result.remaining_quantity = order.quantity;
+    return result;
+}
+
+SelfTradeGuard MatchingEngine::guard_for(const orders::Order& order) const {
+    if (stp_mode_ == SelfTradePrevention::None) return {};
+    return {order.owner_id, stp_mode_};
+}
+
+void MatchingEngine::note_self_trades(const OrderBook& book, SelfTradeOutcome& outcome,
+                                      MatchResult& result) {
+    result.self_trade_quantity = outcome.aggressor_quantity;
+    for (auto& entry : outcome.resting) {
+        SelfTradeEvent event;
+        event.removed = !book.contains(entry.order_id);
+        event.resting_order_id = std::move(entry.order_id);
+        event.quantity = entry.remaining_quantity;
+        result.self_trades.push_back(std::move(event));
+    }
+}
+
+MatchResult MatchingEngine::collect(const orders::Order& order, CallAuction& auction) {
+    MatchResult result;
+    result.remaining_quantity = order.quantity;
+    if (orders::is_stop(order.order_type)) {
+        // Stops wait for continuous trading to resume
+        stops_[order.instrument->symbol].add(order);
+        result.parked = true;
+        return result;
+    }
+
+    result.collected = true;
+    if (order.order_type == orders::OrderType::Market) {
+        auction.add_market(order);
+    } else {
+        rest_order(book_for(order.instrument->symbol), order, order.quantity);
+        if (order.time_in_force == orders::TimeInForce::IOC) auction.add_ioc(order.order_id);
+    }
+    return result;
+}
+
+void MatchingEngine::open_auction(const std::string& symbol) {
+    auctions_.try_emplace(symbol);
+}
+
+AuctionResult MatchingEngine::uncross(const std::string& symbol) {
+    AuctionResult result;
+    auto auction_it = auctions_.find(symbol);
+    if (auction_it == auctions_.end()) return result;
+    auto& auction = auction_it->second;
+    auto& book = book_for(symbol);
+
+    Price reference = get_last_trade_price(symbol);
+    if (!reference.positive()) reference = Price(get_market_price(symbol));
+    auto clearing = auction.equilibrium(book, reference);
+
+    if (clearing.volume.positive()) {
+        result.price = clearing.price;
+        result.volume = clearing.volume;
+
+        // Each side's share of the volume: market orders first, then the book
+        // in price-time priority, which stays within the clearing price
+        using Allocation = std::vector<std::pair<std::string, Qty>>;
+        auto allocate = [&](orders::Side side, Allocation& out) {
+            Qty left = clearing.volume;
+            for (auto& entry : auction.market_orders(side)) {
+                if (!left.positive()) break;
+                Qty qty = std::min(left, entry.remaining_quantity);
+                entry.remaining_quantity -= qty;
+                left -= qty;
+                out.emplace_back(entry.order_id, qty);
+            }
+            if (!left.positive()) return;
+            auto consumed = (side == orders::Side::Buy) ? book.consume_bids(left)
+                                                        : book.consume_asks(left);
+            note_seed_fills(symbol, consumed);
+            for (auto& entry : consumed) out.emplace_back(std::move(entry.order_id),
+                                                          entry.remaining_quantity);
+        };
+        Allocation buys, sells;
+        allocate(orders::Side::Buy, buys);
+        allocate(orders::Side::Sell, sells);
+
+        // Pair the two queues into fills in a single pass
+        size_t b = 0, s = 0;
+        Qty buy_left = buys.empty() ? Qty{} : buys[0].second;
+        Qty sell_left = sells.empty() ? Qty{} : sells[0].second;
+        while (b < buys.size() && s < sells.size()) {
+            Qty qty = std::min(buy_left, sell_left);
+            FillEvent fe;
+            fe.order_id = buys[b].first;
+            fe.resting_order_id = sells[s].first;
+            fe.fill_price = clearing.price;
+            fe.fill_quantity = qty;
+            result.fills.push_back(std::move(fe));
+
+            buy_left -= qty;
+            sell_left -= qty;
+            if (!buy_left.positive() && ++b < buys.size()) buy_left = buys[b].second;
+            if (!sell_left.positive() && ++s < sells.size()) sell_left = sells[s].second;
+        }
+        last_trade_prices_[symbol] = clearing.price;
+    }
+
+    // Market and IOC orders never carry over into the next period
+    for (auto side : {orders::Side::Buy, orders::Side::Sell}) {
+        auto& queue = auction.market_orders(side);
+        for (const auto& entry : queue) {
+            if (entry.remaining_quantity.positive()) result.cancelled.push_back(entry.order_id);
+        }
+        queue.clear();
+    }
+    for (const auto& id : auction.ioc_orders()) {
+        if (book.cancel_order(id)) result.cancelled.push_back(id);
+    }
+    auction.ioc_orders().clear();
+
+    mark_dirty(symbol);
+    return result;
+}
+
+AuctionResult MatchingEngine::close_auction(const std::string& symbol) {
+    auto result = uncross(symbol);
+    auctions_.erase(symbol);
+    if (!result.fills.empty()) {
+        MatchResult print;
+        print.fills.push_back(result.fills.back());
+        run_triggers(symbol, print);
+        mark_dirty(symbol);
+    }
+    return result;
+}
+
+void MatchingEngine::run_triggers(const std::string& symbol, const MatchResult& result) {
+    if (result.fills.empty()) return;
+    last_trade_prices_[symbol] = result.fills.back().fill_price;
+
+    auto stops_it = stops_.find(symbol);
+    if (stops_it == stops_.end() || stops_it->second.empty()) return;
+    auto& stops = stops_it->second;
+
+    auto price_range = [](const std::vector<FillEvent>& fills, Price& low, Price& high) {
+        for (const auto& fill : fills) {
+            low = std::min(low, fill.fill_price);
+            high = std::max(high, fill.fill_price);
+        }
+    };
+    Price low = result.fills.front().fill_price;
+    Price high = low;
+    price_range(result.fills, low, high);
+
+    // Triggered stops trade too, and may trigger the next tier
+    std::vector<orders::Order> fired;
+    while (low <= high) {
+        fired.clear();
+        stops.take_triggered(low, high, fired);
+        if (fired.empty()) break;
+
+        low = Price::max();
+        high = -low;
+        for (auto& stop : fired) {
+            auto order = orders::to_triggered(std::move(stop));
+            auto triggered_result = match_order(order);
+            if (!triggered_result.fills.empty()) {
+                price_range(triggered_result.fills, low, high);
+                last_trade_prices_[symbol] = triggered_result.fills.back().fill_price;
+            }
+            triggered_.push_back({std::move(order), std::move(triggered_result)});
+        }
+    }
+}
+
+std::vector<TriggeredOrder> MatchingEngine::take_triggered() {
+    std::vector<TriggeredOrder> out;
+    out.swap(triggered_);
+    return out;
+}
+
+Price MatchingEngine::get_last_trade_price(const std::string& symbol) const {
+    auto it = last_trade_prices_.find(symbol);
+    return (it != last_trade_prices_.end()) ? it->second : Price{};
+}
+
+const StopBook* MatchingEngine::get_stops(const std::string& symbol) const {
+    auto it = stops_.find(symbol);
+    return (it != stops_.end()) ? &it->second : nullptr;
+}
+
 MatchResult MatchingEngine::match_market_order(const orders::Order& order) {
     MatchResult result;
-    auto book_it = books_.find(order.instrument.symbol);
+    auto book_it = books_.find(order.instrument->symbol);
 
     if (book_it == books_.end()) {
         // Fallback: use limit_price if available (backward compat)
-        if (order.limit_price > 0.0) {
+        if (order.limit_price.positive()) {
             result.matched = true;
             result.fill_price = order.limit_price;
             result.fill_quantity = order.quantity;
-            result.remaining_quantity = 0.0;
+            result.remaining_quantity = Qty{};
             FillEvent fe;
             fe.order_id = order.order_id;
             fe.fill_price = order.limit_price;
@@ -47,22 +282,27 @@ MatchResult MatchingEngine::match_market_order(const orders::Order& order) {
 
     // Buy market order: consume asks (ascending price)
     // Sell market order: consume bids (descending price)
+    auto guard = guard_for(order);
+    SelfTradeOutcome outcome;
     std::vector<OrderEntry> consumed;
     if (order.side == orders::Side::Buy) {
-        consumed = book.consume_asks(order.quantity);
+        consumed = book.consume_asks(order.quantity, guard, &outcome);
     } else {
-        consumed = book.consume_bids(order.quantity);
+        consumed = book.consume_bids(order.quantity, guard, &outcome);
     }
+    note_self_trades(book, outcome, result);
+    result.remaining_quantity = order.quantity - result.self_trade_quantity;
 
     if (consumed.empty()) return result;
+    note_seed_fills(order.instrument->symbol, consumed);
 
-    double total_qty = 0.0;
+    Qty total_qty;
     double total_notional = 0.0;
 
     for (const auto& entry : consumed) {
-        double qty = entry.remaining_quantity;  // fill qty stored here
+        Qty qty = entry.remaining_quantity;  // fill qty stored here
         total_qty += qty;
-        total_notional += qty * entry.price;
+        total_notional += core::notional(entry.price, qty);
 
         FillEvent fe;
         fe.order_id = order.order_id;
@@ -74,31 +314,35 @@ MatchResult MatchingEngine::match_market_order(const orders::Order& order) {
 
     result.matched = true;
     result.fill_quantity = total_qty;
-    result.fill_price = total_notional / total_qty;  // VWAP
-    result.remaining_quantity = order.quantity - total_qty;
+    result.fill_price = Price(total_notional / total_qty.to_double());  // VWAP
+    result.remaining_quantity = order.quantity - total_qty - result.self_trade_quantity;
 
     return result;
 }
 
 MatchResult MatchingEngine::match_limit_order(const orders::Order& order) {
     MatchResult result;
-    auto& book = books_[order.instrument.symbol];
+    auto& book = book_for(order.instrument->symbol);
 
-    double remaining = order.quantity;
-    double total_qty = 0.0;
+    Qty remaining = order.quantity;
+    Qty total_qty;
     double total_notional = 0.0;
+    auto guard = guard_for(order);
+    SelfTradeOutcome outcome;
 
     // Match crossable levels
     if (order.side == orders::Side::Buy) {
         // Buy limit: match against asks where ask_price <= limit_price
         auto best = book.best_ask();
-        while (best.has_value() && best.value() <= order.limit_price && remaining > 0.0) {
-            auto consumed = book.consume_asks(remaining);
+        while (best.has_value() && best.value() <= order.limit_price && remaining.positive()) {
+            Qty prevented = outcome.aggressor_quantity;
+            auto consumed = book.consume_asks(remaining, guard, &outcome, order.limit_price);
+            remaining -= outcome.aggressor_quantity - prevented;
+            note_seed_fills(order.instrument->symbol, consumed);
             for (const auto& entry : consumed) {
-                if (entry.price > order.limit_price) break;
-                double qty = entry.remaining_quantity;
+                Qty qty = entry.remaining_quantity;
                 total_qty += qty;
-                total_notional += qty * entry.price;
+                total_notional += core::notional(entry.price, qty);
                 remaining -= qty;
 
                 FillEvent fe;
@@ -113,13 +357,15 @@ MatchResult MatchingEngine::match_limit_order(const orders::Order& order) {
     } else {
         // Sell limit: match against bids where bid_price >= limit_price
         auto best = book.best_bid();
-        while (best.has_value() && best.value() >= order.limit_price && remaining > 0.0) {
-            auto consumed = book.consume_bids(remaining);
+        while (best.has_value() && best.value() >= order.limit_price && remaining.positive()) {
+            Qty prevented = outcome.aggressor_quantity;
+            auto consumed = book.consume_bids(remaining, guard, &outcome, order.limit_price);
+            remaining -= outcome.aggressor_quantity - prevented;
+            note_seed_fills(order.instrument->symbol, consumed);
             for (const auto& entry : consumed) {
-                if (entry.price < order.limit_price) break;
-                double qty = entry.remaining_quantity;
+                Qty qty = entry.remaining_quantity;
                 total_qty += qty;
-                total_notional += qty * entry.price;
+                total_notional += core::notional(entry.price, qty);
                 remaining -= qty;
 
                 FillEvent fe;
@@ -133,36 +379,50 @@ MatchResult MatchingEngine::match_limit_order(const orders::Order& order) {
         }
     }
 
-    if (total_qty > 0.0) {
+    note_self_trades(book, outcome, result);
+
+    if (total_qty.positive()) {
         result.matched = true;
         result.fill_quantity = total_qty;
-        result.fill_price = total_notional / total_qty;
+        result.fill_price = Price(total_notional / total_qty.to_double());
         result.remaining_quantity = remaining;
     }
 
-    // Rest remainder in the book
-    if (remaining > 0.0) {
-        OrderEntry entry;
-        entry.order_id = order.order_id;
-        entry.cl_ord_id = order.cl_ord_id;
-        entry.price = order.limit_price;
-        entry.remaining_quantity = remaining;
-        entry.original_quantity = order.quantity;
-
-        BookSide side = (order.side == orders::Side::Buy) ? BookSide::Bid : BookSide::Ask;
-        book.add_order(side, entry);
+    // Rest remainder in the book; an IOC remainder is left for the caller to cancel
+    if (remaining.positive() && order.time_in_force != orders::TimeInForce::IOC) {
+        rest_order(book, order, remaining);
+    }
 
-        // If nothing matched, still indicate remaining
-        if (!result.matched) {
-            result.remaining_quantity = remaining;
-        }
+    // If nothing matched, still indicate remaining
+    if (!result.matched) {
+        result.remaining_quantity = remaining;
     }
 
     return result;
 }
 
+void MatchingEngine::rest_order(OrderBook& book, const orders::Order& order, Qty quantity) {
+    OrderEntry entry;
+    entry.order_id = order.order_id;
+    entry.cl_ord_id = order.cl_ord_id;
+    entry.price = order.limit_price;
+    entry.remaining_quantity = quantity;
+    entry.original_quantity = order.quantity;
+    entry.hidden = order.hidden;
+    entry.owner_id = order.owner_id;
+    if (!order.hidden && order.display_quantity.positive() && order.display_quantity < quantity) {
+        entry.peak_quantity = order.display_quantity;
+        entry.remaining_quantity = order.display_quantity;
+        entry.reserve_quantity = quantity - order.display_quantity;
+    }
+
+    BookSide side = (order.side == orders::Side::Buy) ? BookSide::Bid : BookSide::Ask;
+    book.add_order(side, entry);
+}
+
 void MatchingEngine::update_market_price(const std::string& symbol, double price) {
     market_prices_[symbol] = price;
+    if (mark_listener_) mark_listener_(symbol, get_mark_price(symbol));
 }
 
 double MatchingEngine::get_market_price(const std::string& symbol) const {
@@ -170,46 +430,209 @@ double MatchingEngine::get_market_price(const std::string& symbol) const {
     return (it != market_prices_.end()) ? it->second : 0.0;
 }
 
+double MatchingEngine::get_mark_price(const std::string& symbol) const {
+    if (const auto* book = get_book(symbol)) {
+        const auto* bid = book->best_displayed_level(BookSide::Bid);
+        const auto* ask = book->best_displayed_level(BookSide::Ask);
+        if (bid && ask) return (bid->price.to_double() + ask->price.to_double()) / 2.0;
+    }
+    Price last = get_last_trade_price(symbol);
+    return last.positive() ? last.to_double() : get_market_price(symbol);
+}
+
+void MatchingEngine::seed_book_from_model(const std::string& symbol, double ref_price,
+                                          double tick_size) {
+    seed_ladder(symbol, ref_price, model_, tick_size);
+}
+
 void MatchingEngine::seed_book(const std::string& symbol, double ref_price,
                                 double spread_bps, int depth_levels,
                                 double qty_per_level) {
-    auto& book = books_[symbol];
+    LiquidityModel model = model_;
+    model.spread_bps = spread_bps;
+    model.depth_levels = depth_levels;
+    model.qty_per_level = qty_per_level;
+    seed_ladder(symbol, ref_price, model, 0.0);
+}
+
+void MatchingEngine::seed_ladder(const std::string& symbol, double ref_price,
+                                 const LiquidityModel& model, double tick_size) {
+    auto& book = book_for(symbol);
+    auto& ladder = seeds_[symbol];
+
+    // Re-seeding replaces the previous ladder rather than stacking on top of it
+    for (const auto& slot : ladder.slots) {
+        book.cancel_order(slot.order_id);
+    }
+    ladder.slots.clear();
+    ladder.depleted.clear();
+
+    int levels = std::max(model.depth_levels, 0);
+    ladder.slots.reserve(static_cast<size_t>(levels) * 2);
+    ladder.depleted.reserve(static_cast<size_t>(levels) * 2);
 
-    double half_spread = ref_price * spread_bps / 20000.0;  // half-spread in price
+    double half_spread = ref_price * model.spread_bps / 20000.0;  // half-spread in price
     double tick = half_spread;  // use half-spread as tick size for levels
     if (tick <= 0.0) tick = 0.01;
 
-    uint64_t seq = 0;
-    for (int i = 0; i < depth_levels; ++i) {
-        double bid_price = ref_price - half_spread - i * tick;
-        double ask_price = ref_price + half_spread + i * tick;
+    // Tick-aligned grid: touch prices snap outward onto the instrument grid and
+    // levels step by a whole number of ticks (roughly the half-spread).
+    bool grid = model.tick_aligned && tick_size > 0.0;
+    double steps = 1.0, bid_ticks = 0.0, ask_ticks = 0.0;
+    if (grid) {
+        steps = std::max(1.0, std::round(half_spread / tick_size));
+        bid_ticks = std::floor((ref_price - half_spread) / tick_size + 1e-9);
+        ask_ticks = std::ceil((ref_price + half_spread) / tick_size - 1e-9);
+        if (ask_ticks <= bid_ticks) ask_ticks = bid_ticks + 1.0;
+    }
+
+    for (int i = 0; i < levels; ++i) {
+        double bid_price = grid ? (bid_ticks - i * steps) * tick_size
+                                : ref_price - half_spread - i * tick;
+        double ask_price = grid ? (ask_ticks + i * steps) * tick_size
+                                : ref_price + half_spread + i * tick;
+        double qty = model.level_quantity(i);
+        auto level = std::to_string(i);
+
+        ladder.slots.push_back({BookSide::Bid, Price(bid_price), Qty(qty), "SEED-B-" + symbol + "-" + level});
+        ladder.slots.push_back({BookSide::Ask, Price(ask_price), Qty(qty), "SEED-A-" + symbol + "-" + level});
+    }
+
+    for (size_t i = 0; i < ladder.slots.size(); ++i) {
+        const auto& slot = ladder.slots[i];
+        book.add_order(slot.side, make_seed_entry(slot.order_id, slot.price, slot.quantity,
+                                                  static_cast<uint32_t>(i + 1)));
+    }
+
+    mark_dirty(symbol);
+}
+
+void MatchingEngine::note_seed_fills(const std::string& symbol,
+                                     const std::vector<OrderEntry>& consumed) {
+    if (!model_.replenish) return;
 
-        std::ostringstream bid_id, ask_id;
-        bid_id << "SEED-B-" << symbol << "-" << i;
-        ask_id << "SEED-A-" << symbol << "-" << i;
+    SeedLadder* ladder = nullptr;
+    for (const auto& entry : consumed) {
+        if (entry.seed_slot == 0) continue;
+        if (!ladder) {
+            auto it = seeds_.find(symbol);
+            if (it == seeds_.end()) return;
+            ladder = &it->second;
+        }
+        uint32_t idx = entry.seed_slot - 1;
+        if (idx >= ladder->slots.size() || ladder->slots[idx].pending) continue;
+        ladder->slots[idx].pending = true;
+        ladder->depleted.push_back(idx);
+    }
+}
+
+void MatchingEngine::replenish_seeds(const std::string& symbol, OrderBook& book) {
+    auto it = seeds_.find(symbol);
+    if (it == seeds_.end() || it->second.depleted.empty()) return;
 
-        OrderEntry bid_entry;
-        bid_entry.order_id = bid_id.str();
-        bid_entry.cl_ord_id = bid_id.str();
-        bid_entry.price = bid_price;
-        bid_entry.remaining_quantity = qty_per_level;
-        bid_entry.original_quantity = qty_per_level;
-        book.add_order(BookSide::Bid, bid_entry);
+    auto& ladder = it->second;
+    size_t kept = 0;
+    for (uint32_t idx : ladder.depleted) {
+        auto& slot = ladder.slots[idx];
 
-        OrderEntry ask_entry;
-        ask_entry.order_id = ask_id.str();
-        ask_entry.cl_ord_id = ask_id.str();
-        ask_entry.price = ask_price;
-        ask_entry.remaining_quantity = qty_per_level;
-        ask_entry.original_quantity = qty_per_level;
-        book.add_order(BookSide::Ask, ask_entry);
+        // Partially filled seed orders are still resting; they are re-queued
+        // here once a later fill consumes them completely.
+        if (book.contains(slot.order_id)) {
+            slot.pending = false;
+            continue;
+        }
+
+        // Never restore a level through client liquidity resting on the other side
+        auto opposite = (slot.side == BookSide::Bid) ? book.best_ask() : book.best_bid();
+        bool crosses = opposite.has_value() &&
+            ((slot.side == BookSide::Bid) ? opposite.value() <= slot.price
+                                          : opposite.value() >= slot.price);
+        if (crosses) {
+            ladder.depleted[kept++] = idx;
+            continue;
+        }
+
+        // Reuses the slot's ID, so the order index stays the ladder's size. The
+        // book still allocates a map node for the level and the index entry.
+        book.add_order(slot.side, make_seed_entry(slot.order_id, slot.price, slot.quantity, idx + 1));
+        slot.pending = false;
     }
+    ladder.depleted.resize(kept);
 }
 
 bool MatchingEngine::cancel_order(const std::string& symbol, const std::string& order_id) {
+    auto stops_it = stops_.find(symbol);
+    if (stops_it != stops_.end() && stops_it->second.cancel(order_id)) return true;
+    auto auction_it = auctions_.find(symbol);
+    if (auction_it != auctions_.end() && auction_it->second.cancel(order_id)) return true;
+
     auto it = books_.find(symbol);
     if (it == books_.end()) return false;
-    return it->second.cancel_order(order_id);
+    bool cancelled = it->second.cancel_order(order_id);
+    mark_dirty(symbol);
+    return cancelled;
+}
+
+std::vector<std::string> MatchingEngine::cancel_orders(
+    const std::string& symbol, const std::unordered_set<std::string>& order_ids) {
+    std::vector<std::string> removed;
+    auto stops_it = stops_.find(symbol);
+    if (stops_it != stops_.end() && !stops_it->second.empty()) {
+        for (const auto& id : order_ids) {
+            if (stops_it->second.cancel(id)) removed.push_back(id);
+        }
+    }
+    auto auction_it = auctions_.find(symbol);
+    if (auction_it != auctions_.end()) {
+        for (const auto& id : order_ids) {
+            if (auction_it->second.cancel(id)) removed.push_back(id);
+        }
+    }
+
+    auto it = books_.find(symbol);
+    if (it == books_.end()) return removed;
+    auto& book = it->second;
+    for (const auto& id : order_ids) {
+        if (book.contains(id)) removed.push_back(id);
+    }
+    book.cancel_orders(order_ids);
+    mark_dirty(symbol);
+    return removed;
+}
+
+std::optional<MatchResult> MatchingEngine::replace_order(const orders::Order& order,
+                                                         Price new_price, Qty new_quantity) {
+    const auto& symbol = order.instrument->symbol;
+    auto it = books_.find(symbol);
+    if (it == books_.end() || !it->second.contains(order.order_id)) return std::nullopt;
+    auto& book = it->second;
+
+    bool crosses = false;
+    if (order.side == orders::Side::Buy) {
+        auto best = book.best_ask();
+        crosses = best.has_value() && new_price >= best.value();
+    } else {
+        auto best = book.best_bid();
+        crosses = best.has_value() && new_price <= best.value();
+    }
+    // During a call auction a crossing amendment waits for the uncross too
+    crosses = crosses && !in_auction(symbol);
+
+    MatchResult result;
+    if (crosses) {
+        book.cancel_order(order.order_id);
+        orders::Order amended = order;
+        amended.limit_price = new_price;
+        amended.quantity = new_quantity;
+        result = match_limit_order(amended);
+        run_triggers(symbol, result);
+    } else {
+        book.modify_order(order.order_id, new_price, new_quantity);
+        result.remaining_quantity = new_quantity;
+    }
+
+    mark_dirty(symbol);
+    return result;
 }
 
 const OrderBook* MatchingEngine::get_book(const std::string& symbol) const {
@@ -217,4 +640,74 @@ const OrderBook* MatchingEngine::get_book(const std::string& symbol) const {
     return (it != books_.end()) ? &it->second : nullptr;
 }
 
+void MatchingEngine::set_publish_updates(bool enabled) {
+    publish_updates_ = enabled;
+    for (auto& [_, book] : books_) {
+        book.set_track_updates(enabled);
+        book.clear_level_updates();
+    }
+    dirty_.clear();
+}
+
+void MatchingEngine::drain_book_updates(const BookUpdateFn& fn) {
+    for (auto* entry : dirty_) {
+        auto& book = entry->second;
+        if (!book.level_updates().empty()) {
+            fn(entry->first, book, book.level_updates());
+        }
+        book.clear_level_updates();
+    }
+    dirty_.clear();
+}
+
+void MatchingEngine::set_snapshots(BookSnapshots* snapshots) {
+    snapshots_ = snapshots;
+    snapshot_dirty_.clear();
+    if (!snapshots_) return;
+    for (auto& entry : books_) snapshot_dirty_.push_back(&entry);
+}
+
+void MatchingEngine::publish_snapshots() {
+    if (!snapshots_) return;
+    BookSnapshot snap;
+    for (auto* entry : snapshot_dirty_) {
+        entry->second.snapshot(snap);
+        auto last = last_trade_prices_.find(entry->first);
+        snap.last_trade = (last != last_trade_prices_.end()) ? last->second : Price{};
+        snap.version = ++snapshot_seq_;
+        snapshots_->store(entry->first, snap);
+    }
+    snapshot_dirty_.clear();
+}
+
+void MatchingEngine::for_each_book(
+    const std::function<void(const std::string&, const OrderBook&)>& fn) const {
+    for (const auto& [symbol, book] : books_) {
+        fn(symbol, book);
+    }
+}
+
+OrderBook& MatchingEngine::book_for(const std::string& symbol) {
+    auto [it, inserted] = books_.try_emplace(symbol);
+    if (inserted) it->second.set_track_updates(publish_updates_);
+    return it->second;
+}
+
+void MatchingEngine::mark_dirty(const std::string& symbol) {
+    if (mark_listener_) mark_listener_(symbol, get_mark_price(symbol));
+    if (!publish_updates_ && !snapshots_) return;
+
+    auto it = books_.find(symbol);
+    if (it == books_.end()) return;
+    if (snapshots_ && std::find(snapshot_dirty_.begin(), snapshot_dirty_.end(), &*it) ==
+                          snapshot_dirty_.end()) {
+        snapshot_dirty_.push_back(&*it);
+    }
+    if (!publish_updates_ || it->second.level_updates().empty()) return;
+    for (auto* entry : dirty_) {
+        if (entry == &*it) return;
+    }
+    dirty_.push_back(&*it);
+}
+
 }  // namespace tradecore::matching
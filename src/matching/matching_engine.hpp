@@ -1,57 +1,226 @@
 #pragma once
 
+#include <functional>
+#include <optional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include "core/snapshot_table.hpp"
+#include "matching/call_auction.hpp"
+#include "matching/liquidity_model.hpp"
 #include "matching/order_book.hpp"
+#include "matching/stop_book.hpp"
 #include "orders/order.hpp"
 
 namespace tradecore::matching {
 
+/// Per-symbol book snapshots readable from any thread without locks.
+using BookSnapshots = core::SnapshotTable<BookSnapshot>;
+
 struct FillEvent {
     std::string order_id;         // aggressor order
     std::string resting_order_id; // resting order consumed
-    double fill_price = 0.0;
-    double fill_quantity = 0.0;
+    Price fill_price;
+    Qty fill_quantity;
+};
+
+/// Resting quantity self-trade prevention took off the book instead of trading.
+struct SelfTradeEvent {
+    std::string resting_order_id;
+    Qty quantity;
+    bool removed = false;  // the resting order left the book
 };
 
 struct MatchResult {
     bool matched = false;
-    double fill_price = 0.0;
-    double fill_quantity = 0.0;
-    double remaining_quantity = 0.0;
+    Price fill_price;
+    Qty fill_quantity;
+    Qty remaining_quantity;
+    bool parked = false;     // stop order held untriggered in the stop book
+    bool collected = false;  // held unmatched for the symbol's call auction
+    Qty self_trade_quantity;  // incoming quantity cancelled or decremented
     std::vector<FillEvent> fills;
+    std::vector<SelfTradeEvent> self_trades;
+};
+
+/// Outcome of a call auction uncross. Every fill prints at the one clearing
+/// price; order_id is the buy order and resting_order_id the sell order.
+struct AuctionResult {
+    Price price;  // 0 when nothing crossed
+    Qty volume;
+    std::vector<FillEvent> fills;
+    std::vector<std::string> cancelled;  // market and IOC orders whose remainder was dropped
+};
+
+/// A stop released by a trade and matched as its triggered order type.
+struct TriggeredOrder {
+    orders::Order order;  // Stop -> Market, StopLimit -> Limit
+    MatchResult result;
 };
 
 class MatchingEngine {
 public:
+    explicit MatchingEngine(LiquidityModel model = {});
+
+    void set_liquidity_model(const LiquidityModel& model) { model_ = model; }
+
+    /// Self-trade prevention between orders with the same non-zero owner_id
+    /// in continuous matching. Call auctions do not apply it.
+    void set_self_trade_prevention(SelfTradePrevention mode) { stp_mode_ = mode; }
+    SelfTradePrevention self_trade_prevention() const { return stp_mode_; }
+    const LiquidityModel& liquidity_model() const { return model_; }
+
     /// Match an order against the book. For market orders, walks the book.
     /// For limit orders, matches crossable levels and rests the remainder.
+    /// Stop orders whose stop the last trade has not reached are parked in the
+    /// symbol's stop book (result.parked); otherwise they match at once as
+    /// their triggered type. Fills may trigger parked stops, see take_triggered().
     MatchResult try_match(const orders::Order& order);
 
+    /// Switch a symbol to call auction mode. Orders are collected without
+    /// matching (limits rest in a possibly crossed book, market orders wait
+    /// aside, stops park) until uncross().
+    void open_auction(const std::string& symbol);
+
+    bool in_auction(const std::string& symbol) const { return auctions_.count(symbol) != 0; }
+
+    /// Execute everything collected at the volume-maximizing price in one
+    /// pass. Market and IOC remainders are dropped; limit remainders rest.
+    /// The symbol stays in auction mode for the next call period.
+    AuctionResult uncross(const std::string& symbol);
+
+    /// Uncross and return the symbol to continuous matching. Stops the
+    /// auction price reaches are triggered, see take_triggered().
+    AuctionResult close_auction(const std::string& symbol);
+
+    /// Stops triggered by trades since the last call, already matched, in
+    /// trigger order. Their fills can trigger further stops, which follow.
+    std::vector<TriggeredOrder> take_triggered();
+
+    /// Price of the last fill on a symbol (0 if none yet).
+    Price get_last_trade_price(const std::string& symbol) const;
+
+    /// Untriggered stops for a symbol. Returns nullptr if none were ever added.
+    const StopBook* get_stops(const std::string& symbol) const;
+
     /// Set the "current market price" for a symbol (used for auto-seeding).
     void update_market_price(const std::string& symbol, double price);
 
     double get_market_price(const std::string& symbol) const;
 
-    /// Seed synthetic liquidity around a reference price for backtest simulation.
+    /// Valuation price for a symbol: the displayed BBO mid when both sides
+    /// show, else the last trade, else the market price (0 if none).
+    double get_mark_price(const std::string& symbol) const;
+
+    using MarkFn = std::function<void(const std::string& symbol, double mark)>;
+
+    /// Call fn with the symbol's mark price after every change to its book or
+    /// market price, for incremental mark-to-market.
+    void set_mark_listener(MarkFn fn) { mark_listener_ = std::move(fn); }
+
+    /// Seed synthetic liquidity around a reference price using the engine's
+    /// liquidity model. tick_size is used when the model is tick-aligned.
+    void seed_book_from_model(const std::string& symbol, double ref_price,
+                              double tick_size = 0.0);
+
+    /// Seed synthetic liquidity with an explicit spread, depth and level size.
     void seed_book(const std::string& symbol, double ref_price,
-                   double spread_bps = 10.0, int depth_levels = 5,
-                   double qty_per_level = 1000.0);
+                   double spread_bps, int depth_levels, double qty_per_level);
 
-    /// Cancel a resting order from the book.
+    /// Cancel a resting order (or parked stop).
     bool cancel_order(const std::string& symbol, const std::string& order_id);
 
+    /// Cancel a set of resting orders on one symbol in a single sweep.
+    /// Returns the IDs actually removed; listed orders that already traded
+    /// away are left out.
+    std::vector<std::string> cancel_orders(const std::string& symbol,
+                                           const std::unordered_set<std::string>& order_ids);
+
+    /// Amend a resting limit order to new_price with new_quantity remaining.
+    /// A price that crosses the opposite side is matched like a new limit
+    /// order (any remainder rests); otherwise the book amends it in place.
+    /// Returns nullopt if the order is not resting.
+    std::optional<MatchResult> replace_order(const orders::Order& order, Price new_price,
+                                             Qty new_quantity);
+
     /// Get the order book for a symbol. Returns nullptr if none exists.
     const OrderBook* get_book(const std::string& symbol) const;
 
+    /// Record level updates on every book so they can be published as deltas.
+    void set_publish_updates(bool enabled);
+
+    using BookUpdateFn = std::function<void(const std::string& symbol, const OrderBook& book,
+                                            const std::vector<LevelUpdate>& updates)>;
+
+    /// Pass each book changed since the last drain to fn, then clear its updates.
+    /// Cost is proportional to the number of level changes, not book depth.
+    void drain_book_updates(const BookUpdateFn& fn);
+
+    /// Keep a snapshot of every book in snapshots for reader threads
+    /// (nullptr stops). Changed books are copied out by publish_snapshots(),
+    /// so matching itself only notes which books changed.
+    void set_snapshots(BookSnapshots* snapshots);
+
+    /// Copy each book changed since the last call into the snapshot table.
+    /// Matching thread only; readers never wait on it.
+    void publish_snapshots();
+
+    /// Visit every book (used for periodic full snapshots).
+    void for_each_book(const std::function<void(const std::string&, const OrderBook&)>& fn) const;
+
 private:
+    // One synthetic order per seeded level. IDs are formatted once at seed time
+    // and reused on replenishment, so reseeding never grows the order index.
+    struct SeedSlot {
+        BookSide side = BookSide::Bid;
+        Price price;
+        Qty quantity;
+        std::string order_id;
+        bool pending = false;
+    };
+
+    struct SeedLadder {
+        std::vector<SeedSlot> slots;
+        std::vector<uint32_t> depleted;  // slots touched by fills since last replenish
+    };
+
+    MatchResult match_order(const orders::Order& order);
     MatchResult match_market_order(const orders::Order& order);
     MatchResult match_limit_order(const orders::Order& order);
+    MatchResult submit_stop(const orders::Order& order);
+    SelfTradeGuard guard_for(const orders::Order& order) const;
+    void note_self_trades(const OrderBook& book, SelfTradeOutcome& outcome, MatchResult& result);
+    MatchResult collect(const orders::Order& order, CallAuction& auction);
+    void rest_order(OrderBook& book, const orders::Order& order, Qty quantity);
+    void run_triggers(const std::string& symbol, const MatchResult& result);
 
+    OrderBook& book_for(const std::string& symbol);
+    void mark_dirty(const std::string& symbol);
+
+    void seed_ladder(const std::string& symbol, double ref_price,
+                     const LiquidityModel& model, double tick_size);
+    void note_seed_fills(const std::string& symbol, const std::vector<OrderEntry>& consumed);
+    void replenish_seeds(const std::string& symbol, OrderBook& book);
+
+    LiquidityModel model_;
+    SelfTradePrevention stp_mode_ = SelfTradePrevention::None;
     std::unordered_map<std::string, double> market_prices_;
     std::unordered_map<std::string, OrderBook> books_;
+    std::unordered_map<std::string, SeedLadder> seeds_;
+    std::unordered_map<std::string, StopBook> stops_;
+    std::unordered_map<std::string, CallAuction> auctions_;
+    std::unordered_map<std::string, Price> last_trade_prices_;
+    std::vector<TriggeredOrder> triggered_;
+
+    MarkFn mark_listener_;
+    bool publish_updates_ = false;
+    std::vector<std::pair<const std::string, OrderBook>*> dirty_;
+
+    BookSnapshots* snapshots_ = nullptr;
+    std::vector<std::pair<const std::string, OrderBook>*> snapshot_dirty_;
+    uint64_t snapshot_seq_ = 0;
 };
 
 }  // namespace tradecore::matching
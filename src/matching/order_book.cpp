@@ -12,12 +12,18 @@ void OrderBook::add_order(BookSide side, const OrderEntry& entry) {
 
     if (side == BookSide::Bid) {
         auto& level = bids_[e.price];
+        bool fresh = level.orders.empty();
         level.price = e.price;
+        level.add(e);
         level.orders.push_back(std::move(e));
+        record_update(side, level, fresh ? LevelAction::New : LevelAction::Change);
     } else {
         auto& level = asks_[e.price];
+        bool fresh = level.orders.empty();
         level.price = e.price;
+        level.add(e);
         level.orders.push_back(std::move(e));
+        record_update(side, level, fresh ? LevelAction::New : LevelAction::Change);
     }
 }
 
@@ -28,59 +34,205 @@ bool OrderBook::cancel_order(const std::string& order_id) {
     auto [side, price] = it->second;
     order_index_.erase(it);
 
-    if (side == BookSide::Bid) {
-        auto level_it = bids_.find(price);
-        if (level_it != bids_.end()) {
-            auto& orders = level_it->second.orders;
-            orders.erase(
-                std::remove_if(orders.begin(), orders.end(),
-                    [&](const OrderEntry& e) { return e.order_id == order_id; }),
-                orders.end());
-            if (orders.empty()) bids_.erase(level_it);
+    auto remove_from = [&](auto& levels) {
+        auto level_it = levels.find(price);
+        if (level_it == levels.end()) return;
+        auto& level = level_it->second;
+        auto entry_it = std::find_if(level.orders.begin(), level.orders.end(),
+            [&](const OrderEntry& e) { return e.order_id == order_id; });
+        if (entry_it == level.orders.end()) return;
+
+        level.remove(*entry_it);
+        level.orders.erase(entry_it);
+        if (level.orders.empty()) {
+            level.quantity = Qty{};
+            level.hidden_quantity = Qty{};
+            level.reserve_quantity = Qty{};
+            record_update(side, level, LevelAction::Delete);
+            levels.erase(level_it);
+        } else {
+            record_update(side, level, LevelAction::Change);
         }
+    };
+
+    if (side == BookSide::Bid) {
+        remove_from(bids_);
     } else {
-        auto level_it = asks_.find(price);
-        if (level_it != asks_.end()) {
-            auto& orders = level_it->second.orders;
-            orders.erase(
-                std::remove_if(orders.begin(), orders.end(),
-                    [&](const OrderEntry& e) { return e.order_id == order_id; }),
-                orders.end());
-            if (orders.empty()) asks_.erase(level_it);
-        }
+        remove_from(asks_);
     }
 
     return true;
 }
 
-std::optional<double> OrderBook::best_bid() const {
+size_t OrderBook::cancel_orders(const std::unordered_set<std::string>& order_ids) {
+    // Affected levels, each swept once however many of its orders are listed
+    std::vector<std::pair<BookSide, Price>> levels;
+    levels.reserve(order_ids.size());
+    for (const auto& id : order_ids) {
+        auto it = order_index_.find(id);
+        if (it == order_index_.end()) continue;
+        levels.push_back(it->second);
+        order_index_.erase(it);
+    }
+    std::sort(levels.begin(), levels.end());
+    levels.erase(std::unique(levels.begin(), levels.end()), levels.end());
+
+    size_t removed = 0;
+    auto sweep = [&](auto& book_side, BookSide side, Price price) {
+        auto level_it = book_side.find(price);
+        if (level_it == book_side.end()) return;
+        auto& level = level_it->second;
+        auto keep_end = std::remove_if(level.orders.begin(), level.orders.end(),
+            [&](const OrderEntry& e) {
+                if (!order_ids.count(e.order_id)) return false;
+                level.remove(e);
+                return true;
+            });
+        removed += static_cast<size_t>(level.orders.end() - keep_end);
+        level.orders.erase(keep_end, level.orders.end());
+        if (level.orders.empty()) {
+            level.quantity = Qty{};
+            level.hidden_quantity = Qty{};
+            level.reserve_quantity = Qty{};
+            record_update(side, level, LevelAction::Delete);
+            book_side.erase(level_it);
+        } else {
+            record_update(side, level, LevelAction::Change);
+        }
+    };
+
+    for (const auto& [side, price] : levels) {
+        if (side == BookSide::Bid) {
+            sweep(bids_, side, price);
+        } else {
+            sweep(asks_, side, price);
+        }
+    }
+    return removed;
+}
+
+bool OrderBook::modify_order(const std::string& order_id, Price new_price, Qty new_quantity) {
+    if (!new_quantity.positive()) return cancel_order(order_id);
+
+    auto it = order_index_.find(order_id);
+    if (it == order_index_.end()) return false;
+    auto& [side, price] = it->second;
+
+    auto modify_in = [&](auto& levels) {
+        auto level_it = levels.find(price);
+        if (level_it == levels.end()) return false;
+        auto& level = level_it->second;
+        auto entry_it = std::find_if(level.orders.begin(), level.orders.end(),
+            [&](const OrderEntry& e) { return e.order_id == order_id; });
+        if (entry_it == level.orders.end()) return false;
+
+        if (new_price == price && new_quantity <= entry_it->leaves_quantity()) {
+            // Shrink the reserve first; the live tranche only if that is not enough
+            Qty tranche = std::min(entry_it->remaining_quantity, new_quantity);
+            level.reduce(*entry_it, entry_it->remaining_quantity - tranche);
+            level.reserve_quantity -= entry_it->reserve_quantity - (new_quantity - tranche);
+            entry_it->remaining_quantity = tranche;
+            entry_it->reserve_quantity = new_quantity - tranche;
+            record_update(side, level, LevelAction::Change);
+            return true;
+        }
+
+        OrderEntry moved = std::move(*entry_it);
+        level.remove(moved);
+        level.orders.erase(entry_it);
+        if (level.orders.empty()) {
+            level.quantity = Qty{};
+            level.hidden_quantity = Qty{};
+            level.reserve_quantity = Qty{};
+            record_update(side, level, LevelAction::Delete);
+            levels.erase(level_it);
+        } else {
+            record_update(side, level, LevelAction::Change);
+        }
+
+        moved.price = new_price;
+        moved.remaining_quantity = moved.peak_quantity.positive()
+            ? std::min(moved.peak_quantity, new_quantity) : new_quantity;
+        moved.reserve_quantity = new_quantity - moved.remaining_quantity;
+        moved.sequence = ++sequence_;
+
+        auto& target = levels[new_price];
+        bool fresh = target.orders.empty();
+        target.price = new_price;
+        target.add(moved);
+        target.orders.push_back(std::move(moved));
+        record_update(side, target, fresh ? LevelAction::New : LevelAction::Change);
+        price = new_price;
+        return true;
+    };
+
+    return (side == BookSide::Bid) ? modify_in(bids_) : modify_in(asks_);
+}
+
+const OrderEntry* OrderBook::find_order(const std::string& order_id) const {
+    auto it = order_index_.find(order_id);
+    if (it == order_index_.end()) return nullptr;
+    auto [side, price] = it->second;
+
+    auto find_in = [&](const auto& levels) -> const OrderEntry* {
+        auto level_it = levels.find(price);
+        if (level_it == levels.end()) return nullptr;
+        const auto& orders = level_it->second.orders;
+        auto entry_it = std::find_if(orders.begin(), orders.end(),
+            [&](const OrderEntry& e) { return e.order_id == order_id; });
+        return (entry_it != orders.end()) ? &*entry_it : nullptr;
+    };
+
+    return (side == BookSide::Bid) ? find_in(bids_) : find_in(asks_);
+}
+
+std::optional<Price> OrderBook::best_bid() const {
     if (bids_.empty()) return std::nullopt;
     return bids_.begin()->first;
 }
 
-std::optional<double> OrderBook::best_ask() const {
+std::optional<Price> OrderBook::best_ask() const {
     if (asks_.empty()) return std::nullopt;
     return asks_.begin()->first;
 }
 
+const PriceLevel* OrderBook::best_level(BookSide side) const {
+    if (side == BookSide::Bid) {
+        return bids_.empty() ? nullptr : &bids_.begin()->second;
+    }
+    return asks_.empty() ? nullptr : &asks_.begin()->second;
+}
+
+const PriceLevel* OrderBook::best_displayed_level(BookSide side) const {
+    auto first_shown = [](const auto& levels) -> const PriceLevel* {
+        for (const auto& [price, level] : levels) {
+            if (level.displayed_orders() > 0) return &level;
+        }
+        return nullptr;
+    };
+    return (side == BookSide::Bid) ? first_shown(bids_) : first_shown(asks_);
+}
+
 std::vector<DepthEntry> OrderBook::get_depth(BookSide side, size_t levels) const {
     std::vector<DepthEntry> result;
     result.reserve(levels);
 
     if (side == BookSide::Bid) {
         for (auto it = bids_.begin(); it != bids_.end() && result.size() < levels; ++it) {
+            if (it->second.displayed_orders() == 0) continue;
             DepthEntry d;
             d.price = it->first;
-            d.quantity = it->second.total_quantity();
-            d.order_count = static_cast<int>(it->second.orders.size());
+            d.quantity = it->second.displayed_quantity();
+            d.order_count = it->second.displayed_orders();
             result.push_back(d);
         }
     } else {
         for (auto it = asks_.begin(); it != asks_.end() && result.size() < levels; ++it) {
+            if (it->second.displayed_orders() == 0) continue;
             DepthEntry d;
             d.price = it->first;
-            d.quantity = it->second.total_quantity();
-            d.order_count = static_cast<int>(it->second.orders.size());
+            d.quantity = it->second.displayed_quantity();
+            d.order_count = it->second.displayed_orders();
             result.push_back(d);
         }
     }
@@ -88,37 +240,70 @@ std::vector<DepthEntry> OrderBook::get_depth(BookSide side, size_t levels) const
     return result;
 }
 
-std::vector<OrderEntry> OrderBook::consume_bids(double quantity) {
+void OrderBook::snapshot(BookSnapshot& out) const {
+    auto fill = [](const auto& levels, DepthEntry* entries) {
+        uint32_t n = 0;
+        for (auto it = levels.begin(); it != levels.end() && n < BookSnapshot::kLevels; ++it) {
+            if (it->second.displayed_orders() == 0) continue;
+            entries[n].price = it->first;
+            entries[n].quantity = it->second.displayed_quantity();
+            entries[n].order_count = it->second.displayed_orders();
+            ++n;
+        }
+        return n;
+    };
+    out.bid_levels = fill(bids_, out.bids);
+    out.ask_levels = fill(asks_, out.asks);
+}
+
+std::vector<OrderEntry> OrderBook::consume_bids(Qty quantity, const SelfTradeGuard& guard,
+                                                SelfTradeOutcome* outcome,
+                                                std::optional<Price> limit) {
     std::vector<OrderEntry> fills;
-    double remaining = quantity;
+    Qty remaining = quantity;
 
     auto it = bids_.begin();
-    while (it != bids_.end() && remaining > 0.0) {
+    while (it != bids_.end() && remaining.positive() && (!limit || it->first >= *limit)) {
         auto& level = it->second;
-        while (!level.orders.empty() && remaining > 0.0) {
+        while (!level.orders.empty() && remaining.positive()) {
             auto& front = level.orders.front();
-            double fill_qty = std::min(remaining, front.remaining_quantity);
+            if (guard.owner_id != 0 && front.owner_id == guard.owner_id) [[unlikely]] {
+                prevent_self_trade(level, guard.mode, remaining, outcome);
+                continue;
+            }
+            Qty fill_qty = std::min(remaining, front.remaining_quantity);
 
             OrderEntry fill;
             fill.order_id = front.order_id;
             fill.cl_ord_id = front.cl_ord_id;
             fill.price = front.price;
+            fill.seed_slot = front.seed_slot;
             fill.remaining_quantity = fill_qty;  // used as fill_quantity here
 
             remaining -= fill_qty;
             front.remaining_quantity -= fill_qty;
-
-            if (front.remaining_quantity <= 0.0) {
-                order_index_.erase(front.order_id);
-                level.orders.pop_front();
+            level.reduce(front, fill_qty);
+
+            if (!front.remaining_quantity.positive()) {
+                if (front.reserve_quantity.positive()) {
+                    replenish(level);
+                } else {
+                    order_index_.erase(front.order_id);
+                    level.orders.pop_front();
+                }
             }
 
             fills.push_back(std::move(fill));
         }
 
         if (level.orders.empty()) {
+            level.quantity = Qty{};
+            level.hidden_quantity = Qty{};
+            level.reserve_quantity = Qty{};
+            record_update(BookSide::Bid, level, LevelAction::Delete);
             it = bids_.erase(it);
         } else {
+            record_update(BookSide::Bid, level, LevelAction::Change);
             ++it;
         }
     }
@@ -126,37 +311,54 @@ std::vector<OrderEntry> OrderBook::consume_bids(double quantity) {
     return fills;
 }
 
-std::vector<OrderEntry> OrderBook::consume_asks(double quantity) {
+std::vector<OrderEntry> OrderBook::consume_asks(Qty quantity, const SelfTradeGuard& guard,
+                                                SelfTradeOutcome* outcome,
+                                                std::optional<Price> limit) {
     std::vector<OrderEntry> fills;
-    double remaining = quantity;
+    Qty remaining = quantity;
 
     auto it = asks_.begin();
-    while (it != asks_.end() && remaining > 0.0) {
+    while (it != asks_.end() && remaining.positive() && (!limit || it->first <= *limit)) {
         auto& level = it->second;
-        while (!level.orders.empty() && remaining > 0.0) {
+        while (!level.orders.empty() && remaining.positive()) {
             auto& front = level.orders.front();
-            double fill_qty = std::min(remaining, front.remaining_quantity);
+            if (guard.owner_id != 0 && front.owner_id == guard.owner_id) [[unlikely]] {
+                prevent_self_trade(level, guard.mode, remaining, outcome);
+                continue;
+            }
+            Qty fill_qty = std::min(remaining, front.remaining_quantity);
 
             OrderEntry fill;
             fill.order_id = front.order_id;
             fill.cl_ord_id = front.cl_ord_id;
             fill.price = front.price;
+            fill.seed_slot = front.seed_slot;
             fill.remaining_quantity = fill_qty;
 
             remaining -= fill_qty;
             front.remaining_quantity -= fill_qty;
-
-            if (front.remaining_quantity <= 0.0) {
-                order_index_.erase(front.order_id);
-                level.orders.pop_front();
+            level.reduce(front, fill_qty);
+
+            if (!front.remaining_quantity.positive()) {
+                if (front.reserve_quantity.positive()) {
+                    replenish(level);
+                } else {
+                    order_index_.erase(front.order_id);
+                    level.orders.pop_front();
+                }
             }
 
             fills.push_back(std::move(fill));
         }
 
         if (level.orders.empty()) {
+            level.quantity = Qty{};
+            level.hidden_quantity = Qty{};
+            level.reserve_quantity = Qty{};
+            record_update(BookSide::Ask, level, LevelAction::Delete);
             it = asks_.erase(it);
         } else {
+            record_update(BookSide::Ask, level, LevelAction::Change);
             ++it;
         }
     }
@@ -164,9 +366,61 @@ std::vector<OrderEntry> OrderBook::consume_asks(double quantity) {
     return fills;
 }
 
+void OrderBook::replenish(PriceLevel& level) {
+    // Refill the exhausted front tranche and requeue it behind the level
+    OrderEntry e = std::move(level.orders.front());
+    level.orders.pop_front();
+    level.remove(e);
+    e.remaining_quantity = std::min(e.peak_quantity, e.reserve_quantity);
+    e.reserve_quantity -= e.remaining_quantity;
+    e.sequence = ++sequence_;
+    level.add(e);
+    level.orders.push_back(std::move(e));
+}
+
+void OrderBook::prevent_self_trade(PriceLevel& level, SelfTradePrevention mode,
+                                   Qty& remaining, SelfTradeOutcome* outcome) {
+    auto& front = level.orders.front();
+    if (mode == SelfTradePrevention::CancelAggressor) {
+        if (outcome) outcome->aggressor_quantity += remaining;
+        remaining = Qty{};
+        return;
+    }
+
+    OrderEntry taken;
+    taken.order_id = front.order_id;
+    taken.cl_ord_id = front.cl_ord_id;
+    taken.price = front.price;
+    taken.owner_id = front.owner_id;
+    taken.remaining_quantity = front.leaves_quantity();
+
+    if (mode == SelfTradePrevention::DecrementBoth && remaining < taken.remaining_quantity) {
+        // Partial decrement: the tranche first, then any iceberg reserve
+        Qty qty = remaining;
+        Qty from_tranche = std::min(qty, front.remaining_quantity);
+        front.remaining_quantity -= from_tranche;
+        level.reduce(front, from_tranche);
+        front.reserve_quantity -= qty - from_tranche;
+        level.reserve_quantity -= qty - from_tranche;
+        if (!front.remaining_quantity.positive()) replenish(level);
+        taken.remaining_quantity = qty;
+    } else {
+        order_index_.erase(front.order_id);
+        level.remove(front);
+        level.orders.pop_front();
+    }
+
+    if (mode == SelfTradePrevention::DecrementBoth) {
+        remaining -= taken.remaining_quantity;
+        if (outcome) outcome->aggressor_quantity += taken.remaining_quantity;
+    }
+    if (outcome) outcome->resting.push_back(std::move(taken));
+}
+
 void OrderBook::cleanup_empty_levels() {
     for (auto it = bids_.begin(); it != bids_.end();) {
         if (it->second.orders.empty()) {
+            record_update(BookSide::Bid, it->second, LevelAction::Delete);
             it = bids_.erase(it);
         } else {
             ++it;
@@ -174,6 +428,7 @@ void OrderBook::cleanup_empty_levels() {
     }
     for (auto it = asks_.begin(); it != asks_.end();) {
         if (it->second.orders.empty()) {
+            record_update(BookSide::Ask, it->second, LevelAction::Delete);
             it = asks_.erase(it);
         } else {
             ++it;
@@ -181,4 +436,25 @@ void OrderBook::cleanup_empty_levels() {
     }
 }
 
+void OrderBook::record_update(BookSide side, PriceLevel& level, LevelAction action) {
+    // Publish the displayed view: a level holding only hidden orders is
+    // withdrawn if it was showing and otherwise not announced at all
+    if (action != LevelAction::Delete && level.displayed_orders() == 0) {
+        action = LevelAction::Delete;
+    }
+    bool was_shown = level.shown;
+    level.shown = (action != LevelAction::Delete);
+    if (!was_shown && action == LevelAction::Delete) return;
+    if (!was_shown) action = LevelAction::New;
+    if (!track_updates_) return;
+
+    LevelUpdate u;
+    u.side = side;
+    u.action = action;
+    u.price = level.price;
+    u.quantity = (action == LevelAction::Delete) ? Qty{} : level.displayed_quantity();
+    u.order_count = (action == LevelAction::Delete) ? 0 : level.displayed_orders();
+    updates_.push_back(u);
+}
+
 }  // namespace tradecore::matching
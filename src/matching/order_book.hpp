@@ -7,70 +7,228 @@
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "core/fixed_point.hpp"
 
 namespace tradecore::matching {
 
+using core::Price;
+using core::Qty;
+
 struct OrderEntry {
     std::string order_id;
     std::string cl_ord_id;
-    double price = 0.0;
-    double remaining_quantity = 0.0;
-    double original_quantity = 0.0;
+    Price price;
+    Qty remaining_quantity;
+    Qty original_quantity;
     uint64_t sequence = 0;
+    uint32_t seed_slot = 0;  // 1-based seed ladder slot; 0 for client orders
+    uint32_t owner_id = 0;   // self-trade prevention group; 0 never matches itself
+    // Iceberg: remaining_quantity is the live tranche of at most peak_quantity;
+    // reserve_quantity refills it when it is exhausted (0 peak: plain order)
+    Qty peak_quantity;
+    Qty reserve_quantity;
+    bool hidden = false;  // matchable but never shown in depth or updates
+
+    Qty leaves_quantity() const { return remaining_quantity + reserve_quantity; }
 };
 
 struct PriceLevel {
-    double price = 0.0;
+    Price price;
+    Qty quantity;              // running sum of remaining_quantity over orders
+    Qty hidden_quantity;       // part of quantity resting in hidden orders
+    Qty reserve_quantity;      // iceberg reserves behind the live tranches
+    int hidden_orders = 0;
+    bool shown = false;            // last published update left the level visible
     std::deque<OrderEntry> orders;
 
-    double total_quantity() const {
-        double total = 0.0;
-        for (const auto& entry : orders) {
-            total += entry.remaining_quantity;
-        }
-        return total;
+    Qty total_quantity() const { return quantity; }
+    Qty displayed_quantity() const { return quantity - hidden_quantity; }
+    Qty leaves_quantity() const { return quantity + reserve_quantity; }
+    int displayed_orders() const { return static_cast<int>(orders.size()) - hidden_orders; }
+
+    // Bookkeeping for entries joining, leaving or trading at this level; the
+    // hidden flag scales the hidden totals instead of branching
+    void add(const OrderEntry& e) {
+        quantity += e.remaining_quantity;
+        hidden_quantity += e.remaining_quantity * e.hidden;
+        reserve_quantity += e.reserve_quantity;
+        hidden_orders += e.hidden;
+    }
+    void remove(const OrderEntry& e) {
+        quantity -= e.remaining_quantity;
+        hidden_quantity -= e.remaining_quantity * e.hidden;
+        reserve_quantity -= e.reserve_quantity;
+        hidden_orders -= e.hidden;
+    }
+    void reduce(const OrderEntry& e, Qty qty) {
+        quantity -= qty;
+        hidden_quantity -= qty * e.hidden;
     }
 };
 
 enum class BookSide { Bid, Ask };
 
+/// What happens when an incoming order would trade against a resting order
+/// with the same owner_id.
+enum class SelfTradePrevention : uint8_t {
+    None,             // trade as usual
+    CancelResting,    // remove the resting order and keep matching
+    CancelAggressor,  // stop matching; the incoming remainder is cancelled
+    DecrementBoth,    // take the overlap off both without trading
+};
+
+inline SelfTradePrevention self_trade_prevention_from_string(const std::string& s) {
+    if (s == "cancel_resting") return SelfTradePrevention::CancelResting;
+    if (s == "cancel_aggressor") return SelfTradePrevention::CancelAggressor;
+    if (s == "decrement" || s == "decrement_both") return SelfTradePrevention::DecrementBoth;
+    return SelfTradePrevention::None;
+}
+
+/// Self-trade check for one consume call. An owner of 0 disables it; a
+/// non-zero owner needs a mode other than None.
+struct SelfTradeGuard {
+    uint32_t owner_id = 0;
+    SelfTradePrevention mode = SelfTradePrevention::None;
+};
+
+/// Quantity self-trade prevention removed instead of trading, accumulated
+/// over consume calls.
+struct SelfTradeOutcome {
+    std::vector<OrderEntry> resting;  // remaining_quantity = amount taken off each
+    Qty aggressor_quantity;       // incoming quantity cancelled or decremented
+};
+
+enum class LevelAction { New, Change, Delete };
+
+/// One aggregated price level change, recorded as the book is mutated.
+struct LevelUpdate {
+    BookSide side = BookSide::Bid;
+    LevelAction action = LevelAction::Change;
+    Price price;
+    Qty quantity;       // level total after the change (0 on Delete)
+    int order_count = 0;
+};
+
 struct DepthEntry {
-    double price = 0.0;
-    double quantity = 0.0;
+    Price price;
+    Qty quantity;
     int order_count = 0;
 };
 
+/// Fixed-size copy of a book's displayed depth, for lock-free publication
+/// to reader threads (see MatchingEngine::set_snapshots).
+struct BookSnapshot {
+    static constexpr size_t kLevels = 10;
+
+    uint32_t bid_levels = 0;
+    uint32_t ask_levels = 0;
+    DepthEntry bids[kLevels];  // best first
+    DepthEntry asks[kLevels];
+    Price last_trade;          // 0 before the first trade
+    uint64_t version = 0;      // engine-wide publish sequence; rises with each copy of this book
+
+    const DepthEntry* best_bid() const { return bid_levels ? &bids[0] : nullptr; }
+    const DepthEntry* best_ask() const { return ask_levels ? &asks[0] : nullptr; }
+};
+
 class OrderBook {
 public:
     void add_order(BookSide side, const OrderEntry& entry);
 
     bool cancel_order(const std::string& order_id);
 
-    std::optional<double> best_bid() const;
-    std::optional<double> best_ask() const;
+    /// Remove every listed order that is resting, sweeping each affected
+    /// level once. Returns the number of orders removed.
+    size_t cancel_orders(const std::unordered_set<std::string>& order_ids);
+
+    /// Amend a resting order to new_price / new_quantity (leaves, reserve
+    /// included). A quantity decrease at the same price keeps queue priority
+    /// and shrinks an iceberg's reserve before its tranche; any other
+    /// change moves the order to the back of the target level in one step.
+    /// A non-positive quantity cancels. Returns false if the order is not resting.
+    bool modify_order(const std::string& order_id, Price new_price, Qty new_quantity);
+
+    /// Resting entry for an order, or nullptr.
+    const OrderEntry* find_order(const std::string& order_id) const;
+
+    bool contains(const std::string& order_id) const {
+        return order_index_.count(order_id) != 0;
+    }
+
+    std::optional<Price> best_bid() const;
+    std::optional<Price> best_ask() const;
+
+    /// Best level on a side, or nullptr if that side is empty.
+    const PriceLevel* best_level(BookSide side) const;
 
+    /// Best level with displayed quantity, skipping levels that hold only
+    /// hidden orders; nullptr if nothing is shown on that side.
+    const PriceLevel* best_displayed_level(BookSide side) const;
+
+    /// Displayed depth: hidden orders and iceberg reserves are left out, and
+    /// levels with nothing displayed are skipped.
     std::vector<DepthEntry> get_depth(BookSide side, size_t levels = 5) const;
 
-    /// Walk the bid side consuming liquidity. Returns consumed entries.
-    /// Each entry has fill_price and fill_quantity set.
-    std::vector<OrderEntry> consume_bids(double quantity);
+    /// Fill the depth fields of out (up to BookSnapshot::kLevels a side)
+    /// without allocating.
+    void snapshot(BookSnapshot& out) const;
+
+    /// Visit every level on a side, best price first, hidden ones included.
+    template <typename F>
+    void for_each_level(BookSide side, F&& fn) const {
+        if (side == BookSide::Bid) {
+            for (const auto& [price, level] : bids_) fn(level);
+        } else {
+            for (const auto& [price, level] : asks_) fn(level);
+        }
+    }
 
-    /// Walk the ask side consuming liquidity. Returns consumed entries.
-    std::vector<OrderEntry> consume_asks(double quantity);
+    /// Walk the bid side consuming liquidity. Returns consumed entries.
+    /// Each entry has fill_price and fill_quantity set. An iceberg whose
+    /// tranche runs out is refilled from its reserve and requeued at the back
+    /// of its level with a new sequence. Resting orders of the guard's owner
+    /// are handled per its mode and reported in outcome instead of filling.
+    /// With a limit, levels priced below it are left untouched, own orders
+    /// included.
+    std::vector<OrderEntry> consume_bids(Qty quantity, const SelfTradeGuard& guard = {},
+                                         SelfTradeOutcome* outcome = nullptr,
+                                         std::optional<Price> limit = std::nullopt);
+
+    /// Walk the ask side consuming liquidity, stopping above limit if given.
+    std::vector<OrderEntry> consume_asks(Qty quantity, const SelfTradeGuard& guard = {},
+                                         SelfTradeOutcome* outcome = nullptr,
+                                         std::optional<Price> limit = std::nullopt);
 
     void cleanup_empty_levels();
 
     size_t bid_levels() const { return bids_.size(); }
     size_t ask_levels() const { return asks_.size(); }
 
+    /// Record a LevelUpdate for every level change (off by default).
+    void set_track_updates(bool enabled) { track_updates_ = enabled; }
+
+    /// Level changes recorded since the last clear, in mutation order.
+    const std::vector<LevelUpdate>& level_updates() const { return updates_; }
+    void clear_level_updates() { updates_.clear(); }
+
 private:
+    void record_update(BookSide side, PriceLevel& level, LevelAction action);
+    void replenish(PriceLevel& level);
+    void prevent_self_trade(PriceLevel& level, SelfTradePrevention mode, Qty& remaining,
+                            SelfTradeOutcome* outcome);
+
     // Bids: descending price order (std::greater)
-    std::map<double, PriceLevel, std::greater<>> bids_;
+    std::map<Price, PriceLevel, std::greater<>> bids_;
     // Asks: ascending price order (default)
-    std::map<double, PriceLevel> asks_;
+    std::map<Price, PriceLevel> asks_;
     // O(1) cancel lookup: order_id -> (side, price)
-    std::unordered_map<std::string, std::pair<BookSide, double>> order_index_;
+    std::unordered_map<std::string, std::pair<BookSide, Price>> order_index_;
     uint64_t sequence_ = 0;
+    bool track_updates_ = false;
+    std::vector<LevelUpdate> updates_;
 };
 
 }  // namespace tradecore::matching
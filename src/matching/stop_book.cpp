@@ -0,0 +1,40 @@
+#include "matching/stop_book.hpp"
+
+#include <iterator>
+
+namespace tradecore::matching {
+
+void StopBook::add(const orders::Order& order) {
+    auto& side = (order.side == orders::Side::Buy) ? buys_ : sells_;
+    auto it = side.emplace(order.stop_price, order);
+    index_[order.order_id] = {order.side, it};
+}
+
+bool StopBook::cancel(const std::string& order_id) {
+    auto it = index_.find(order_id);
+    if (it == index_.end()) return false;
+    auto& [side, stop_it] = it->second;
+    ((side == orders::Side::Buy) ? buys_ : sells_).erase(stop_it);
+    index_.erase(it);
+    return true;
+}
+
+void StopBook::take_triggered(core::Price low, core::Price high, std::vector<orders::Order>& out) {
+    while (!buys_.empty() && buys_.begin()->first <= high) {
+        auto it = buys_.begin();
+        index_.erase(it->second.order_id);
+        out.push_back(std::move(it->second));
+        buys_.erase(it);
+    }
+    // Highest sell stop first; among equal stops the earliest arrival
+    while (!sells_.empty() && std::prev(sells_.end())->first >= low) {
+        auto first = sells_.lower_bound(std::prev(sells_.end())->first);
+        for (auto it = first; it != sells_.end(); ++it) {
+            index_.erase(it->second.order_id);
+            out.push_back(std::move(it->second));
+        }
+        sells_.erase(first, sells_.end());
+    }
+}
+
+}  // namespace tradecore::matching
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "orders/order.hpp"
+
+namespace tradecore::matching {
+
+/// Untriggered stop and stop-limit orders for one symbol, kept sorted by stop
+/// price. Buy stops trigger when the market trades at or above the stop, sell
+/// stops at or below, so each trade only looks at the near end of each side.
+class StopBook {
+public:
+    void add(const orders::Order& order);
+    bool cancel(const std::string& order_id);
+
+    bool contains(const std::string& order_id) const { return index_.count(order_id) > 0; }
+    bool empty() const { return index_.empty(); }
+    size_t size() const { return index_.size(); }
+
+    /// Move every stop triggered by trades between low and high into out:
+    /// buy stops at or below high (lowest first), then sell stops at or above
+    /// low (highest first). Equal stop prices keep arrival order.
+    void take_triggered(core::Price low, core::Price high, std::vector<orders::Order>& out);
+
+private:
+    using Stops = std::multimap<core::Price, orders::Order>;
+
+    Stops buys_;
+    Stops sells_;
+    std::unordered_map<std::string, std::pair<orders::Side, Stops::iterator>> index_;
+};
+
+}  // namespace tradecore::matching
@@ -0,0 +1,69 @@
+#include "messaging/bbo_conflator.hpp"
+
+namespace tradecore::messaging {
+
+BboConflator::BboConflator(size_t max_symbols)
+    : capacity_(max_symbols), slots_(std::make_unique<Slot[]>(max_symbols)) {
+    index_.reserve(max_symbols);
+}
+
+bool BboConflator::update(const std::string& symbol, const matching::OrderBook& book) {
+    const auto* bid = book.best_displayed_level(matching::BookSide::Bid);
+    const auto* ask = book.best_displayed_level(matching::BookSide::Ask);
+    double bid_px = bid ? bid->price.to_double() : 0.0;
+    double bid_size = bid ? bid->displayed_quantity().to_double() : 0.0;
+    double ask_px = ask ? ask->price.to_double() : 0.0;
+    double ask_size = ask ? ask->displayed_quantity().to_double() : 0.0;
+
+    Slot* slot = nullptr;
+    auto it = index_.find(symbol);
+    if (it != index_.end()) {
+        slot = &slots_[it->second];
+        // Only the writer mutates slots, so relaxed reads of its own values are exact
+        if (slot->bid_px.load(std::memory_order_relaxed) == bid_px &&
+            slot->bid_size.load(std::memory_order_relaxed) == bid_size &&
+            slot->ask_px.load(std::memory_order_relaxed) == ask_px &&
+            slot->ask_size.load(std::memory_order_relaxed) == ask_size) {
+            return false;
+        }
+    } else {
+        size_t n = size_.load(std::memory_order_relaxed);
+        if (n == capacity_) return false;
+        slot = &slots_[n];
+        slot->symbol = symbol;
+        index_.emplace(symbol, static_cast<uint32_t>(n));
+        size_.store(n + 1, std::memory_order_release);
+    }
+
+    uint64_t seq = slot->seq.load(std::memory_order_relaxed);
+    slot->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->bid_px.store(bid_px, std::memory_order_relaxed);
+    slot->bid_size.store(bid_size, std::memory_order_relaxed);
+    slot->ask_px.store(ask_px, std::memory_order_relaxed);
+    slot->ask_size.store(ask_size, std::memory_order_relaxed);
+    slot->seq.store(seq + 2, std::memory_order_release);
+    return true;
+}
+
+bool BboConflator::read(const Slot& slot, BboSnapshot& out, uint64_t& seq) const {
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        uint64_t before = slot.seq.load(std::memory_order_acquire);
+        if (before & 1) continue;
+
+        out.symbol = &slot.symbol;
+        out.bid_px = slot.bid_px.load(std::memory_order_relaxed);
+        out.bid_size = slot.bid_size.load(std::memory_order_relaxed);
+        out.ask_px = slot.ask_px.load(std::memory_order_relaxed);
+        out.ask_size = slot.ask_size.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) == before) {
+            seq = before;
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace tradecore::messaging
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "matching/order_book.hpp"
+
+namespace tradecore::messaging {
+
+/// Best bid/offer for one symbol as last seen by a conflated reader.
+struct BboSnapshot {
+    const std::string* symbol = nullptr;
+    double bid_px = 0.0;
+    double bid_size = 0.0;
+    double ask_px = 0.0;
+    double ask_size = 0.0;
+};
+
+/// Latest-value BBO store with one fixed slot per symbol.
+///
+/// The matching thread overwrites a symbol's slot in place whenever its best
+/// bid/ask changes. Readers hold their own Cursor and drain only the slots that
+/// changed since their last drain, at whatever pace they like; intermediate
+/// values are simply overwritten, so a slow reader never queues anything or
+/// slows the writer. Slots are seqlock-protected, so cursors may be drained
+/// from other threads.
+class BboConflator {
+public:
+    explicit BboConflator(size_t max_symbols = 4096);
+
+    BboConflator(const BboConflator&) = delete;
+    BboConflator& operator=(const BboConflator&) = delete;
+
+    /// Per-reader drain position. Owned by the reader; the writer never sees it.
+    class Cursor {
+    private:
+        friend class BboConflator;
+        std::vector<uint64_t> seen_;
+    };
+
+    /// Refresh a symbol's slot from the book (writer thread only).
+    /// Returns false when the BBO is unchanged or the slot table is full.
+    bool update(const std::string& symbol, const matching::OrderBook& book);
+
+    /// Deliver every slot changed since the cursor's last drain. Returns the count.
+    template <typename Fn>
+    size_t drain(Cursor& cursor, Fn&& fn) const;
+
+    size_t symbol_count() const { return size_.load(std::memory_order_acquire); }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> seq{0};  // odd while a write is in progress
+        std::atomic<double> bid_px{0.0};
+        std::atomic<double> bid_size{0.0};
+        std::atomic<double> ask_px{0.0};
+        std::atomic<double> ask_size{0.0};
+        std::string symbol;  // written once before the slot is published
+    };
+
+    bool read(const Slot& slot, BboSnapshot& out, uint64_t& seq) const;
+
+    size_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<size_t> size_{0};
+    std::unordered_map<std::string, uint32_t> index_;  // writer-only
+};
+
+template <typename Fn>
+size_t BboConflator::drain(Cursor& cursor, Fn&& fn) const {
+    size_t n = size_.load(std::memory_order_acquire);
+    if (cursor.seen_.size() < n) cursor.seen_.resize(n, 0);
+
+    size_t delivered = 0;
+    BboSnapshot snap;
+    for (size_t i = 0; i < n; ++i) {
+        const auto& slot = slots_[i];
+        if (slot.seq.load(std::memory_order_acquire) == cursor.seen_[i]) continue;
+
+        uint64_t seq = 0;
+        if (!read(slot, snap, seq)) continue;  // writer busy; pick it up next drain
+        cursor.seen_[i] = seq;
+        fn(static_cast<const BboSnapshot&>(snap));
+        ++delivered;
+    }
+    return delivered;
+}
+
+}  // namespace tradecore::messaging
@@ -0,0 +1,230 @@
+#include "messaging/binary_codec.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+namespace tradecore::messaging {
+
+namespace {
+
+template <size_t N>
+void put_str(char (&dst)[N], const std::string& s) {
+    size_t n = std::min(N, s.size());
+    std::memcpy(dst, s.data(), n);
+    if (n < N) std::memset(dst + n, 0, N - n);
+}
+
+template <size_t N>
+void get_str(std::string* dst, const char (&src)[N]) {
+    size_t n = 0;
+    while (n < N && src[n] != '\0') ++n;
+    dst->assign(src, n);
+}
+
+int64_t to_wire(double v) {
+    return static_cast<int64_t>(std::llround(v * static_cast<double>(binary::kScale)));
+}
+
+double from_wire(int64_t v) {
+    return static_cast<double>(v) / static_cast<double>(binary::kScale);
+}
+
+uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+void set_seq_num(fix::FixMessage& msg, uint32_t seq) {
+    char buf[16];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), seq);
+    msg.set_msg_seq_num(buf, static_cast<size_t>(end - buf));
+}
+
+
+template <typename T>
+bool load(const void* data, size_t size, T& out) {
+    if (size < sizeof(T)) return false;
+    std::memcpy(&out, data, sizeof(T));
+    return true;
+}
+
+template <typename T>
+size_t store(T& out, binary::MsgType type, void* buf, size_t capacity) {
+    if (capacity < sizeof(T)) return 0;
+    out.header.msg_type = type;
+    out.header.length = static_cast<uint16_t>(sizeof(T));
+    std::memcpy(buf, &out, sizeof(T));
+    return sizeof(T);
+}
+
+}  // namespace
+
+bool BinaryCodec::decode(const void* data, size_t size, fix::FixMessage& msg) const {
+    binary::Header header;
+    if (!load(data, size, header) || header.magic != binary::kMagic ||
+        header.version != binary::kVersion) {
+        return false;
+    }
+
+    switch (header.msg_type) {
+        case binary::MsgType::NewOrder: {
+            binary::NewOrder in;
+            if (!load(data, size, in)) return false;
+            const auto& symbol = symbols_.name(in.symbol_id);
+            if (symbol.empty()) return false;
+
+            msg.Clear();
+            set_seq_num(msg, in.header.seq_num);
+            auto* nos = msg.mutable_new_order_single();
+            get_str(nos->mutable_cl_ord_id(), in.cl_ord_id);
+            nos->mutable_instrument()->set_symbol(symbol);
+            nos->set_side(static_cast<fix::Side>(in.side));
+            nos->set_order_qty(from_wire(in.order_qty));
+            nos->set_ord_type(static_cast<fix::OrdType>(in.ord_type));
+            nos->set_price(from_wire(in.price));
+            nos->set_time_in_force(static_cast<fix::TimeInForce>(in.time_in_force));
+            get_str(nos->mutable_account(), in.account);
+            get_str(nos->mutable_text(), in.strategy_id);
+            nos->set_market_price(from_wire(in.market_price));
+            return true;
+        }
+        case binary::MsgType::Cancel: {
+            binary::Cancel in;
+            if (!load(data, size, in)) return false;
+            const auto& symbol = symbols_.name(in.symbol_id);
+            if (symbol.empty()) return false;
+
+            msg.Clear();
+            set_seq_num(msg, in.header.seq_num);
+            auto* cancel = msg.mutable_order_cancel_request();
+            get_str(cancel->mutable_cl_ord_id(), in.cl_ord_id);
+            get_str(cancel->mutable_orig_cl_ord_id(), in.orig_cl_ord_id);
+            cancel->mutable_instrument()->set_symbol(symbol);
+            cancel->set_side(static_cast<fix::Side>(in.side));
+            cancel->set_order_qty(from_wire(in.order_qty));
+            return true;
+        }
+        case binary::MsgType::ExecutionReport: {
+            binary::ExecutionReport in;
+            if (!load(data, size, in)) return false;
+
+            msg.Clear();
+            set_seq_num(msg, in.header.seq_num);
+            auto* er = msg.mutable_execution_report();
+            get_str(er->mutable_order_id(), in.order_id);
+            get_str(er->mutable_cl_ord_id(), in.cl_ord_id);
+            get_str(er->mutable_exec_id(), in.exec_id);
+            er->set_exec_type(static_cast<fix::ExecType>(in.exec_type));
+            er->set_ord_status(static_cast<fix::OrdStatus>(in.ord_status));
+            er->mutable_instrument()->set_symbol(symbols_.name(in.symbol_id));
+            er->set_side(static_cast<fix::Side>(in.side));
+            er->set_order_qty(from_wire(in.order_qty));
+            er->set_last_px(from_wire(in.last_px));
+            er->set_last_qty(from_wire(in.last_qty));
+            er->set_leaves_qty(from_wire(in.leaves_qty));
+            er->set_cum_qty(from_wire(in.cum_qty));
+            er->set_avg_px(from_wire(in.avg_px));
+            er->set_commission(from_wire(in.commission));
+            return true;
+        }
+        case binary::MsgType::Reject: {
+            binary::Reject in;
+            if (!load(data, size, in)) return false;
+
+            msg.Clear();
+            set_seq_num(msg, in.header.seq_num);
+            auto* rej = msg.mutable_reject();
+            char buf[16];
+            auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), in.ref_seq_num);
+            rej->set_ref_msg_seq_num(buf, static_cast<size_t>(end - buf));
+            get_str(rej->mutable_text(), in.text);
+            rej->set_session_reject_reason(in.reason);
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t BinaryCodec::parse_seq_num(const std::string& s) {
+    uint32_t seq = 0;
+    auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), seq);
+    // Whole string or nothing: a UUID can start with digits
+    return (ec == std::errc() && end == s.data() + s.size()) ? seq : 0;
+}
+
+size_t BinaryCodec::encode(const fix::FixMessage& msg, uint32_t seq, void* buf,
+                           size_t capacity) const {
+
+    if (msg.has_execution_report()) {
+        const auto& er = msg.execution_report();
+        binary::ExecutionReport out;
+        out.header.seq_num = seq;
+        out.symbol_id = symbols_.find(er.instrument().symbol());
+        out.exec_type = static_cast<uint8_t>(er.exec_type());
+        out.ord_status = static_cast<uint8_t>(er.ord_status());
+        out.side = static_cast<uint8_t>(er.side());
+        out.order_qty = to_wire(er.order_qty());
+        out.last_px = to_wire(er.last_px());
+        out.last_qty = to_wire(er.last_qty());
+        out.leaves_qty = to_wire(er.leaves_qty());
+        out.cum_qty = to_wire(er.cum_qty());
+        out.avg_px = to_wire(er.avg_px());
+        out.commission = to_wire(er.commission());
+        out.transact_time_ns = now_ns();
+        put_str(out.order_id, er.order_id());
+        put_str(out.cl_ord_id, er.cl_ord_id());
+        put_str(out.exec_id, er.exec_id());
+        return store(out, binary::MsgType::ExecutionReport, buf, capacity);
+    }
+
+    if (msg.has_reject()) {
+        const auto& rej = msg.reject();
+        binary::Reject out;
+        out.header.seq_num = seq;
+        out.ref_seq_num = parse_seq_num(rej.ref_msg_seq_num());
+        out.reason = rej.session_reject_reason();
+        put_str(out.text, rej.text());
+        return store(out, binary::MsgType::Reject, buf, capacity);
+    }
+
+    if (msg.has_new_order_single()) {
+        const auto& nos = msg.new_order_single();
+        binary::NewOrder out;
+        out.header.seq_num = seq;
+        out.symbol_id = symbols_.find(nos.instrument().symbol());
+        if (out.symbol_id == 0) return 0;
+        out.side = static_cast<uint8_t>(nos.side());
+        out.ord_type = static_cast<uint8_t>(nos.ord_type());
+        out.time_in_force = static_cast<uint8_t>(nos.time_in_force());
+        out.order_qty = to_wire(nos.order_qty());
+        out.price = to_wire(nos.price());
+        out.market_price = to_wire(nos.market_price());
+        out.transact_time_ns = now_ns();
+        put_str(out.cl_ord_id, nos.cl_ord_id());
+        put_str(out.account, nos.account());
+        put_str(out.strategy_id, nos.text());
+        return store(out, binary::MsgType::NewOrder, buf, capacity);
+    }
+
+    if (msg.has_order_cancel_request()) {
+        const auto& cancel = msg.order_cancel_request();
+        binary::Cancel out;
+        out.header.seq_num = seq;
+        out.symbol_id = symbols_.find(cancel.instrument().symbol());
+        if (out.symbol_id == 0) return 0;
+        out.side = static_cast<uint8_t>(cancel.side());
+        out.order_qty = to_wire(cancel.order_qty());
+        out.transact_time_ns = now_ns();
+        put_str(out.cl_ord_id, cancel.cl_ord_id());
+        put_str(out.orig_cl_ord_id, cancel.orig_cl_ord_id());
+        return store(out, binary::MsgType::Cancel, buf, capacity);
+    }
+
+    return 0;
+}
+
+}  // namespace tradecore::messaging
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <fix_messages.pb.h>
+#include "instrument/symbol_table.hpp"
+
+namespace tradecore::messaging {
+
+/// Compact fixed-layout wire encoding for the hot messages (NewOrderSingle,
+/// OrderCancelRequest, ExecutionReport, Reject). Every frame starts with
+/// kMagic, which can never begin a valid protobuf message (wire type 7), so
+/// the server tells the two encodings apart per message without negotiation.
+///
+/// All integers are little-endian. Prices and quantities are int64 scaled by
+/// kScale, symbols are SymbolTable IDs, timestamps are nanoseconds since the
+/// Unix epoch, and IDs are fixed-width NUL-padded character fields.
+namespace binary {
+
+inline constexpr uint8_t kMagic = 0xB7;
+inline constexpr uint8_t kVersion = 1;
+inline constexpr int64_t kScale = 100000000;  // 1e-8 units
+
+enum class MsgType : uint8_t { NewOrder = 1, Cancel = 2, ExecutionReport = 3, Reject = 4 };
+
+#pragma pack(push, 1)
+
+struct Header {
+    uint8_t magic = kMagic;
+    uint8_t version = kVersion;
+    MsgType msg_type = MsgType::NewOrder;
+    uint8_t flags = 0;
+    uint16_t length = 0;  // whole frame, header included
+    uint16_t reserved = 0;
+    uint32_t seq_num = 0;  // sender's own per-session sequence, from 1
+};
+
+struct NewOrder {
+    Header header;
+    uint32_t symbol_id = 0;
+    uint8_t side = 0;            // fix::Side
+    uint8_t ord_type = 0;        // fix::OrdType
+    uint8_t time_in_force = 0;   // fix::TimeInForce
+    uint8_t pad = 0;
+    int64_t order_qty = 0;
+    int64_t price = 0;
+    int64_t market_price = 0;
+    uint64_t transact_time_ns = 0;
+    char cl_ord_id[20] = {};
+    char account[12] = {};
+    char strategy_id[16] = {};
+};
+
+struct Cancel {
+    Header header;
+    uint32_t symbol_id = 0;
+    uint8_t side = 0;
+    uint8_t pad[3] = {};
+    int64_t order_qty = 0;
+    uint64_t transact_time_ns = 0;
+    char cl_ord_id[20] = {};
+    char orig_cl_ord_id[20] = {};
+};
+
+struct ExecutionReport {
+    Header header;
+    uint32_t symbol_id = 0;
+    uint8_t exec_type = 0;       // fix::ExecType
+    uint8_t ord_status = 0;      // fix::OrdStatus
+    uint8_t side = 0;
+    uint8_t pad = 0;
+    int64_t order_qty = 0;
+    int64_t last_px = 0;
+    int64_t last_qty = 0;
+    int64_t leaves_qty = 0;
+    int64_t cum_qty = 0;
+    int64_t avg_px = 0;
+    int64_t commission = 0;
+    uint64_t transact_time_ns = 0;
+    char order_id[16] = {};
+    char cl_ord_id[20] = {};
+    char exec_id[40] = {};
+};
+
+struct Reject {
+    Header header;
+    uint32_t ref_seq_num = 0;
+    int32_t reason = 0;
+    char text[96] = {};
+};
+
+#pragma pack(pop)
+
+static_assert(std::endian::native == std::endian::little,
+              "binary wire structs are copied as-is and assume a little-endian host");
+
+inline constexpr size_t kMaxFrameSize = sizeof(ExecutionReport);
+
+}  // namespace binary
+
+class BinaryCodec {
+public:
+    explicit BinaryCodec(const instrument::SymbolTable& symbols) : symbols_(symbols) {}
+
+    /// True if the frame carries the binary encoding rather than protobuf.
+    static bool is_binary(const void* data, size_t size) {
+        return size >= sizeof(binary::Header) &&
+               static_cast<const uint8_t*>(data)[0] == binary::kMagic;
+    }
+
+    /// Decode a binary frame into msg (cleared first). Returns false for
+    /// malformed frames or unknown symbol IDs.
+    bool decode(const void* data, size_t size, fix::FixMessage& msg) const;
+
+    /// Encode msg into buf with seq_num in the header. Returns the number of
+    /// bytes written, or 0 if the message has no binary form or does not fit.
+    size_t encode(const fix::FixMessage& msg, uint32_t seq_num, void* buf,
+                  size_t capacity) const;
+
+    /// As above, taking the header seq_num from msg's MsgSeqNum (0 unless it
+    /// is numeric, as on messages decoded from binary).
+    size_t encode(const fix::FixMessage& msg, void* buf, size_t capacity) const {
+        return encode(msg, parse_seq_num(msg.msg_seq_num()), buf, capacity);
+    }
+
+    static uint32_t parse_seq_num(const std::string& s);
+
+private:
+    const instrument::SymbolTable& symbols_;
+};
+
+}  // namespace tradecore::messaging
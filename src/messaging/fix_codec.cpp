@@ -0,0 +1,444 @@
+#include "messaging/fix_codec.hpp"
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "messaging/protocol.hpp"
+
+namespace tradecore::messaging {
+
+namespace {
+
+constexpr std::string_view kBeginString = "FIX.4.4";
+constexpr size_t kTrailerSize = 7;  // "10=NNN<SOH>"
+
+bool parse_uint(std::string_view s, size_t& out) {
+    if (s.empty()) return false;
+    auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), out);
+    return ec == std::errc{} && end == s.data() + s.size();
+}
+
+double parse_double(std::string_view s) {
+    double v = 0.0;
+    std::from_chars(s.data(), s.data() + s.size(), v);
+    return v;
+}
+
+// --- enum mappings (FIX values are the ones noted in fix_messages.proto) ---
+
+fix::Side side_from_fix(std::string_view v) {
+    if (v == "1") return fix::SIDE_BUY;
+    if (v == "2") return fix::SIDE_SELL;
+    if (v == "5") return fix::SIDE_SHORT_SELL;
+    return fix::SIDE_UNSPECIFIED;
+}
+
+std::string_view side_to_fix(fix::Side s) {
+    switch (s) {
+        case fix::SIDE_BUY: return "1";
+        case fix::SIDE_SELL: return "2";
+        case fix::SIDE_SHORT_SELL: return "5";
+        default: return {};
+    }
+}
+
+fix::OrdType ord_type_from_fix(std::string_view v) {
+    if (v == "1") return fix::ORD_TYPE_MARKET;
+    if (v == "2") return fix::ORD_TYPE_LIMIT;
+    if (v == "3") return fix::ORD_TYPE_STOP;
+    if (v == "4") return fix::ORD_TYPE_STOP_LIMIT;
+    return fix::ORD_TYPE_UNSPECIFIED;
+}
+
+fix::TimeInForce tif_from_fix(std::string_view v) {
+    if (v.empty() || v == "0") return fix::TIF_DAY;
+    if (v == "1") return fix::TIF_GTC;
+    if (v == "3") return fix::TIF_IOC;
+    return fix::TIF_UNSPECIFIED;
+}
+
+fix::SecurityType security_type_from_fix(std::string_view v) {
+    if (v.empty() || v == "CS") return fix::SECURITY_TYPE_COMMON_STOCK;
+    if (v == "FUT") return fix::SECURITY_TYPE_FUTURE;
+    if (v == "OPT") return fix::SECURITY_TYPE_OPTION;
+    if (v == "FXSPOT") return fix::SECURITY_TYPE_FX_SPOT;
+    return fix::SECURITY_TYPE_UNSPECIFIED;
+}
+
+fix::MassCancelRequestType mass_cancel_type_from_fix(std::string_view v) {
+    if (v == "1") return fix::MASS_CANCEL_SECURITY;
+    if (v == "7") return fix::MASS_CANCEL_ALL;
+    return fix::MASS_CANCEL_UNSPECIFIED;
+}
+
+fix::SubscriptionRequestType subscription_type_from_fix(std::string_view v) {
+    if (v == "1") return fix::SUBSCRIPTION_SNAPSHOT_PLUS_UPDATES;
+    if (v == "2") return fix::SUBSCRIPTION_DISABLE;
+    return fix::SUBSCRIPTION_SNAPSHOT;
+}
+
+std::string_view exec_type_to_fix(fix::ExecType t) {
+    switch (t) {
+        case fix::EXEC_TYPE_NEW: return "0";
+        case fix::EXEC_TYPE_PARTIAL_FILL: return "1";
+        case fix::EXEC_TYPE_FILL: return "2";
+        case fix::EXEC_TYPE_CANCELLED: return "4";
+        case fix::EXEC_TYPE_REPLACED: return "5";
+        case fix::EXEC_TYPE_REJECTED: return "8";
+        default: return {};
+    }
+}
+
+std::string_view ord_status_to_fix(fix::OrdStatus s) {
+    switch (s) {
+        case fix::ORD_STATUS_NEW: return "0";
+        case fix::ORD_STATUS_PARTIALLY_FILLED: return "1";
+        case fix::ORD_STATUS_FILLED: return "2";
+        case fix::ORD_STATUS_CANCELLED: return "4";
+        case fix::ORD_STATUS_REJECTED: return "8";
+        default: return {};
+    }
+}
+
+void set(std::string* dst, std::string_view v) {
+    dst->assign(v.data(), v.size());
+}
+
+// Appends tag=value<SOH> fields to a body buffer.
+class FixWriter {
+public:
+    explicit FixWriter(std::string& out) : out_(out) {}
+
+    void add(int tag, std::string_view value) {
+        if (value.empty()) return;
+        put_tag(tag);
+        out_.append(value);
+        out_.push_back(kSoh);
+    }
+
+    void add(int tag, uint64_t value) {
+        put_tag(tag);
+        char buf[24];
+        auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+        out_.append(buf, end);
+        out_.push_back(kSoh);
+    }
+
+    void add(int tag, double value) {
+        put_tag(tag);
+        char buf[64];
+        auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::fixed);
+        out_.append(buf, end);
+        out_.push_back(kSoh);
+    }
+
+private:
+    void put_tag(int tag) {
+        char buf[12];
+        auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), tag);
+        out_.append(buf, end);
+        out_.push_back('=');
+    }
+
+    std::string& out_;
+};
+
+// Reused across calls so steady-state encoding does not allocate.
+thread_local std::string t_body;
+
+}  // namespace
+
+uint8_t fix_checksum(const char* data, size_t size) {
+    uint32_t sum = 0;
+    size_t i = 0;
+#if defined(__SSE2__)
+    // psadbw against zero sums each 8-byte half into a 64-bit lane
+    __m128i acc = _mm_setzero_si128();
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= size; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(block, zero));
+    }
+    sum = static_cast<uint32_t>(_mm_cvtsi128_si32(acc)) +
+          static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(acc, 8)));
+#endif
+    for (; i < size; ++i) {
+        sum += static_cast<uint8_t>(data[i]);
+    }
+    return static_cast<uint8_t>(sum & 0xFF);
+}
+
+bool split_fix_fields(const char* begin, const char* end, FixMessageView& out) {
+    out.count_ = 0;
+    const char* field_start = begin;
+    const char* eq = nullptr;
+
+    // Values may legitimately contain '=' (e.g. Text); only the first one in
+    // a field separates tag from value.
+    auto on_delim = [&](const char* d) -> bool {
+        if (*d == '=') {
+            if (!eq) eq = d;
+            return true;
+        }
+        if (!eq || eq == field_start || out.count_ == FixMessageView::kMaxFields) {
+            return false;
+        }
+        int tag = 0;
+        auto [tag_end, ec] = std::from_chars(field_start, eq, tag);
+        if (ec != std::errc{} || tag_end != eq) return false;
+        out.fields_[out.count_++] = {tag, std::string_view(eq + 1, static_cast<size_t>(d - eq - 1))};
+        field_start = d + 1;
+        eq = nullptr;
+        return true;
+    };
+
+    const char* p = begin;
+#if defined(__SSE2__)
+    const __m128i soh = _mm_set1_epi8(kSoh);
+    const __m128i equals = _mm_set1_epi8('=');
+    for (; p + 16 <= end; p += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        auto mask = static_cast<uint32_t>(_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(block, soh), _mm_cmpeq_epi8(block, equals))));
+        while (mask) {
+            if (!on_delim(p + __builtin_ctz(mask))) return false;
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; p < end; ++p) {
+        if ((*p == kSoh || *p == '=') && !on_delim(p)) return false;
+    }
+    return field_start == end;  // last field must be SOH-terminated
+}
+
+FixParseStatus parse_fix(std::string_view buf, FixMessageView& out, size_t& consumed) {
+    consumed = 0;
+
+    // 8=FIX.4.4<SOH>9=<len><SOH>
+    constexpr size_t kBeginLen = 2 + kBeginString.size() + 1;
+    if (buf.size() < kBeginLen + 2) return FixParseStatus::Incomplete;
+    if (buf.compare(0, 2, "8=") != 0 || buf.compare(2, kBeginString.size(), kBeginString) != 0 ||
+        buf[kBeginLen - 1] != kSoh) {
+        return FixParseStatus::BadBeginString;
+    }
+    if (buf.compare(kBeginLen, 2, "9=") != 0) return FixParseStatus::BadBodyLength;
+
+    size_t len_start = kBeginLen + 2;
+    const void* soh = std::memchr(buf.data() + len_start, kSoh, buf.size() - len_start);
+    if (!soh) {
+        return (buf.size() - len_start > 9) ? FixParseStatus::BadBodyLength
+                                            : FixParseStatus::Incomplete;
+    }
+    size_t len_end = static_cast<size_t>(static_cast<const char*>(soh) - buf.data());
+    size_t body_length = 0;
+    if (!parse_uint(buf.substr(len_start, len_end - len_start), body_length)) {
+        return FixParseStatus::BadBodyLength;
+    }
+
+    size_t trailer = len_end + 1 + body_length;
+    if (buf.size() < trailer + kTrailerSize) return FixParseStatus::Incomplete;
+    if (buf.compare(trailer, 3, "10=") != 0 || buf[trailer + kTrailerSize - 1] != kSoh) {
+        return FixParseStatus::BadBodyLength;
+    }
+
+    consumed = trailer + kTrailerSize;
+
+    size_t expected = 0;
+    if (!parse_uint(buf.substr(trailer + 3, 3), expected) ||
+        expected != fix_checksum(buf.data(), trailer)) {
+        return FixParseStatus::BadChecksum;
+    }
+
+    if (!split_fix_fields(buf.data(), buf.data() + consumed, out) || !out.has(35)) {
+        return FixParseStatus::Malformed;
+    }
+    return FixParseStatus::Ok;
+}
+
+std::string fix_to_proto(const FixMessageView& view, fix::FixMessage& out) {
+    out.Clear();
+    set(out.mutable_sender_comp_id(), view.get(49));
+    set(out.mutable_target_comp_id(), view.get(56));
+    set(out.mutable_msg_seq_num(), view.get(34));
+    set(out.mutable_sending_time(), view.get(52));
+
+    auto msg_type = view.msg_type();
+
+    if (msg_type == "D") {
+        auto* nos = out.mutable_new_order_single();
+        if (view.get(11).empty() || view.get(55).empty()) return "Missing ClOrdID or Symbol";
+        set(nos->mutable_cl_ord_id(), view.get(11));
+        auto* inst = nos->mutable_instrument();
+        set(inst->mutable_symbol(), view.get(55));
+        inst->set_security_type(security_type_from_fix(view.get(167)));
+        set(inst->mutable_exchange(), view.get(207));
+        set(inst->mutable_currency(), view.get(15));
+        nos->set_side(side_from_fix(view.get(54)));
+        nos->set_order_qty(parse_double(view.get(38)));
+        nos->set_ord_type(ord_type_from_fix(view.get(40)));
+        nos->set_price(parse_double(view.get(44)));
+        nos->set_stop_px(parse_double(view.get(99)));
+        nos->set_max_floor(parse_double(view.get(111)));
+        nos->set_hidden(view.get(1084) == "4");
+        nos->set_time_in_force(tif_from_fix(view.get(59)));
+        set(nos->mutable_account(), view.get(1));
+        set(nos->mutable_text(), view.get(58));
+        set(nos->mutable_transact_time(), view.get(60));
+        return {};
+    }
+
+    if (msg_type == "F") {
+        auto* cancel = out.mutable_order_cancel_request();
+        if (view.get(41).empty()) return "Missing OrigClOrdID";
+        set(cancel->mutable_cl_ord_id(), view.get(11));
+        set(cancel->mutable_orig_cl_ord_id(), view.get(41));
+        set(cancel->mutable_instrument()->mutable_symbol(), view.get(55));
+        cancel->set_side(side_from_fix(view.get(54)));
+        cancel->set_order_qty(parse_double(view.get(38)));
+        set(cancel->mutable_transact_time(), view.get(60));
+        return {};
+    }
+
+    if (msg_type == "G") {
+        auto* rep = out.mutable_order_cancel_replace_request();
+        if (view.get(41).empty()) return "Missing OrigClOrdID";
+        set(rep->mutable_cl_ord_id(), view.get(11));
+        set(rep->mutable_orig_cl_ord_id(), view.get(41));
+        set(rep->mutable_instrument()->mutable_symbol(), view.get(55));
+        rep->set_side(side_from_fix(view.get(54)));
+        rep->set_order_qty(parse_double(view.get(38)));
+        rep->set_ord_type(ord_type_from_fix(view.get(40)));
+        rep->set_price(parse_double(view.get(44)));
+        set(rep->mutable_transact_time(), view.get(60));
+        return {};
+    }
+
+    if (msg_type == "q") {
+        auto* req = out.mutable_order_mass_cancel_request();
+        if (view.get(11).empty() || view.get(530).empty()) return "Missing ClOrdID or MassCancelRequestType";
+        set(req->mutable_cl_ord_id(), view.get(11));
+        req->set_mass_cancel_request_type(mass_cancel_type_from_fix(view.get(530)));
+        set(req->mutable_instrument()->mutable_symbol(), view.get(55));
+        set(req->mutable_text(), view.get(58));
+        set(req->mutable_transact_time(), view.get(60));
+        return {};
+    }
+
+    if (msg_type == "0" || msg_type == "1") {
+        set(out.mutable_heartbeat()->mutable_test_req_id(), view.get(112));
+        return {};
+    }
+
+    if (msg_type == "AN") {
+        auto* req = out.mutable_position_request();
+        set(req->mutable_pos_req_id(), view.get(710));
+        set(req->mutable_account(), view.get(1));
+        set(req->mutable_text(), view.get(58));
+        req->set_subscription_request_type(subscription_type_from_fix(view.get(263)));
+        return {};
+    }
+
+    return "Unsupported MsgType";
+}
+
+void build_fix(std::string_view msg_type, std::string_view sender_comp_id,
+               std::string_view target_comp_id, uint64_t seq_num,
+               std::string_view body, std::string& out) {
+    std::string header;
+    header.reserve(96);
+    FixWriter h(header);
+    h.add(35, msg_type);
+    h.add(49, sender_comp_id);
+    h.add(56, target_comp_id);
+    h.add(34, seq_num);
+    h.add(52, std::string_view(current_timestamp()));
+
+    out.clear();
+    FixWriter w(out);
+    w.add(8, kBeginString);
+    w.add(9, static_cast<uint64_t>(header.size() + body.size()));
+    out.append(header);
+    out.append(body);
+
+    char trailer[8];
+    uint8_t sum = fix_checksum(out.data(), out.size());
+    std::snprintf(trailer, sizeof(trailer), "10=%03u", static_cast<unsigned>(sum));
+    out.append(trailer, 6);
+    out.push_back(kSoh);
+}
+
+bool proto_to_fix(const fix::FixMessage& msg, std::string_view sender_comp_id,
+                  std::string_view target_comp_id, uint64_t seq_num, std::string& out) {
+    t_body.clear();
+    FixWriter w(t_body);
+    std::string_view msg_type;
+
+    if (msg.has_execution_report()) {
+        const auto& er = msg.execution_report();
+        msg_type = "8";
+        w.add(37, er.order_id());
+        w.add(11, er.cl_ord_id());
+        w.add(41, er.orig_cl_ord_id());
+        w.add(17, er.exec_id());
+        w.add(150, exec_type_to_fix(er.exec_type()));
+        w.add(39, ord_status_to_fix(er.ord_status()));
+        w.add(55, er.instrument().symbol());
+        w.add(54, side_to_fix(er.side()));
+        w.add(38, er.order_qty());
+        w.add(31, er.last_px());
+        w.add(32, er.last_qty());
+        w.add(151, er.leaves_qty());
+        w.add(14, er.cum_qty());
+        w.add(6, er.avg_px());
+        w.add(12, er.commission());
+        w.add(58, er.text());
+        w.add(60, er.transact_time());
+    } else if (msg.has_order_mass_cancel_report()) {
+        const auto& rpt = msg.order_mass_cancel_report();
+        msg_type = "r";
+        w.add(11, rpt.cl_ord_id());
+        w.add(37, rpt.order_id());
+        // Enum values are the FIX codes
+        w.add(530, static_cast<uint64_t>(rpt.mass_cancel_request_type()));
+        w.add(531, static_cast<uint64_t>(rpt.mass_cancel_response()));
+        w.add(533, static_cast<uint64_t>(rpt.total_affected_orders()));
+        w.add(58, rpt.text());
+    } else if (msg.has_reject()) {
+        const auto& rej = msg.reject();
+        msg_type = "3";
+        w.add(45, rej.ref_msg_seq_num().empty() ? std::string_view("0")
+                                                : std::string_view(rej.ref_msg_seq_num()));
+        w.add(58, rej.text());
+        if (rej.session_reject_reason() != 0) {
+            w.add(373, static_cast<uint64_t>(rej.session_reject_reason()));
+        }
+    } else if (msg.has_heartbeat()) {
+        msg_type = "0";
+        w.add(112, msg.heartbeat().test_req_id());
+    } else if (msg.has_position_report()) {
+        const auto& pr = msg.position_report();
+        msg_type = "AP";
+        w.add(710, pr.pos_req_id());
+        w.add(721, pr.pos_rpt_id());
+        if (pr.unsolicited()) w.add(325, std::string_view("Y"));
+        w.add(702, static_cast<uint64_t>(pr.positions_size()));  // NoPositions
+        for (const auto& pos : pr.positions()) {
+            w.add(55, pos.instrument().symbol());
+            w.add(704, pos.long_qty());
+            w.add(705, pos.short_qty());
+        }
+    } else {
+        return false;
+    }
+
+    build_fix(msg_type, sender_comp_id, target_comp_id, seq_num, t_body, out);
+    return true;
+}
+
+}  // namespace tradecore::messaging
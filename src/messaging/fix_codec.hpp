@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <fix_messages.pb.h>
+
+namespace tradecore::messaging {
+
+inline constexpr char kSoh = '\x01';
+
+struct FixField {
+    int tag = 0;
+    std::string_view value;
+};
+
+/// Zero-copy view of one tag=value message. Field values point into the
+/// buffer that was parsed, which must outlive the view.
+class FixMessageView {
+public:
+    static constexpr size_t kMaxFields = 256;
+
+    /// Value of the first occurrence of tag, or an empty view if absent.
+    std::string_view get(int tag) const {
+        for (size_t i = 0; i < count_; ++i) {
+            if (fields_[i].tag == tag) return fields_[i].value;
+        }
+        return {};
+    }
+
+    bool has(int tag) const {
+        for (size_t i = 0; i < count_; ++i) {
+            if (fields_[i].tag == tag) return true;
+        }
+        return false;
+    }
+
+    std::string_view msg_type() const { return get(35); }
+
+    size_t field_count() const { return count_; }
+    const FixField& field(size_t i) const { return fields_[i]; }
+
+private:
+    friend bool split_fix_fields(const char* begin, const char* end, FixMessageView& out);
+
+    std::array<FixField, kMaxFields> fields_;
+    size_t count_ = 0;
+};
+
+enum class FixParseStatus {
+    Ok,
+    Incomplete,       // need more bytes
+    BadBeginString,   // framing lost: tag 8 missing
+    BadBodyLength,    // framing lost: tag 9 missing/invalid or trailer misplaced
+    BadChecksum,      // frame intact but tag 10 does not match; skip `consumed` bytes
+    Malformed,        // frame intact but a field is not tag=value
+};
+
+/// Parse one message from the front of buf, validating BodyLength (9) and
+/// CheckSum (10). On Ok, BadChecksum and Malformed, `consumed` is the frame length.
+FixParseStatus parse_fix(std::string_view buf, FixMessageView& out, size_t& consumed);
+
+/// Split [begin, end) into tag=value fields, locating SOH and '=' delimiters
+/// 16 bytes at a time with SSE2 where available.
+bool split_fix_fields(const char* begin, const char* end, FixMessageView& out);
+
+/// FIX checksum: byte sum modulo 256.
+uint8_t fix_checksum(const char* data, size_t size);
+
+/// Translate an application message into the protobuf model used by the
+/// order handlers. Returns an empty string on success, otherwise the reason.
+std::string fix_to_proto(const FixMessageView& view, fix::FixMessage& out);
+
+/// Serialize a response as FIX 4.4 tag=value into out (replacing its contents).
+/// Returns false if the message type has no tag=value mapping.
+bool proto_to_fix(const fix::FixMessage& msg, std::string_view sender_comp_id,
+                  std::string_view target_comp_id, uint64_t seq_num, std::string& out);
+
+/// Frame a message from a pre-rendered body ("tag=value<SOH>..." after tag 35):
+/// adds BeginString, BodyLength, the standard header and CheckSum.
+void build_fix(std::string_view msg_type, std::string_view sender_comp_id,
+               std::string_view target_comp_id, uint64_t seq_num,
+               std::string_view body, std::string& out);
+
+}  // namespace tradecore::messaging
@@ -0,0 +1,380 @@
+#include "messaging/fix_gateway.hpp"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <spdlog/spdlog.h>
+
+namespace tradecore::messaging {
+
+namespace {
+
+constexpr size_t kMaxPendingInput = 64 * 1024;  // no complete frame within this -> drop client
+constexpr int kMaxEvents = 64;
+constexpr long kHeartbeatTickNs = 250'000'000;  // heartbeat check granularity
+
+void add_field(std::string& body, std::string_view tag, std::string_view value) {
+    body.append(tag);
+    body.push_back('=');
+    body.append(value);
+    body.push_back(kSoh);
+}
+
+}  // namespace
+
+FixGateway::FixGateway(uint16_t port, std::string comp_id, int heartbeat_interval_s)
+    : comp_id_(std::move(comp_id)), heartbeat_interval_s_(heartbeat_interval_s) {
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        throw std::runtime_error(std::string("fix gateway socket: ") + std::strerror(errno));
+    }
+    int one = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listen_fd_, SOMAXCONN) < 0) {
+        int err = errno;
+        ::close(listen_fd_);
+        throw std::runtime_error(std::string("fix gateway bind: ") + std::strerror(err));
+    }
+
+    socklen_t len = sizeof(addr);
+    ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+
+    epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = listen_fd_;
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &ev);
+
+    if (heartbeat_interval_s_ > 0) {
+        timer_fd_ = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        itimerspec tick{};
+        tick.it_interval.tv_nsec = kHeartbeatTickNs;
+        tick.it_value.tv_nsec = kHeartbeatTickNs;
+        ::timerfd_settime(timer_fd_, 0, &tick, nullptr);
+        ev.data.fd = timer_fd_;
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, timer_fd_, &ev);
+    }
+}
+
+FixGateway::~FixGateway() {
+    for (auto& [fd, session] : sessions_) {
+        ::close(fd);
+    }
+    if (timer_fd_ >= 0) ::close(timer_fd_);
+    if (epoll_fd_ >= 0) ::close(epoll_fd_);
+    if (listen_fd_ >= 0) ::close(listen_fd_);
+}
+
+void FixGateway::set_handler(MessageHandler handler) {
+    handler_ = std::move(handler);
+}
+
+void FixGateway::set_disconnect_handler(DisconnectHandler handler) {
+    disconnect_handler_ = std::move(handler);
+}
+
+bool FixGateway::poll_once(int timeout_ms) {
+    epoll_event events[kMaxEvents];
+    int n = ::epoll_wait(epoll_fd_, events, kMaxEvents, timeout_ms);
+    if (n <= 0) return false;
+
+    for (int i = 0; i < n; ++i) {
+        int fd = events[i].data.fd;
+        if (fd == listen_fd_) {
+            accept_clients();
+            continue;
+        }
+        if (fd == timer_fd_) {
+            uint64_t expirations = 0;
+            ::read(timer_fd_, &expirations, sizeof(expirations));
+            check_heartbeats(Clock::now());
+            continue;
+        }
+        auto it = sessions_.find(fd);
+        if (it == sessions_.end()) continue;
+        auto& session = it->second;
+
+        if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+            to_close_.push_back(fd);
+            continue;
+        }
+        if (events[i].events & EPOLLOUT) flush(session);
+        if (events[i].events & EPOLLIN) on_readable(session);
+    }
+
+    for (int fd : to_close_) close_session(fd);
+    to_close_.clear();
+    return true;
+}
+
+void FixGateway::accept_clients() {
+    while (true) {
+        int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                spdlog::warn("[FIX] accept failed: {}", std::strerror(errno));
+            }
+            return;
+        }
+        int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev);
+
+        auto& session = sessions_[fd];
+        session.fd = fd;
+        session.last_in = session.last_out = Clock::now();
+        spdlog::debug("[FIX] connection accepted fd={}", fd);
+    }
+}
+
+void FixGateway::on_readable(Session& session) {
+    char buf[16 * 1024];
+    while (true) {
+        ssize_t n = ::recv(session.fd, buf, sizeof(buf), 0);
+        if (n > 0) {
+            session.in.append(buf, static_cast<size_t>(n));
+            session.last_in = Clock::now();
+            session.test_request_sent = false;
+            continue;
+        }
+        if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            to_close_.push_back(session.fd);
+        }
+        break;
+    }
+
+    while (!session.closing && session.in_offset < session.in.size()) {
+        std::string_view pending(session.in.data() + session.in_offset,
+                                 session.in.size() - session.in_offset);
+        size_t consumed = 0;
+        auto status = parse_fix(pending, view_, consumed);
+
+        if (status == FixParseStatus::Incomplete) break;
+        if (status == FixParseStatus::BadBeginString || status == FixParseStatus::BadBodyLength) {
+            spdlog::warn("[FIX] framing error from {}, disconnecting",
+                         session.client_id.empty() ? "unknown peer" : session.client_id);
+            to_close_.push_back(session.fd);
+            return;
+        }
+
+        session.in_offset += consumed;
+        if (status == FixParseStatus::BadChecksum) {
+            // Garbled messages are ignored, as if never received
+            spdlog::warn("[FIX] checksum mismatch from {}, message dropped", session.client_id);
+            continue;
+        }
+        if (status == FixParseStatus::Malformed) {
+            std::string body;
+            add_field(body, "45", "0");
+            add_field(body, "58", "Malformed tag=value field");
+            send_session(session, "3", body);
+            continue;
+        }
+        on_message(session, view_);
+    }
+
+    // Compact once per read rather than per message
+    session.in.erase(0, session.in_offset);
+    session.in_offset = 0;
+    if (session.in.size() > kMaxPendingInput) {
+        spdlog::warn("[FIX] oversized message from {}, disconnecting", session.client_id);
+        to_close_.push_back(session.fd);
+    }
+}
+
+void FixGateway::on_message(Session& session, const FixMessageView& view) {
+    auto msg_type = view.msg_type();
+
+    if (!session.logged_on) {
+        if (msg_type != "A") {
+            logout(session, "First message must be Logon");
+            return;
+        }
+        auto peer = view.get(49);
+        if (peer.empty() || view.get(56) != comp_id_) {
+            logout(session, "Unknown SenderCompID/TargetCompID");
+            return;
+        }
+        session.peer_comp_id.assign(peer);
+        session.client_id = "FIX:" + session.peer_comp_id;
+        session.logged_on = true;
+    }
+
+    // Sequence check; resend requests are not supported, so gaps are only logged
+    size_t seq = 0;
+    auto seq_str = view.get(34);
+    std::from_chars(seq_str.data(), seq_str.data() + seq_str.size(), seq);
+    if (seq < session.next_in_seq && view.get(43) != "Y") {
+        logout(session, "MsgSeqNum too low");
+        return;
+    }
+    if (seq > session.next_in_seq) {
+        spdlog::warn("[FIX] {} sequence gap: expected {} got {}",
+                     session.client_id, session.next_in_seq, seq);
+    }
+    if (seq >= session.next_in_seq) session.next_in_seq = seq + 1;
+
+    if (msg_type == "A") {
+        std::string body;
+        add_field(body, "98", "0");
+        add_field(body, "108", std::to_string(heartbeat_interval_s_));
+        send_session(session, "A", body);
+        spdlog::info("[FIX] {} logged on", session.client_id);
+        return;
+    }
+    if (msg_type == "5") {
+        logout(session, {});
+        spdlog::info("[FIX] {} logged out", session.client_id);
+        return;
+    }
+    if (msg_type == "0") {
+        return;
+    }
+    if (msg_type == "1") {
+        std::string body;
+        add_field(body, "112", view.get(112));
+        send_session(session, "0", body);
+        return;
+    }
+
+    auto error = fix_to_proto(view, msg_);
+    if (!error.empty()) {
+        std::string body;
+        add_field(body, "45", seq_str);
+        add_field(body, "58", error);
+        add_field(body, "373", msg_.body_case() == fix::FixMessage::BODY_NOT_SET ? "11" : "1");
+        send_session(session, "3", body);
+        return;
+    }
+
+    if (handler_) {
+        for (const auto& response : handler_(session.client_id, msg_)) {
+            send_app(session, response);
+        }
+    }
+}
+
+void FixGateway::send_session(Session& session, std::string_view msg_type, std::string_view body) {
+    build_fix(msg_type, comp_id_, session.peer_comp_id, session.next_out_seq++, body, wire_);
+    session.out.append(wire_);
+    session.last_out = Clock::now();
+    flush(session);
+}
+
+void FixGateway::logout(Session& session, std::string_view text) {
+    session.closing = true;  // flush() closes the socket once the Logout is written
+    std::string body;
+    if (!text.empty()) add_field(body, "58", text);
+    send_session(session, "5", body);
+}
+
+bool FixGateway::send(const std::string& client_id, const fix::FixMessage& msg) {
+    for (auto& [fd, session] : sessions_) {
+        if (session.logged_on && !session.closing && session.client_id == client_id) {
+            send_app(session, msg);
+            return true;
+        }
+    }
+    return false;
+}
+
+void FixGateway::send_app(Session& session, const fix::FixMessage& msg) {
+    if (!proto_to_fix(msg, comp_id_, session.peer_comp_id, session.next_out_seq, wire_)) {
+        spdlog::warn("[FIX] no tag=value mapping for response to {}", session.client_id);
+        return;
+    }
+    ++session.next_out_seq;
+    session.out.append(wire_);
+    session.last_out = Clock::now();
+    flush(session);
+}
+
+void FixGateway::flush(Session& session) {
+    size_t sent = 0;
+    while (sent < session.out.size()) {
+        ssize_t n = ::send(session.fd, session.out.data() + sent, session.out.size() - sent,
+                           MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            to_close_.push_back(session.fd);
+            session.out.clear();
+            return;
+        }
+        break;
+    }
+    session.out.erase(0, sent);
+
+    bool want_write = !session.out.empty();
+    if (want_write != session.want_write) {
+        epoll_event ev{};
+        ev.events = EPOLLIN | (want_write ? EPOLLOUT : 0u);
+        ev.data.fd = session.fd;
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, session.fd, &ev);
+        session.want_write = want_write;
+    }
+    if (!want_write && session.closing) {
+        to_close_.push_back(session.fd);
+    }
+}
+
+void FixGateway::check_heartbeats(Clock::time_point now) {
+    auto interval = std::chrono::seconds(heartbeat_interval_s_);
+    auto grace = std::chrono::duration_cast<Clock::duration>(interval * 1.2);
+    for (auto& [fd, session] : sessions_) {
+        if (session.closing) continue;
+        auto silence = now - session.last_in;
+        if (silence >= 2 * grace) {
+            spdlog::warn("[FIX] {} silent for {}s, disconnecting",
+                         session.client_id.empty() ? "unknown peer" : session.client_id,
+                         std::chrono::duration_cast<std::chrono::seconds>(silence).count());
+            to_close_.push_back(fd);
+            continue;
+        }
+        if (!session.logged_on) continue;
+        if (silence >= grace && !session.test_request_sent) {
+            std::string body;
+            add_field(body, "112", "TEST-" + std::to_string(session.next_out_seq));
+            send_session(session, "1", body);
+            session.test_request_sent = true;
+        } else if (now - session.last_out >= interval) {
+            send_session(session, "0", {});
+        }
+    }
+}
+
+void FixGateway::close_session(int fd) {
+    auto it = sessions_.find(fd);
+    if (it == sessions_.end()) return;  // already closed this cycle
+    spdlog::debug("[FIX] connection closed fd={} client={}", fd, it->second.client_id);
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    bool notify = it->second.logged_on && disconnect_handler_;
+    std::string client_id = std::move(it->second.client_id);
+    sessions_.erase(it);
+    if (notify) disconnect_handler_(client_id);
+}
+
+}  // namespace tradecore::messaging
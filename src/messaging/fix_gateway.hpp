@@ -0,0 +1,110 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fix_messages.pb.h>
+#include "messaging/fix_codec.hpp"
+
+namespace tradecore::messaging {
+
+/// FIX 4.4 tag=value acceptor over plain TCP. Handles the session layer
+/// (Logon, Logout, Heartbeat, TestRequest, sequence numbers) itself and hands
+/// application messages, translated to fix::FixMessage, to the same handler
+/// the ZMQ server uses. Responses go back as tag=value on the same session.
+///
+/// All sockets are registered with one epoll instance; poll_fd() exposes it
+/// so the gateway can be driven from another event loop (see ZmqServer::watch_fd).
+///
+/// A periodic timerfd in the same epoll set drives the heartbeat checks. A
+/// session that has sent nothing for one HeartBtInt gets a Heartbeat. A peer
+/// that has been silent for 1.2 HeartBtInt gets a TestRequest. If it is still
+/// silent another 1.2 HeartBtInt later, the connection is closed, which runs
+/// the disconnect handler. That catches half-open TCP sessions. A connection
+/// that never logs on is closed after the same total silence.
+class FixGateway {
+public:
+    using MessageHandler = std::function<std::vector<fix::FixMessage>(
+        const std::string& client_id, const fix::FixMessage& msg)>;
+
+    /// Listen on port (0 picks an ephemeral port, see port()).
+    /// heartbeat_interval_s is the HeartBtInt sent in Logon; 0 disables heartbeats.
+    explicit FixGateway(uint16_t port = 9878, std::string comp_id = "TRADECORE",
+                        int heartbeat_interval_s = 30);
+    ~FixGateway();
+
+    FixGateway(const FixGateway&) = delete;
+    FixGateway& operator=(const FixGateway&) = delete;
+
+    void set_handler(MessageHandler handler);
+
+    /// Called with the client_id of a logged-on session once its connection
+    /// closes, whether by Logout, error or the peer going away.
+    using DisconnectHandler = std::function<void(const std::string& client_id)>;
+    void set_disconnect_handler(DisconnectHandler handler);
+
+    /// Readable whenever any gateway socket has work for poll_once().
+    int poll_fd() const { return epoll_fd_; }
+
+    uint16_t port() const { return port_; }
+
+    /// Accept connections and process whatever input is pending.
+    /// Returns true if any event was handled.
+    bool poll_once(int timeout_ms = 0);
+
+    size_t session_count() const { return sessions_.size(); }
+
+    /// Send an unsolicited application message to a logged-on session by its
+    /// client_id. Returns false if no such session is connected.
+    bool send(const std::string& client_id, const fix::FixMessage& msg);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Session {
+        int fd = -1;
+        Clock::time_point last_in;     // last bytes received
+        Clock::time_point last_out;    // last message sent
+        bool test_request_sent = false;
+        std::string in;
+        size_t in_offset = 0;          // parsed prefix of `in`
+        std::string out;
+        std::string peer_comp_id;      // SenderCompID from the client's Logon
+        std::string client_id;         // "FIX:<peer_comp_id>", passed to the handler
+        uint64_t next_out_seq = 1;
+        uint64_t next_in_seq = 1;
+        bool logged_on = false;
+        bool closing = false;          // close once `out` drains
+        bool want_write = false;
+    };
+
+    void accept_clients();
+    void on_readable(Session& session);
+    void on_message(Session& session, const FixMessageView& view);
+    void send_session(Session& session, std::string_view msg_type, std::string_view body);
+    void logout(Session& session, std::string_view text);
+    void send_app(Session& session, const fix::FixMessage& msg);
+    void flush(Session& session);
+    void close_session(int fd);
+    void check_heartbeats(Clock::time_point now);
+
+    int listen_fd_ = -1;
+    int epoll_fd_ = -1;
+    int timer_fd_ = -1;         // heartbeat tick; -1 when heartbeats are off
+    uint16_t port_ = 0;
+    std::string comp_id_;
+    int heartbeat_interval_s_;
+    MessageHandler handler_;
+    DisconnectHandler disconnect_handler_;
+    std::unordered_map<int, Session> sessions_;
+    std::vector<int> to_close_;
+    FixMessageView view_;       // reused per inbound message
+    fix::FixMessage msg_;       // reused translation target
+    std::string wire_;          // reused outbound frame
+};
+
+}  // namespace tradecore::messaging
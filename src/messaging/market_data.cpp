@@ -0,0 +1,144 @@
+#include "messaging/market_data.hpp"
+
+#include <algorithm>
+
+#include "messaging/protocol.hpp"
+
+namespace tradecore::messaging {
+
+namespace {
+
+fix::MDEntryType entry_type(matching::BookSide side) {
+    return side == matching::BookSide::Bid ? fix::MD_ENTRY_TYPE_BID : fix::MD_ENTRY_TYPE_OFFER;
+}
+
+fix::MDUpdateAction update_action(matching::LevelAction action) {
+    switch (action) {
+        case matching::LevelAction::New:    return fix::MD_UPDATE_ACTION_NEW;
+        case matching::LevelAction::Change: return fix::MD_UPDATE_ACTION_CHANGE;
+        case matching::LevelAction::Delete: return fix::MD_UPDATE_ACTION_DELETE;
+    }
+    return fix::MD_UPDATE_ACTION_UNSPECIFIED;
+}
+
+void fill_top_of_book(fix::TopOfBook* tob, const matching::OrderBook& book) {
+    if (const auto* bid = book.best_displayed_level(matching::BookSide::Bid)) {
+        tob->set_bid_px(bid->price.to_double());
+        tob->set_bid_size(bid->displayed_quantity().to_double());
+    }
+    if (const auto* ask = book.best_displayed_level(matching::BookSide::Ask)) {
+        tob->set_offer_px(ask->price.to_double());
+        tob->set_offer_size(ask->displayed_quantity().to_double());
+    }
+}
+
+fix::FixMessage make_md_envelope(uint64_t rpt_seq) {
+    fix::FixMessage msg;
+    msg.set_sender_comp_id("TRADECORE");
+    msg.set_msg_seq_num(std::to_string(rpt_seq));
+    msg.set_sending_time(current_timestamp());
+    return msg;
+}
+
+}  // namespace
+
+fix::FixMessage make_md_incremental(
+    const std::string& symbol,
+    uint64_t rpt_seq,
+    const matching::OrderBook& book,
+    const std::vector<matching::LevelUpdate>& updates) {
+
+    auto msg = make_md_envelope(rpt_seq);
+    auto* inc = msg.mutable_market_data_incremental();
+    inc->set_symbol(symbol);
+    inc->set_rpt_seq(rpt_seq);
+
+    for (const auto& u : updates) {
+        auto* entry = inc->add_entries();
+        entry->set_update_action(update_action(u.action));
+        entry->set_entry_type(entry_type(u.side));
+        entry->set_price(u.price.to_double());
+        entry->set_size(u.quantity.to_double());
+        entry->set_number_of_orders(u.order_count);
+    }
+    fill_top_of_book(inc->mutable_top_of_book(), book);
+
+    return msg;
+}
+
+fix::FixMessage make_md_snapshot(
+    const std::string& symbol,
+    uint64_t rpt_seq,
+    const matching::OrderBook& book,
+    size_t levels) {
+
+    auto msg = make_md_envelope(rpt_seq);
+    auto* snap = msg.mutable_market_data_snapshot();
+    snap->set_symbol(symbol);
+    snap->set_rpt_seq(rpt_seq);
+
+    for (auto side : {matching::BookSide::Bid, matching::BookSide::Ask}) {
+        for (const auto& level : book.get_depth(side, levels)) {
+            auto* entry = snap->add_entries();
+            entry->set_entry_type(entry_type(side));
+            entry->set_price(level.price.to_double());
+            entry->set_size(level.quantity.to_double());
+            entry->set_number_of_orders(level.order_count);
+        }
+    }
+    fill_top_of_book(snap->mutable_top_of_book(), book);
+
+    return msg;
+}
+
+fix::FixMessage make_md_snapshot(
+    const std::string& symbol,
+    const matching::BookSnapshot& book,
+    size_t levels) {
+
+    auto msg = make_md_envelope(book.version);
+    auto* snap = msg.mutable_market_data_snapshot();
+    snap->set_symbol(symbol);
+    snap->set_rpt_seq(book.version);
+
+    auto add = [&](matching::BookSide side, const matching::DepthEntry* levels_of, uint32_t n) {
+        for (size_t i = 0; i < std::min<size_t>(n, levels); ++i) {
+            auto* entry = snap->add_entries();
+            entry->set_entry_type(entry_type(side));
+            entry->set_price(levels_of[i].price.to_double());
+            entry->set_size(levels_of[i].quantity.to_double());
+            entry->set_number_of_orders(levels_of[i].order_count);
+        }
+    };
+    add(matching::BookSide::Bid, book.bids, book.bid_levels);
+    add(matching::BookSide::Ask, book.asks, book.ask_levels);
+
+    auto* tob = snap->mutable_top_of_book();
+    if (const auto* bid = book.best_bid()) {
+        tob->set_bid_px(bid->price.to_double());
+        tob->set_bid_size(bid->quantity.to_double());
+    }
+    if (const auto* ask = book.best_ask()) {
+        tob->set_offer_px(ask->price.to_double());
+        tob->set_offer_size(ask->quantity.to_double());
+    }
+
+    return msg;
+}
+
+fix::FixMessage make_md_top_of_book(const BboSnapshot& bbo, uint64_t rpt_seq) {
+    auto msg = make_md_envelope(rpt_seq);
+    auto* inc = msg.mutable_market_data_incremental();
+    inc->set_symbol(*bbo.symbol);
+    inc->set_rpt_seq(rpt_seq);
+
+    auto* tob = inc->mutable_top_of_book();
+    tob->set_bid_px(bbo.bid_px);
+    tob->set_bid_size(bbo.bid_size);
+    tob->set_offer_px(bbo.ask_px);
+    tob->set_offer_size(bbo.ask_size);
+
+    return msg;
+}
+
+}  // namespace tradecore::messaging
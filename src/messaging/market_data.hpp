@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <fix_messages.pb.h>
+#include "matching/order_book.hpp"
+#include "messaging/bbo_conflator.hpp"
+
+namespace tradecore::messaging {
+
+/// Build an incremental L2 refresh from the level updates recorded by a book.
+fix::FixMessage make_md_incremental(
+    const std::string& symbol,
+    uint64_t rpt_seq,
+    const matching::OrderBook& book,
+    const std::vector<matching::LevelUpdate>& updates);
+
+/// Build a full L2 snapshot with up to `levels` levels per side.
+fix::FixMessage make_md_snapshot(
+    const std::string& symbol,
+    uint64_t rpt_seq,
+    const matching::OrderBook& book,
+    size_t levels);
+
+/// Build a full L2 snapshot from a published book copy (up to `levels` a
+/// side), sequenced by its version.
+fix::FixMessage make_md_snapshot(
+    const std::string& symbol,
+    const matching::BookSnapshot& book,
+    size_t levels);
+
+/// Build a top-of-book only refresh from a conflated BBO slot.
+fix::FixMessage make_md_top_of_book(const BboSnapshot& bbo, uint64_t rpt_seq);
+
+}  // namespace tradecore::messaging
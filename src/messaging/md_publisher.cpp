@@ -0,0 +1,82 @@
+#include "messaging/md_publisher.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include "messaging/market_data.hpp"
+
+namespace tradecore::messaging {
+
+MarketDataPublisher::MarketDataPublisher(const std::string& bind_address,
+                                         size_t snapshot_depth,
+                                         std::chrono::milliseconds snapshot_interval)
+    : ctx_(1), socket_(ctx_, zmq::socket_type::pub),
+      snapshot_depth_(snapshot_depth), snapshot_interval_(snapshot_interval),
+      last_snapshot_(std::chrono::steady_clock::now()) {
+    socket_.bind(bind_address);
+}
+
+MarketDataPublisher::~MarketDataPublisher() {
+    if (conflated_socket_) conflated_socket_->close();
+    socket_.close();
+    ctx_.close();
+}
+
+void MarketDataPublisher::publish_updates(matching::MatchingEngine& engine) {
+    engine.drain_book_updates(
+        [&](const std::string& symbol, const matching::OrderBook& book,
+            const std::vector<matching::LevelUpdate>& updates) {
+            conflator_.update(symbol, book);
+            send(socket_, symbol, make_md_incremental(symbol, ++rpt_seq_[symbol], book, updates));
+        });
+}
+
+void MarketDataPublisher::publish_snapshots(const matching::MatchingEngine& engine) {
+    engine.for_each_book([&](const std::string& symbol, const matching::OrderBook& book) {
+        send(socket_, symbol, make_md_snapshot(symbol, ++rpt_seq_[symbol], book, snapshot_depth_));
+    });
+    last_snapshot_ = std::chrono::steady_clock::now();
+}
+
+void MarketDataPublisher::on_tick(matching::MatchingEngine& engine) {
+    publish_updates(engine);
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_snapshot_ >= snapshot_interval_) {
+        publish_snapshots(engine);
+    }
+    if (conflated_socket_ && now - last_conflated_ >= conflate_interval_) {
+        publish_conflated();
+    }
+}
+
+void MarketDataPublisher::enable_conflated_feed(const std::string& bind_address,
+                                                std::chrono::milliseconds interval) {
+    conflated_socket_ = std::make_unique<zmq::socket_t>(ctx_, zmq::socket_type::pub);
+    // One message per symbol per interval; anything a consumer cannot take is dropped
+    conflated_socket_->set(zmq::sockopt::sndhwm, 1000);
+    conflated_socket_->bind(bind_address);
+    conflate_interval_ = interval;
+    last_conflated_ = std::chrono::steady_clock::now();
+}
+
+void MarketDataPublisher::publish_conflated() {
+    if (!conflated_socket_) return;
+    conflator_.drain(conflated_cursor_, [&](const BboSnapshot& bbo) {
+        send(*conflated_socket_, *bbo.symbol, make_md_top_of_book(bbo, ++conflated_seq_));
+    });
+    last_conflated_ = std::chrono::steady_clock::now();
+}
+
+void MarketDataPublisher::send(zmq::socket_t& socket, const std::string& symbol,
+                               const fix::FixMessage& msg) {
+    msg.SerializeToString(&buffer_);
+    try {
+        // PUB drops at the high-water mark instead of blocking the matching thread
+        socket.send(zmq::buffer(symbol), zmq::send_flags::sndmore | zmq::send_flags::dontwait);
+        socket.send(zmq::buffer(buffer_), zmq::send_flags::dontwait);
+        ++messages_published_;
+    } catch (const zmq::error_t& e) {
+        spdlog::warn("[MD] Failed to publish {}: {}", symbol, e.what());
+    }
+}
+
+}  // namespace tradecore::messaging
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <zmq.hpp>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include <fix_messages.pb.h>
+#include "matching/matching_engine.hpp"
+#include "messaging/bbo_conflator.hpp"
+
+namespace tradecore::messaging {
+
+/// Publishes L2 market data on a ZMQ PUB socket. Each message is two frames:
+/// the symbol (subscription topic) and a serialized FixMessage carrying either
+/// an incremental refresh or a periodic full snapshot.
+///
+/// Every published book change also refreshes a conflated BBO slot per symbol.
+/// Slow consumers can read those slots in-process through conflator(), or
+/// subscribe to the optional conflated PUB feed, which sends at most one
+/// top-of-book message per changed symbol per conflation interval.
+class MarketDataPublisher {
+public:
+    explicit MarketDataPublisher(const std::string& bind_address = "tcp://*:5556",
+                                 size_t snapshot_depth = 10,
+                                 std::chrono::milliseconds snapshot_interval = std::chrono::milliseconds(1000));
+    ~MarketDataPublisher();
+
+    MarketDataPublisher(const MarketDataPublisher&) = delete;
+    MarketDataPublisher& operator=(const MarketDataPublisher&) = delete;
+
+    /// Publish incremental refreshes for every book changed since the last call.
+    void publish_updates(matching::MatchingEngine& engine);
+
+    /// Publish a full snapshot of every book.
+    void publish_snapshots(const matching::MatchingEngine& engine);
+
+    /// Publish pending updates, plus snapshots once the snapshot interval elapses
+    /// and conflated top-of-book once the conflation interval elapses.
+    void on_tick(matching::MatchingEngine& engine);
+
+    /// Start the conflated top-of-book feed on a second PUB socket.
+    void enable_conflated_feed(const std::string& bind_address,
+                               std::chrono::milliseconds interval = std::chrono::milliseconds(250));
+
+    /// Send top-of-book for every symbol whose BBO changed since the last call.
+    void publish_conflated();
+
+    /// Latest-BBO slots; in-process readers drain them with their own cursor.
+    const BboConflator& conflator() const { return conflator_; }
+
+    uint64_t messages_published() const { return messages_published_; }
+
+private:
+    void send(zmq::socket_t& socket, const std::string& symbol, const fix::FixMessage& msg);
+
+    zmq::context_t ctx_;
+    zmq::socket_t socket_;
+    size_t snapshot_depth_;
+    std::chrono::milliseconds snapshot_interval_;
+    std::chrono::steady_clock::time_point last_snapshot_;
+    std::unordered_map<std::string, uint64_t> rpt_seq_;  // per-symbol sequence (tag 83)
+    std::string buffer_;
+    uint64_t messages_published_ = 0;
+
+    BboConflator conflator_;
+    BboConflator::Cursor conflated_cursor_;
+    std::unique_ptr<zmq::socket_t> conflated_socket_;
+    std::chrono::milliseconds conflate_interval_{250};
+    std::chrono::steady_clock::time_point last_conflated_;
+    uint64_t conflated_seq_ = 0;
+};
+
+}  // namespace tradecore::messaging
@@ -0,0 +1,141 @@
+#include "messaging/position_publisher.hpp"
+
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+#include "messaging/protocol.hpp"
+
+namespace tradecore::messaging {
+
+PositionPublisher::PositionPublisher(booking::BookKeeper& book_keeper,
+                                     const booking::MarkToMarket& valuation,
+                                     std::chrono::milliseconds interval)
+    : book_keeper_(book_keeper), valuation_(valuation), interval_(interval),
+      last_publish_(std::chrono::steady_clock::now()) {}
+
+fix::FixMessage PositionPublisher::handle_request(const std::string& session,
+                                                  const fix::FixMessage& msg) {
+    auto response = make_position_report(msg, generate_uuid());
+    const auto& req = msg.position_request();
+
+    // A new request under the same PosReqID replaces (or, with 263=2, ends) the old one
+    auto same = [&](const Subscription& sub) {
+        return sub.session == session &&
+               sub.request.position_request().pos_req_id() == req.pos_req_id();
+    };
+    size_t before = subscriptions_.size();
+    subscriptions_.erase(std::remove_if(subscriptions_.begin(), subscriptions_.end(), same),
+                         subscriptions_.end());
+    bool changed = subscriptions_.size() != before;
+
+    if (req.subscription_request_type() != fix::SUBSCRIPTION_DISABLE) {
+        const auto& ledger = book_keeper_.ledger();
+        const auto* node = find_node(req);
+        if (node) {
+            auto* pr = response.mutable_position_report();
+            for (uint32_t row : node->rows) add_entry(*pr, ledger.row(row));
+        }
+        if (req.subscription_request_type() == fix::SUBSCRIPTION_SNAPSHOT_PLUS_UPDATES) {
+            auto& sub = subscriptions_.emplace_back();
+            sub.session = session;
+            sub.request = msg;
+            if (node) {
+                sub.node = ledger.index_of(*node);
+            } else {
+                unresolved_ = true;
+            }
+            changed = true;
+            spdlog::info("[POS] {} subscribed to positions ({})", session, req.pos_req_id());
+        }
+    }
+    if (changed) reindex();
+    return response;
+}
+
+void PositionPublisher::unsubscribe(const std::string& session) {
+    size_t before = subscriptions_.size();
+    subscriptions_.erase(std::remove_if(subscriptions_.begin(), subscriptions_.end(),
+                                        [&](const Subscription& s) { return s.session == session; }),
+                         subscriptions_.end());
+    if (subscriptions_.size() != before) reindex();
+}
+
+void PositionPublisher::on_tick(std::chrono::steady_clock::time_point now) {
+    if (now - last_publish_ < interval_) return;
+    last_publish_ = now;
+    publish();
+}
+
+void PositionPublisher::publish() {
+    if (unresolved_) resolve();
+
+    // Changes are drained even with no subscribers: a later subscriber starts
+    // from a snapshot
+    book_keeper_.drain_changed([&](uint32_t node, const booking::Position& pos) {
+        auto [first, last] = by_node_.equal_range(node);
+        for (auto it = first; it != last; ++it) {
+            auto& sub = subscriptions_[it->second];
+            if (!sub.update.has_position_report()) {
+                sub.update = make_position_report(sub.request, generate_uuid());
+                sub.update.mutable_position_report()->set_unsolicited(true);
+            }
+            add_entry(*sub.update.mutable_position_report(), pos);
+        }
+    });
+
+    for (auto& sub : subscriptions_) {
+        if (!sub.update.has_position_report()) continue;
+        if (sink_) sink_(sub.session, sub.update);
+        sub.update.Clear();
+    }
+}
+
+const booking::Ledger::Node* PositionPublisher::find_node(const fix::PositionRequest& req) const {
+    const auto& ledger = book_keeper_.ledger();
+    if (req.account().empty()) return &ledger.firm();
+    if (req.text().empty()) return ledger.account(req.account());
+    return ledger.strategy(req.account(), req.text());
+}
+
+void PositionPublisher::resolve() {
+    const auto& ledger = book_keeper_.ledger();
+    unresolved_ = false;
+    bool found = false;
+    for (auto& sub : subscriptions_) {
+        if (sub.node != kUnresolved) continue;
+        if (const auto* node = find_node(sub.request.position_request())) {
+            sub.node = ledger.index_of(*node);
+            found = true;
+        } else {
+            unresolved_ = true;
+        }
+    }
+    if (found) reindex();
+}
+
+void PositionPublisher::reindex() {
+    by_node_.clear();
+    for (size_t i = 0; i < subscriptions_.size(); ++i) {
+        if (subscriptions_[i].node != kUnresolved) by_node_.emplace(subscriptions_[i].node, i);
+    }
+}
+
+void PositionPublisher::add_entry(fix::PositionReport& report,
+                                  const booking::Position& pos) const {
+    auto* entry = report.add_positions();
+    entry->mutable_instrument()->set_symbol(pos.symbol);
+    entry->mutable_instrument()->set_security_type(fix::SECURITY_TYPE_COMMON_STOCK);
+    entry->mutable_instrument()->set_currency(pos.currency);
+    if (pos.quantity >= core::Qty{}) {
+        entry->set_long_qty(pos.quantity.to_double());
+    } else {
+        entry->set_short_qty((-pos.quantity).to_double());
+    }
+    entry->set_avg_price(pos.avg_price);
+    // Both PnL figures in the base currency
+    entry->set_realized_pnl(pos.realized_pnl_base);
+    entry->set_unrealized_pnl(valuation_.unrealized_pnl(pos));
+}
+
+}  // namespace tradecore::messaging
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fix_messages.pb.h>
+#include "booking/book_keeper.hpp"
+#include "booking/mark_to_market.hpp"
+
+namespace tradecore::messaging {
+
+/// Answers PositionRequests straight from the Ledger. A plain request (tag 263
+/// = 0) gets one snapshot. A subscription (263 = 1) gets the same snapshot,
+/// then at most one unsolicited PositionReport per publish interval listing
+/// only the positions that changed, however many fills touched them. 263 = 2
+/// ends a subscription.
+///
+/// Pushes come from the Ledger's change list, so each publish costs
+/// O(changed positions), not O(all positions) per subscriber.
+class PositionPublisher {
+public:
+    using Sink = std::function<void(const std::string& session, const fix::FixMessage& report)>;
+
+    PositionPublisher(booking::BookKeeper& book_keeper, const booking::MarkToMarket& valuation,
+                      std::chrono::milliseconds interval = std::chrono::milliseconds(1000));
+
+    /// Where pushed updates go (the owning session's connection).
+    void set_sink(Sink sink) { sink_ = std::move(sink); }
+
+    /// Reply to a PositionRequest: firm-wide, one account, or one strategy
+    /// within an account (tag 58), per the request's account and text.
+    fix::FixMessage handle_request(const std::string& session, const fix::FixMessage& msg);
+
+    /// Drop every subscription held by session (disconnect).
+    void unsubscribe(const std::string& session);
+
+    /// Push pending changes once the interval has elapsed since the last push.
+    void on_tick(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+    /// Push pending changes now: one report per subscription with changes.
+    void publish();
+
+    size_t subscription_count() const { return subscriptions_.size(); }
+
+private:
+    static constexpr uint32_t kUnresolved = std::numeric_limits<uint32_t>::max();
+
+    struct Subscription {
+        std::string session;
+        fix::FixMessage request;
+        uint32_t node = kUnresolved;  // until the account/strategy first trades
+        fix::FixMessage update;       // being filled by the current publish
+    };
+
+    const booking::Ledger::Node* find_node(const fix::PositionRequest& req) const;
+    void resolve();
+    void reindex();
+    void add_entry(fix::PositionReport& report, const booking::Position& pos) const;
+
+    booking::BookKeeper& book_keeper_;
+    const booking::MarkToMarket& valuation_;
+    std::chrono::milliseconds interval_;
+    std::chrono::steady_clock::time_point last_publish_;
+    Sink sink_;
+
+    std::vector<Subscription> subscriptions_;
+    std::unordered_multimap<uint32_t, size_t> by_node_;  // ledger node -> subscription
+    bool unresolved_ = false;
+};
+
+}  // namespace tradecore::messaging
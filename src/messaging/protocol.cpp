@@ -18,6 +18,27 @@ fix::FixMessage deserialize(const void* data, size_t size) {
     return msg;
 }
 
+namespace {
+
+// Order details echoed on reports, from a NewOrderSingle or a replace request
+void copy_order_fields(const fix::FixMessage& request, fix::ExecutionReport* er) {
+    if (request.has_order_cancel_replace_request()) {
+        const auto& rep = request.order_cancel_replace_request();
+        er->set_cl_ord_id(rep.cl_ord_id());
+        *er->mutable_instrument() = rep.instrument();
+        er->set_side(rep.side());
+        er->set_order_qty(rep.order_qty());
+        return;
+    }
+    const auto& nos = request.new_order_single();
+    er->set_cl_ord_id(nos.cl_ord_id());
+    *er->mutable_instrument() = nos.instrument();
+    er->set_side(nos.side());
+    er->set_order_qty(nos.order_qty());
+}
+
+}  // namespace
+
 fix::FixMessage make_execution_report_new(
     const fix::FixMessage& request,
     const std::string& order_id) {
@@ -57,8 +78,6 @@ fix::FixMessage make_execution_report_fill(
     double cum_qty,
     double commission) {
 
-    const auto& nos = request.new_order_single();
-
     fix::FixMessage msg;
     msg.set_sender_comp_id("TRADECORE");
     msg.set_target_comp_id(request.sender_comp_id());
@@ -67,13 +86,10 @@ fix::FixMessage make_execution_report_fill(
 
     auto* er = msg.mutable_execution_report();
     er->set_order_id(order_id);
-    er->set_cl_ord_id(nos.cl_ord_id());
+    copy_order_fields(request, er);
     er->set_exec_id(exec_id);
     er->set_exec_type(leaves_qty == 0.0 ? fix::EXEC_TYPE_FILL : fix::EXEC_TYPE_PARTIAL_FILL);
     er->set_ord_status(leaves_qty == 0.0 ? fix::ORD_STATUS_FILLED : fix::ORD_STATUS_PARTIALLY_FILLED);
-    *er->mutable_instrument() = nos.instrument();
-    er->set_side(nos.side());
-    er->set_order_qty(nos.order_qty());
     er->set_last_px(last_px);
     er->set_last_qty(last_qty);
     er->set_leaves_qty(leaves_qty);
@@ -114,6 +130,80 @@ fix::FixMessage make_execution_report_cancelled(
     return msg;
 }
 
+fix::FixMessage make_execution_report_remainder_cancelled(
+    const fix::FixMessage& request,
+    const std::string& order_id,
+    double cum_qty) {
+
+    fix::FixMessage msg;
+    msg.set_sender_comp_id("TRADECORE");
+    msg.set_target_comp_id(request.sender_comp_id());
+    msg.set_msg_seq_num(generate_uuid());
+    msg.set_sending_time(current_timestamp());
+
+    auto* er = msg.mutable_execution_report();
+    er->set_order_id(order_id);
+    copy_order_fields(request, er);
+    er->set_exec_id(generate_uuid());
+    er->set_exec_type(fix::EXEC_TYPE_CANCELLED);
+    er->set_ord_status(fix::ORD_STATUS_CANCELLED);
+    er->set_leaves_qty(0.0);
+    er->set_cum_qty(cum_qty);
+    er->set_transact_time(current_timestamp());
+
+    return msg;
+}
+
+fix::FixMessage make_execution_report_replaced(
+    const fix::FixMessage& request,
+    const std::string& order_id,
+    double leaves_qty,
+    double cum_qty) {
+
+    fix::FixMessage msg;
+    msg.set_sender_comp_id("TRADECORE");
+    msg.set_target_comp_id(request.sender_comp_id());
+    msg.set_msg_seq_num(generate_uuid());
+    msg.set_sending_time(current_timestamp());
+
+    auto* er = msg.mutable_execution_report();
+    er->set_order_id(order_id);
+    copy_order_fields(request, er);
+    er->set_orig_cl_ord_id(request.order_cancel_replace_request().orig_cl_ord_id());
+    er->set_exec_id(generate_uuid());
+    er->set_exec_type(fix::EXEC_TYPE_REPLACED);
+    er->set_ord_status(cum_qty > 0.0 ? fix::ORD_STATUS_PARTIALLY_FILLED : fix::ORD_STATUS_NEW);
+    er->set_leaves_qty(leaves_qty);
+    er->set_cum_qty(cum_qty);
+    er->set_transact_time(current_timestamp());
+
+    return msg;
+}
+
+fix::FixMessage make_mass_cancel_report(
+    const fix::FixMessage& request,
+    const std::string& report_id,
+    fix::MassCancelResponse response,
+    int total_affected_orders,
+    const std::string& text) {
+
+    fix::FixMessage msg;
+    msg.set_sender_comp_id("TRADECORE");
+    msg.set_target_comp_id(request.sender_comp_id());
+    msg.set_msg_seq_num(generate_uuid());
+    msg.set_sending_time(current_timestamp());
+
+    auto* rpt = msg.mutable_order_mass_cancel_report();
+    rpt->set_cl_ord_id(request.order_mass_cancel_request().cl_ord_id());
+    rpt->set_order_id(report_id);
+    rpt->set_mass_cancel_request_type(request.order_mass_cancel_request().mass_cancel_request_type());
+    rpt->set_mass_cancel_response(response);
+    rpt->set_total_affected_orders(total_affected_orders);
+    if (!text.empty()) rpt->set_text(text);
+
+    return msg;
+}
+
 fix::FixMessage make_reject(
     const fix::FixMessage& request,
     const std::string& reason) {
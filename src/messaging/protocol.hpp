@@ -54,10 +54,29 @@ fix::FixMessage make_execution_report_cancelled(
     const std::string& order_id,
     const std::string& orig_cl_ord_id);
 
+/// Unsolicited cancel of whatever an order did not fill (e.g. an IOC remainder).
+fix::FixMessage make_execution_report_remainder_cancelled(
+    const fix::FixMessage& request,
+    const std::string& order_id,
+    double cum_qty);
+
+fix::FixMessage make_execution_report_replaced(
+    const fix::FixMessage& request,
+    const std::string& order_id,
+    double leaves_qty,
+    double cum_qty);
+
 fix::FixMessage make_reject(
     const fix::FixMessage& request,
     const std::string& reason);
 
+fix::FixMessage make_mass_cancel_report(
+    const fix::FixMessage& request,
+    const std::string& report_id,
+    fix::MassCancelResponse response,
+    int total_affected_orders,
+    const std::string& text = "");
+
 fix::FixMessage make_heartbeat_response(const fix::FixMessage& request);
 
 fix::FixMessage make_position_report(
@@ -0,0 +1,60 @@
+#include "messaging/query_server.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include "messaging/protocol.hpp"
+
+namespace tradecore::messaging {
+
+QueryServer::QueryServer(const std::string& bind_address, const matching::BookSnapshots& books,
+                         const booking::PositionSnapshots& positions)
+    : ctx_(1), socket_(ctx_, zmq::socket_type::router), queries_(books, positions) {
+    socket_.bind(bind_address);
+}
+
+QueryServer::~QueryServer() {
+    stop();
+    socket_.close();
+    ctx_.close();
+}
+
+void QueryServer::start() {
+    if (running_.exchange(true)) return;
+    thread_ = std::thread([this] { run(); });
+}
+
+void QueryServer::stop() {
+    running_ = false;
+    if (thread_.joinable()) thread_.join();
+}
+
+void QueryServer::run() {
+    zmq::pollitem_t item{socket_, 0, ZMQ_POLLIN, 0};
+    while (running_) {
+        // Bounded wait so stop() is seen promptly
+        zmq::poll(&item, 1, std::chrono::milliseconds(100));
+        if (!(item.revents & ZMQ_POLLIN)) continue;
+
+        zmq::message_t identity;
+        while (socket_.recv(identity, zmq::recv_flags::dontwait)) {
+            zmq::message_t empty;
+            (void)socket_.recv(empty, zmq::recv_flags::none);
+            zmq::message_t data;
+            (void)socket_.recv(data, zmq::recv_flags::none);
+
+            fix::FixMessage response;
+            try {
+                response = queries_.answer(deserialize(data.data(), data.size()));
+            } catch (const std::exception& e) {
+                spdlog::error("[QUERY] Error answering query: {}", e.what());
+                response = make_reject(fix::FixMessage{}, "Malformed query");
+            }
+            std::string bytes = serialize(response);
+            socket_.send(identity, zmq::send_flags::sndmore);
+            socket_.send(zmq::message_t{}, zmq::send_flags::sndmore);
+            socket_.send(zmq::buffer(bytes), zmq::send_flags::none);
+        }
+    }
+}
+
+}  // namespace tradecore::messaging
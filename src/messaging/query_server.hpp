@@ -0,0 +1,40 @@
+#pragma once
+
+#include <zmq.hpp>
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "messaging/snapshot_queries.hpp"
+
+namespace tradecore::messaging {
+
+/// Serves read-only queries (see SnapshotQueries) on its own ROUTER socket
+/// and thread. It reads only the published snapshot tables, so a burst of
+/// queries never delays order handling on the dispatch thread. Requests and
+/// replies are single serialized FixMessage frames, as on the order socket.
+class QueryServer {
+public:
+    QueryServer(const std::string& bind_address, const matching::BookSnapshots& books,
+                const booking::PositionSnapshots& positions);
+    ~QueryServer();
+
+    QueryServer(const QueryServer&) = delete;
+    QueryServer& operator=(const QueryServer&) = delete;
+
+    /// Start answering on the query thread.
+    void start();
+    /// Stop and join the query thread.
+    void stop();
+
+private:
+    void run();
+
+    zmq::context_t ctx_;
+    zmq::socket_t socket_;  // used only by the query thread once started
+    SnapshotQueries queries_;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+}  // namespace tradecore::messaging
@@ -0,0 +1,77 @@
+#include "messaging/snapshot_queries.hpp"
+
+#include "booking/book_keeper.hpp"
+#include "messaging/market_data.hpp"
+#include "messaging/protocol.hpp"
+
+namespace tradecore::messaging {
+
+fix::FixMessage SnapshotQueries::answer(const fix::FixMessage& msg) const {
+    if (msg.has_market_data_request()) return answer_depth(msg);
+    if (msg.has_position_request()) return answer_positions(msg);
+    return make_reject(msg, "Query socket serves MarketDataRequest and PositionRequest only");
+}
+
+fix::FixMessage SnapshotQueries::answer_depth(const fix::FixMessage& msg) const {
+    const auto& req = msg.market_data_request();
+    matching::BookSnapshot book;
+    if (!books_.load(req.symbol(), book)) {
+        return make_reject(msg, "No book for symbol: " + req.symbol());
+    }
+    size_t depth = req.market_depth() ? req.market_depth() : matching::BookSnapshot::kLevels;
+    auto response = make_md_snapshot(req.symbol(), book, depth);
+    response.set_target_comp_id(msg.sender_comp_id());
+    response.mutable_market_data_snapshot()->set_md_req_id(req.md_req_id());
+    return response;
+}
+
+fix::FixMessage SnapshotQueries::answer_positions(const fix::FixMessage& msg) const {
+    const auto& req = msg.position_request();
+    if (req.subscription_request_type() != fix::SUBSCRIPTION_SNAPSHOT) {
+        return make_reject(msg, "Position subscriptions are served on the order session");
+    }
+
+    // Keys are "symbol", "account|symbol" or "account|strategy|symbol"; one
+    // level's keys are its prefix followed by a bare symbol
+    std::string prefix;
+    if (!req.account().empty() && req.text().empty()) {
+        prefix = booking::BookKeeper::account_key(req.account(), "");
+    } else if (!req.account().empty()) {
+        prefix = booking::BookKeeper::strategy_key(req.account(), req.text(), "");
+    }
+
+    auto response = make_position_report(msg, generate_uuid());
+    auto* pr = response.mutable_position_report();
+    positions_.for_each([&](const std::string& key, const booking::PositionSnapshot& pos) {
+        if (key.compare(0, prefix.size(), prefix) != 0) return;
+        if (key.find('|', prefix.size()) != std::string::npos) return;
+        std::string symbol = key.substr(prefix.size());
+
+        auto* entry = pr->add_positions();
+        entry->mutable_instrument()->set_symbol(symbol);
+        entry->mutable_instrument()->set_security_type(fix::SECURITY_TYPE_COMMON_STOCK);
+        if (pos.quantity >= core::Qty{}) {
+            entry->set_long_qty(pos.quantity.to_double());
+        } else {
+            entry->set_short_qty((-pos.quantity).to_double());
+        }
+        entry->set_avg_price(pos.avg_price);
+        // Both PnL figures in the base currency
+        entry->set_realized_pnl(pos.realized_pnl_base);
+        double m = mark(symbol);
+        entry->set_unrealized_pnl((m - pos.avg_price) * pos.quantity.to_double() *
+                                  pos.multiplier * pos.fx_rate * (m > 0.0));
+    });
+    return response;
+}
+
+double SnapshotQueries::mark(const std::string& symbol) const {
+    matching::BookSnapshot book;
+    if (!books_.load(symbol, book)) return 0.0;
+    const auto* bid = book.best_bid();
+    const auto* ask = book.best_ask();
+    if (bid && ask) return (bid->price.to_double() + ask->price.to_double()) / 2.0;
+    return book.last_trade.to_double();
+}
+
+}  // namespace tradecore::messaging
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <fix_messages.pb.h>
+#include "booking/position.hpp"
+#include "matching/matching_engine.hpp"
+
+namespace tradecore::messaging {
+
+/// Answers read-only queries from the snapshot tables the matching thread
+/// publishes (MatchingEngine::set_snapshots, BookKeeper::set_snapshots), so
+/// they can be served from another thread without touching matching state.
+///
+/// - MarketDataRequest: the book's published depth, up to tag 264 levels.
+/// - PositionRequest with 263 = 0: firm-wide, one account, or one strategy
+///   within an account (tag 58), as PositionPublisher answers it. Unrealized
+///   PnL is valued at the snapshot's BBO mid, else its last trade.
+///   Subscriptions stay on the order session, which sees every change.
+///
+/// Anything else gets a Reject.
+class SnapshotQueries {
+public:
+    SnapshotQueries(const matching::BookSnapshots& books,
+                    const booking::PositionSnapshots& positions)
+        : books_(books), positions_(positions) {}
+
+    fix::FixMessage answer(const fix::FixMessage& msg) const;
+
+private:
+    fix::FixMessage answer_depth(const fix::FixMessage& msg) const;
+    fix::FixMessage answer_positions(const fix::FixMessage& msg) const;
+    double mark(const std::string& symbol) const;
+
+    const matching::BookSnapshots& books_;
+    const booking::PositionSnapshots& positions_;
+};
+
+}  // namespace tradecore::messaging
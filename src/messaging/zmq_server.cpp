@@ -1,12 +1,17 @@
 #include "messaging/zmq_server.hpp"
 
+#include <algorithm>
+
 #include <spdlog/spdlog.h>
 
+#include "core/metrics.hpp"
+
 namespace tradecore::messaging {
 
 ZmqServer::ZmqServer(const std::string& bind_address)
     : ctx_(1), socket_(ctx_, zmq::socket_type::router) {
     socket_.bind(bind_address);
+    poll_items_.push_back({socket_, 0, ZMQ_POLLIN, 0});
 }
 
 ZmqServer::~ZmqServer() {
@@ -18,45 +23,210 @@ void ZmqServer::set_handler(MessageHandler handler) {
     handler_ = std::move(handler);
 }
 
+void ZmqServer::set_idle_handler(IdleHandler handler) {
+    idle_handler_ = std::move(handler);
+}
+
+void ZmqServer::enable_binary(const instrument::SymbolTable& symbols) {
+    binary_codec_ = std::make_unique<BinaryCodec>(symbols);
+}
+
+WireFormat ZmqServer::wire_format(const std::string& client_id) const {
+    auto it = clients_.find(client_id);
+    return (it != clients_.end()) ? it->second.format : WireFormat::Protobuf;
+}
+
+void ZmqServer::set_rate_limit(double msgs_per_sec, double burst) {
+    rate_limit_ = msgs_per_sec;
+    burst_ = std::max(burst, 1.0);
+    auto now = core::TokenBucket::Clock::now();
+    for (auto& [id, client] : clients_) {
+        client.bucket = core::TokenBucket(rate_limit_, burst_, now);
+    }
+}
+
+void ZmqServer::set_session_timeout(std::chrono::milliseconds timeout,
+                                    DisconnectHandler on_disconnect) {
+    session_timeout_ = timeout;
+    disconnect_handler_ = std::move(on_disconnect);
+    if (timeout.count() <= 0) {
+        sessions_.reset();
+        return;
+    }
+    // 64 slots at timeout/16 per tick: timeouts land within one lap and fire
+    // at most ~6% late
+    auto tick = std::max(timeout / 16, std::chrono::milliseconds(1));
+    sessions_ = std::make_unique<core::TimerWheel<ClientEntry*>>(tick, 64);
+    auto deadline = core::TokenBucket::Clock::now() + timeout;
+    for (auto& entry : clients_) sessions_->schedule(&entry, deadline);
+}
+
+void ZmqServer::send(const std::string& client_id, const fix::FixMessage& msg) {
+    send_response(client_id, msg, wire_format(client_id));
+}
+
+void ZmqServer::watch_fd(int fd, std::function<void()> on_ready) {
+    poll_items_.push_back({nullptr, fd, ZMQ_POLLIN, 0});
+    fd_handlers_.push_back(std::move(on_ready));
+}
+
 bool ZmqServer::poll_once(int timeout_ms) {
-    zmq::pollitem_t items[] = {{socket_, 0, ZMQ_POLLIN, 0}};
-    zmq::poll(items, 1, std::chrono::milliseconds(timeout_ms));
+    // Queued work left by a previous cycle must not wait for new input
+    if (!ready_.empty()) timeout_ms = 0;
+    zmq::poll(poll_items_.data(), poll_items_.size(), std::chrono::milliseconds(timeout_ms));
+
+    bool handled = false;
+    for (size_t i = 1; i < poll_items_.size(); ++i) {
+        if (poll_items_[i].revents & ZMQ_POLLIN) {
+            fd_handlers_[i - 1]();
+            handled = true;
+        }
+    }
+
+    if (poll_items_[0].revents & ZMQ_POLLIN) {
+        receive_pending();
+        handled = true;
+    }
 
-    if (!(items[0].revents & ZMQ_POLLIN)) {
-        return false;
+    // One message per client per turn; a client goes to the back of the line
+    // while it still has messages queued. Bounded so the idle handler and
+    // watched fds keep running under sustained load.
+    for (size_t served = 0; served < kMaxDrain && !ready_.empty(); ++served) {
+        auto* entry = ready_.front();
+        ready_.pop_front();
+        auto& client = entry->second;
+
+        zmq::message_t data = std::move(client.queue.front());
+        client.queue.pop_front();
+        if (client.queue.empty()) {
+            client.scheduled = false;
+        } else {
+            ready_.push_back(entry);
+        }
+        process(*entry, data);
+        handled = true;
     }
 
-    // Receive identity frame
-    zmq::message_t identity;
-    (void)socket_.recv(identity, zmq::recv_flags::none);
-    std::string client_id(static_cast<char*>(identity.data()), identity.size());
+    if (sessions_) expire_sessions();
 
-    // Receive empty delimiter
-    zmq::message_t empty;
-    (void)socket_.recv(empty, zmq::recv_flags::none);
+    return handled;
+}
 
-    // Receive protobuf data frame
-    zmq::message_t data;
-    (void)socket_.recv(data, zmq::recv_flags::none);
+void ZmqServer::receive_pending() {
+    auto now = core::TokenBucket::Clock::now();
+
+    for (size_t n = 0; n < kMaxDrain; ++n) {
+        // Receive identity frame; stop once the socket is drained
+        zmq::message_t identity;
+        if (!socket_.recv(identity, zmq::recv_flags::dontwait)) break;
+
+        // Receive empty delimiter and data frame (protobuf, or binary when enabled)
+        zmq::message_t empty;
+        (void)socket_.recv(empty, zmq::recv_flags::none);
+        zmq::message_t data;
+        (void)socket_.recv(data, zmq::recv_flags::none);
+
+        auto [it, inserted] = clients_.try_emplace(
+            std::string(static_cast<const char*>(identity.data()), identity.size()));
+        auto& client = it->second;
+        if (inserted && rate_limit_ > 0.0) {
+            client.bucket = core::TokenBucket(rate_limit_, burst_, now);
+        }
+        if (sessions_) sessions_->schedule(&*it, now + session_timeout_);
 
-    try {
-        auto msg = deserialize(data.data(), data.size());
+        if (rate_limit_ > 0.0 && !client.bucket.try_take(now)) {
+            reject_unqueued(it->first, data, "Rate limit exceeded");
+            continue;
+        }
+        if (client.queue.size() >= max_queue_depth_) {
+            reject_unqueued(it->first, data, "Too many queued messages");
+            continue;
+        }
 
-        if (handler_) {
-            auto responses = handler_(client_id, msg);
-            for (const auto& response : responses) {
-                std::string resp_bytes = serialize(response);
+        client.queue.push_back(std::move(data));
+        if (!client.scheduled) {
+            client.scheduled = true;
+            ready_.push_back(&*it);
+        }
+    }
+}
 
-                socket_.send(zmq::buffer(client_id), zmq::send_flags::sndmore);
-                socket_.send(zmq::message_t{}, zmq::send_flags::sndmore);
-                socket_.send(zmq::buffer(resp_bytes), zmq::send_flags::none);
+void ZmqServer::expire_sessions() {
+    auto now = core::TokenBucket::Clock::now();
+    sessions_->advance(now, [&](ClientEntry* entry) {
+        // Still has messages waiting for service: not gone, just backlogged
+        if (entry->second.scheduled) {
+            sessions_->schedule(entry, now + session_timeout_);
+            return;
+        }
+        std::string client_id = entry->first;
+        clients_.erase(client_id);
+        spdlog::warn("[SESSION] {} timed out after {}ms without messages",
+                     client_id, session_timeout_.count());
+        if (disconnect_handler_) disconnect_handler_(client_id);
+    });
+}
+
+void ZmqServer::reject_unqueued(const std::string& client_id, const zmq::message_t& data,
+                                const char* reason) {
+    core::Metrics::instance().messages_throttled++;
+    bool binary = binary_codec_ && BinaryCodec::is_binary(data.data(), data.size());
+    send_response(client_id, make_reject(fix::FixMessage{}, reason),
+                  binary ? WireFormat::Binary : WireFormat::Protobuf);
+}
+
+void ZmqServer::process(ClientEntry& entry, const zmq::message_t& data) {
+    const auto& client_id = entry.first;
+    try {
+        bool binary = binary_codec_ && BinaryCodec::is_binary(data.data(), data.size());
+        auto format = binary ? WireFormat::Binary : WireFormat::Protobuf;
+        entry.second.format = format;
+
+        if (binary) {
+            if (!binary_codec_->decode(data.data(), data.size(), binary_msg_)) {
+                send_response(client_id, make_reject(fix::FixMessage{},
+                    "Malformed binary message or unknown symbol ID"), format);
+            } else if (handler_) {
+                for (const auto& response : handler_(client_id, binary_msg_)) {
+                    send_response(client_id, response, format);
+                }
+            }
+        } else {
+            auto msg = deserialize(data.data(), data.size());
+
+            if (handler_) {
+                auto responses = handler_(client_id, msg);
+                for (const auto& response : responses) {
+                    send_response(client_id, response, format);
+                }
             }
         }
     } catch (const std::exception& e) {
         spdlog::error("Error processing message: {}", e.what());
     }
+}
+
+void ZmqServer::send_response(const std::string& client_id, const fix::FixMessage& msg,
+                              WireFormat format) {
+    socket_.send(zmq::buffer(client_id), zmq::send_flags::sndmore);
+    socket_.send(zmq::message_t{}, zmq::send_flags::sndmore);
+
+    if (format == WireFormat::Binary) {
+        // Outbound frames carry the session's own sequence; a new session
+        // (after a timeout) starts again at 1
+        auto client = clients_.find(client_id);
+        uint32_t seq = (client != clients_.end()) ? client->second.out_seq + 1 : 0;
+        size_t n = binary_codec_->encode(msg, seq, binary_buf_, sizeof(binary_buf_));
+        if (n > 0) {
+            if (client != clients_.end()) client->second.out_seq = seq;
+            socket_.send(zmq::buffer(binary_buf_, n), zmq::send_flags::none);
+            return;
+        }
+        // No binary form (e.g. PositionReport): fall back to protobuf
+    }
 
-    return true;
+    std::string resp_bytes = serialize(msg);
+    socket_.send(zmq::buffer(resp_bytes), zmq::send_flags::none);
 }
 
 void ZmqServer::run() {
@@ -64,6 +234,7 @@ void ZmqServer::run() {
     spdlog::info("tradecore server running...");
     while (running_) {
         poll_once(100);
+        if (idle_handler_) idle_handler_();
     }
 }
 
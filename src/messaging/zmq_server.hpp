@@ -1,15 +1,24 @@
 #pragma once
 
 #include <zmq.hpp>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <fix_messages.pb.h>
+#include "core/timer_wheel.hpp"
+#include "core/token_bucket.hpp"
+#include "instrument/symbol_table.hpp"
+#include "messaging/binary_codec.hpp"
 #include "messaging/protocol.hpp"
 
 namespace tradecore::messaging {
 
+enum class WireFormat { Protobuf, Binary };
+
 class ZmqServer {
 public:
     explicit ZmqServer(const std::string& bind_address = "tcp://*:5555");
@@ -23,15 +32,87 @@ public:
 
     void set_handler(MessageHandler handler);
 
+    /// Called after every poll cycle in run(), whether or not a message arrived.
+    using IdleHandler = std::function<void()>;
+    void set_idle_handler(IdleHandler handler);
+
+    /// Accept the compact binary encoding alongside protobuf. Each message is
+    /// detected by its first byte and answered in the encoding it arrived in.
+    void enable_binary(const instrument::SymbolTable& symbols);
+
+    /// Encoding of the last message received from a client (Protobuf if unseen).
+    WireFormat wire_format(const std::string& client_id) const;
+
+    /// Throttle each client identity to msgs_per_sec with the given burst.
+    /// Messages over the limit are answered with a Reject without being
+    /// decoded. 0 disables throttling.
+    void set_rate_limit(double msgs_per_sec, double burst);
+
+    /// Messages queued per client before further ones are rejected.
+    void set_max_queue_depth(size_t depth) { max_queue_depth_ = depth; }
+
+    /// Called once for a client identity that has sent nothing (heartbeats
+    /// included) for the session timeout. The client's state is dropped; a
+    /// later message starts a fresh session.
+    using DisconnectHandler = std::function<void(const std::string& client_id)>;
+
+    /// Track liveness per client identity; 0 disables. Every inbound message
+    /// pushes the client's deadline back, at O(1) cost in a timer wheel.
+    void set_session_timeout(std::chrono::milliseconds timeout, DisconnectHandler on_disconnect);
+
+    size_t session_count() const { return sessions_ ? sessions_->size() : 0; }
+
+    /// Send an unsolicited message to a client identity, in the wire format
+    /// it last used. Dropped by the socket if the identity is not connected.
+    void send(const std::string& client_id, const fix::FixMessage& msg);
+
+    /// Poll a plain file descriptor alongside the ROUTER socket; on_ready runs
+    /// from poll_once() whenever fd becomes readable.
+    void watch_fd(int fd, std::function<void()> on_ready);
+
+    /// Wait for input, drain everything pending on the socket into per-client
+    /// queues, then serve the queues round-robin, one message per client per
+    /// turn, so a flooding client cannot starve the others.
     bool poll_once(int timeout_ms = 100);
 
     void run();
     void stop();
 
 private:
+    struct Client {
+        WireFormat format = WireFormat::Protobuf;
+        core::TokenBucket bucket;
+        std::deque<zmq::message_t> queue;
+        bool scheduled = false;  // present in ready_
+        uint32_t out_seq = 0;    // binary frames sent this session
+    };
+    using ClientEntry = std::pair<const std::string, Client>;
+
+    static constexpr size_t kMaxDrain = 1024;  // messages received, and served, per poll_once
+
+    void receive_pending();
+    void expire_sessions();
+    void reject_unqueued(const std::string& client_id, const zmq::message_t& data, const char* reason);
+    void process(ClientEntry& client, const zmq::message_t& data);
+    void send_response(const std::string& client_id, const fix::FixMessage& msg, WireFormat format);
+
     zmq::context_t ctx_;
     zmq::socket_t socket_;
     MessageHandler handler_;
+    IdleHandler idle_handler_;
+    std::unique_ptr<BinaryCodec> binary_codec_;
+    fix::FixMessage binary_msg_;  // decode target reused across binary messages
+    char binary_buf_[binary::kMaxFrameSize];
+    std::unordered_map<std::string, Client> clients_;
+    std::deque<ClientEntry*> ready_;  // clients with queued messages, in service order
+    double rate_limit_ = 0.0;
+    double burst_ = 0.0;
+    size_t max_queue_depth_ = 1024;
+    std::chrono::milliseconds session_timeout_{0};
+    std::unique_ptr<core::TimerWheel<ClientEntry*>> sessions_;  // keyed by clients_ node
+    DisconnectHandler disconnect_handler_;
+    std::vector<zmq::pollitem_t> poll_items_;  // [0] is socket_, then watched fds
+    std::vector<std::function<void()>> fd_handlers_;
     bool running_ = false;
 };
 
@@ -1,15 +1,20 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
+#include "core/fixed_point.hpp"
 #include "instrument/instrument.hpp"
 
 namespace tradecore::orders {
 
+using core::Price;
+using core::Qty;
+
 enum class Side { Buy, Sell };
-enum class OrderType { Market, Limit };
+enum class OrderType { Market, Limit, Stop, StopLimit };
 enum class TimeInForce { Day, GTC, IOC };
-enum class OrderStatus { Pending, Accepted, Filled, PartiallyFilled, Rejected, Cancelled };
+enum class OrderStatus { Pending, Accepted, Filled, PartiallyFilled, Rejected, Cancelled, Expired };
 
 inline std::string side_to_string(Side s) {
     switch (s) {
@@ -21,8 +26,10 @@ inline std::string side_to_string(Side s) {
 
 inline std::string order_type_to_string(OrderType ot) {
     switch (ot) {
-        case OrderType::Market: return "market";
-        case OrderType::Limit:  return "limit";
+        case OrderType::Market:    return "market";
+        case OrderType::Limit:     return "limit";
+        case OrderType::Stop:      return "stop";
+        case OrderType::StopLimit: return "stop_limit";
     }
     return "unknown";
 }
@@ -35,6 +42,7 @@ inline std::string status_to_string(OrderStatus s) {
         case OrderStatus::PartiallyFilled:  return "partially_filled";
         case OrderStatus::Rejected:         return "rejected";
         case OrderStatus::Cancelled:        return "cancelled";
+        case OrderStatus::Expired:          return "expired";
     }
     return "unknown";
 }
@@ -42,14 +50,31 @@ inline std::string status_to_string(OrderStatus s) {
 struct Order {
     std::string cl_ord_id;
     std::string order_id;
-    instrument::Instrument instrument;
+    const instrument::Instrument* instrument = &instrument::kUnknownInstrument;  // registry row
     Side side = Side::Buy;
-    double quantity = 0.0;
+    Qty quantity;
     OrderType order_type = OrderType::Market;
-    double limit_price = 0.0;
+    Price limit_price;
+    Price stop_price;        // Stop / StopLimit trigger
+    Qty display_quantity;    // iceberg peak shown in the book; 0 shows all
+    bool hidden = false;            // rests without appearing in market data
     TimeInForce time_in_force = TimeInForce::Day;
     std::string strategy_id;
+    std::string account;
+    std::string session;  // client_id of the connection that submitted it
+    uint32_t owner_id = 0;  // self-trade prevention group; 0 = unchecked
     OrderStatus status = OrderStatus::Pending;
 };
 
+inline bool is_stop(OrderType ot) {
+    return ot == OrderType::Stop || ot == OrderType::StopLimit;
+}
+
+/// The order a stop becomes once triggered: Stop -> Market, StopLimit -> Limit.
+inline Order to_triggered(Order order) {
+    if (order.order_type == OrderType::Stop) order.order_type = OrderType::Market;
+    if (order.order_type == OrderType::StopLimit) order.order_type = OrderType::Limit;
+    return order;
+}
+
 }  // namespace tradecore::orders
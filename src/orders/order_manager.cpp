@@ -6,13 +6,29 @@
 
 namespace tradecore::orders {
 
+namespace {
+
+// Stand-in request for reports on a resting order whose NewOrderSingle was not kept
+fix::FixMessage request_for(const Order& order) {
+    fix::FixMessage msg;
+    auto* nos = msg.mutable_new_order_single();
+    nos->set_cl_ord_id(order.cl_ord_id);
+    *nos->mutable_instrument() = order.instrument->to_proto();
+    nos->set_side(order.side == Side::Buy ? fix::SIDE_BUY : fix::SIDE_SELL);
+    nos->set_order_qty(order.quantity.to_double());
+    nos->set_price(order.limit_price.to_double());
+    return msg;
+}
+
+}  // namespace
+
 OrderManager::OrderManager(matching::MatchingEngine& matcher,
                            booking::BookKeeper& book_keeper,
                            double commission_rate)
     : matcher_(matcher), book_keeper_(book_keeper), commission_rate_(commission_rate) {}
 
 std::vector<fix::FixMessage> OrderManager::handle_new_order(
-    const fix::FixMessage& msg) {
+    const fix::FixMessage& msg, const std::string& session) {
     std::vector<fix::FixMessage> responses;
 
     if (!msg.has_new_order_single()) {
@@ -21,17 +37,41 @@ std::vector<fix::FixMessage> OrderManager::handle_new_order(
     }
 
     const auto& nos = msg.new_order_single();
+    if (!Qty::fits(nos.order_qty()) || !Price::fits(nos.price()) ||
+        !Price::fits(nos.stop_px()) || !Qty::fits(nos.max_floor())) {
+        responses.push_back(messaging::make_reject(msg,
+            "OrderQty, Price, StopPx and MaxFloor (38/44/99/111) must be finite and in range"));
+        return responses;
+    }
 
-    // Convert FIX NewOrderSingle to internal Order
+    // Convert FIX NewOrderSingle to internal Order. A symbol the master does
+    // not list points at a scratch row until the order has passed checks.
     Order order;
+    const auto* listed = instruments_->find(nos.instrument().symbol());
+    instrument::Instrument unlisted;
     try {
         order.cl_ord_id = nos.cl_ord_id();
-        order.instrument = instrument::Instrument::from_proto(nos.instrument());
+        if (listed) {
+            order.instrument = listed;
+        } else {
+            unlisted = instrument::Instrument::from_proto(nos.instrument());
+            order.instrument = &unlisted;
+        }
         order.side = (nos.side() == fix::SIDE_BUY) ? Side::Buy : Side::Sell;
-        order.quantity = nos.order_qty();
-        order.order_type = (nos.ord_type() == fix::ORD_TYPE_LIMIT) ? OrderType::Limit : OrderType::Market;
-        order.limit_price = nos.price();
+        order.quantity = Qty(nos.order_qty());
+        switch (nos.ord_type()) {
+            case fix::ORD_TYPE_LIMIT: order.order_type = OrderType::Limit; break;
+            case fix::ORD_TYPE_STOP: order.order_type = OrderType::Stop; break;
+            case fix::ORD_TYPE_STOP_LIMIT: order.order_type = OrderType::StopLimit; break;
+            default: order.order_type = OrderType::Market; break;
+        }
+        order.limit_price = Price(nos.price());
+        order.stop_price = Price(nos.stop_px());
+        order.display_quantity = Qty(nos.max_floor());
+        order.hidden = nos.hidden();
         order.strategy_id = nos.text();
+        order.account = nos.account();
+        order.session = session;
 
         switch (nos.time_in_force()) {
             case fix::TIF_GTC: order.time_in_force = TimeInForce::GTC; break;
@@ -48,62 +88,89 @@ std::vector<fix::FixMessage> OrderManager::handle_new_order(
 
     // Validate
     auto error = validate(order);
+    if (error.empty() && !listed && listed_only_) {
+        error = "Unknown symbol (tag 55): " + order.instrument->symbol;
+    }
     if (!error.empty()) {
         responses.push_back(messaging::make_reject(msg, error));
         return responses;
     }
 
+    // Pre-trade risk
+    if (risk_) {
+        auto breach = risk_->check(order, matcher_.get_market_price(order.instrument->symbol));
+        if (!breach.empty()) {
+            spdlog::warn("[RISK] Rejected {} | {}", order.cl_ord_id, breach);
+            responses.push_back(messaging::make_reject(msg, breach));
+            return responses;
+        }
+    }
+
+    // Only an order that passed every check may register its symbol
+    if (!listed) order.instrument = &instruments_->add(std::move(unlisted));
+
     // Accept
     order.status = OrderStatus::Accepted;
     spdlog::info("[ORDER] Accepted {} | {} {} {} @ {}",
                  order.order_id, side_to_string(order.side),
-                 order.quantity, order.instrument.symbol,
+                 order.quantity.to_double(), order.instrument->symbol,
                  order_type_to_string(order.order_type));
 
     // Try to match
+    order.owner_id = owner_id_for(order);
     auto match_result = matcher_.try_match(order);
 
+    if (match_result.parked) {
+        spdlog::info("[STOP] Parked {} | {} {} stop @ {}", order.order_id,
+                     side_to_string(order.side), order.instrument->symbol, order.stop_price.to_double());
+        responses.push_back(messaging::make_execution_report_new(msg, order.order_id));
+        index_open(order);
+        stop_requests_[order.order_id] = msg;
+        cl_ord_to_order_id_[order.cl_ord_id] = order.order_id;
+        orders_[order.order_id] = std::move(order);
+        return responses;
+    }
+    if (match_result.collected) {
+        spdlog::info("[AUCTION] Collected {} | {} {} {} @ {}", order.order_id,
+                     side_to_string(order.side), order.quantity.to_double(), order.instrument->symbol,
+                     order_type_to_string(order.order_type));
+        order.status = OrderStatus::Accepted;
+        responses.push_back(messaging::make_execution_report_new(msg, order.order_id));
+        index_open(order);
+        auction_orders_[order.order_id].request = msg;
+        cl_ord_to_order_id_[order.cl_ord_id] = order.order_id;
+        orders_[order.order_id] = std::move(order);
+        return responses;
+    }
+    // A stop the market had already reached trades at once as its triggered type
+    if (is_stop(order.order_type)) order = to_triggered(std::move(order));
+
+    bool ioc = order.time_in_force == TimeInForce::IOC;
+    bool stp_cancelled = apply_self_trades(order, match_result);
+    // Decremented down to nothing without a fill
+    bool stp_exhausted = match_result.self_trade_quantity.positive() &&
+                         !match_result.remaining_quantity.positive();
+
     if (match_result.matched) {
-        // Emit per-fill ExecutionReports
-        double cum_qty = 0.0;
-        for (const auto& fill : match_result.fills) {
-            cum_qty += fill.fill_quantity;
-            double leaves = order.quantity - cum_qty;
-            double commission = fill.fill_price * fill.fill_quantity * commission_rate_;
-
-            auto fill_id = next_fill_id();
-            auto trade_id = next_trade_id();
-
-            // Book the trade
-            booking::Trade trade;
-            trade.trade_id = trade_id;
-            trade.order_id = order.order_id;
-            trade.cl_ord_id = order.cl_ord_id;
-            trade.symbol = order.instrument.symbol;
-            trade.side = side_to_string(order.side);
-            trade.quantity = fill.fill_quantity;
-            trade.price = fill.fill_price;
-            trade.commission = commission;
-            trade.timestamp = messaging::current_timestamp();
-            trade.strategy_id = order.strategy_id;
-
-            book_keeper_.book_trade(trade);
-
-            spdlog::info("[FILL]  {} | {} {} @ {}",
-                         fill_id, order.instrument.symbol,
-                         fill.fill_quantity, fill.fill_price);
-
-            responses.push_back(messaging::make_execution_report_fill(
-                msg, order.order_id, fill_id,
-                fill.fill_price, fill.fill_quantity,
-                leaves, cum_qty, commission));
-        }
+        Qty cum_qty = book_fills(msg, order, match_result, Qty{}, responses);
+        settle_resting(match_result);
 
-        order.status = (match_result.remaining_quantity == 0.0)
+        order.status = match_result.remaining_quantity.is_zero()
             ? OrderStatus::Filled
             : OrderStatus::PartiallyFilled;
+        if (stp_cancelled ||
+            (ioc && order.order_type == OrderType::Limit && match_result.remaining_quantity.positive())) {
+            order.status = OrderStatus::Cancelled;
+            responses.push_back(messaging::make_execution_report_remainder_cancelled(
+                msg, order.order_id, cum_qty.to_double()));
+        }
     } else {
-        if (order.order_type == OrderType::Limit && match_result.remaining_quantity > 0.0) {
+        if ((ioc && order.order_type == OrderType::Limit) || stp_cancelled || stp_exhausted) {
+            // Nothing crossed and IOC never rests, or only own orders crossed
+            order.status = OrderStatus::Cancelled;
+            responses.push_back(messaging::make_execution_report_remainder_cancelled(
+                msg, order.order_id, 0.0));
+        } else if (order.order_type == OrderType::Limit && match_result.remaining_quantity.positive()) {
             // Limit order resting — no rejection needed, order is working
             order.status = OrderStatus::Accepted;
             // Send a NEW ack
@@ -115,9 +182,13 @@ std::vector<fix::FixMessage> OrderManager::handle_new_order(
     }
 
     // Store order
+    if (order.order_type == OrderType::Limit && !ioc && match_result.remaining_quantity.positive()) {
+        index_open(order);
+    }
     cl_ord_to_order_id_[order.cl_ord_id] = order.order_id;
     orders_[order.order_id] = std::move(order);
 
+    process_triggered();
     return responses;
 }
 
@@ -158,12 +229,13 @@ std::vector<fix::FixMessage> OrderManager::handle_cancel_request(
     }
 
     // Try to remove from the order book
-    bool cancelled = matcher_.cancel_order(order.instrument.symbol, order.order_id);
+    bool cancelled = matcher_.cancel_order(order.instrument->symbol, order.order_id);
 
     // Even if not in the book (e.g., fully matched between accept and cancel), mark as cancelled
     order.status = OrderStatus::Cancelled;
+    unindex(order);
 
-    spdlog::info("[CANCEL] {} | {}", order.order_id, order.instrument.symbol);
+    spdlog::info("[CANCEL] {} | {}", order.order_id, order.instrument->symbol);
 
     responses.push_back(messaging::make_execution_report_cancelled(
         msg, order.order_id, orig_cl_ord_id));
@@ -171,13 +243,442 @@ std::vector<fix::FixMessage> OrderManager::handle_cancel_request(
     return responses;
 }
 
+std::vector<fix::FixMessage> OrderManager::handle_cancel_replace(
+    const fix::FixMessage& msg) {
+    std::vector<fix::FixMessage> responses;
+
+    if (!msg.has_order_cancel_replace_request()) {
+        responses.push_back(messaging::make_reject(msg, "Message has no OrderCancelReplaceRequest body"));
+        return responses;
+    }
+
+    const auto& req = msg.order_cancel_replace_request();
+    const auto& orig_cl_ord_id = req.orig_cl_ord_id();
+
+    auto cl_it = cl_ord_to_order_id_.find(orig_cl_ord_id);
+    if (cl_it == cl_ord_to_order_id_.end()) {
+        responses.push_back(messaging::make_reject(msg,
+            "Unknown orig_cl_ord_id: " + orig_cl_ord_id));
+        return responses;
+    }
+
+    auto order_it = orders_.find(cl_it->second);
+    if (order_it == orders_.end()) {
+        responses.push_back(messaging::make_reject(msg,
+            "Order not found for id: " + cl_it->second));
+        return responses;
+    }
+
+    auto& order = order_it->second;
+
+    if (order.status != OrderStatus::Accepted && order.status != OrderStatus::PartiallyFilled) {
+        responses.push_back(messaging::make_reject(msg,
+            "Order not in replaceable state: " + status_to_string(order.status)));
+        return responses;
+    }
+    if (order.order_type != OrderType::Limit) {
+        responses.push_back(messaging::make_reject(msg, "Only resting limit orders can be replaced"));
+        return responses;
+    }
+    if (req.cl_ord_id().empty() || cl_ord_to_order_id_.count(req.cl_ord_id())) {
+        responses.push_back(messaging::make_reject(msg, "ClOrdID (tag 11) must be new and unique"));
+        return responses;
+    }
+    if (!Qty::fits(req.order_qty()) || !Price::fits(req.price())) {
+        responses.push_back(messaging::make_reject(msg,
+            "OrderQty and Price (tags 38/44) must be finite and in range"));
+        return responses;
+    }
+    if (req.order_qty() <= 0.0 || req.price() <= 0.0) {
+        responses.push_back(messaging::make_reject(msg, "OrderQty and Price must be positive"));
+        return responses;
+    }
+
+    const auto* book = matcher_.get_book(order.instrument->symbol);
+    const auto* resting = book ? book->find_order(order.order_id) : nullptr;
+    if (!resting) {
+        responses.push_back(messaging::make_reject(msg, "Order is no longer resting"));
+        return responses;
+    }
+
+    Qty cum_qty = order.quantity - resting->leaves_quantity();
+    Qty leaves = Qty(req.order_qty()) - cum_qty;
+    if (!leaves.positive()) {
+        responses.push_back(messaging::make_reject(msg,
+            "OrderQty (tag 38) must exceed the filled quantity"));
+        return responses;
+    }
+
+    auto match_result = matcher_.replace_order(order, Price(req.price()), leaves);
+    if (!match_result) {
+        responses.push_back(messaging::make_reject(msg, "Order is no longer resting"));
+        return responses;
+    }
+
+    order.cl_ord_id = req.cl_ord_id();
+    order.quantity = Qty(req.order_qty());
+    order.limit_price = Price(req.price());
+    cl_ord_to_order_id_[order.cl_ord_id] = order.order_id;
+    // Auction fills still to come are reported against the amended order
+    auto auction_it = auction_orders_.find(order.order_id);
+    if (auction_it != auction_orders_.end()) auction_it->second.request = msg;
+
+    spdlog::info("[REPLACE] {} | {} {} @ {}", order.order_id, order.instrument->symbol,
+                 order.quantity.to_double(), order.limit_price.to_double());
+
+    responses.push_back(messaging::make_execution_report_replaced(
+        msg, order.order_id, leaves.to_double(), cum_qty.to_double()));
+
+    // A price that crossed the book trades immediately
+    bool stp_cancelled = apply_self_trades(order, *match_result);
+    if (match_result->matched) {
+        cum_qty = book_fills(msg, order, *match_result, cum_qty, responses);
+        settle_resting(*match_result);
+        order.status = (cum_qty >= order.quantity) ? OrderStatus::Filled
+                                                   : OrderStatus::PartiallyFilled;
+        if (order.status == OrderStatus::Filled) unindex(order);
+    }
+    // Self-trade prevention can also leave nothing to rest without a fill
+    bool exhausted = !match_result->matched && !match_result->remaining_quantity.positive();
+    if (stp_cancelled || exhausted) {
+        order.status = OrderStatus::Cancelled;
+        unindex(order);
+        responses.push_back(messaging::make_execution_report_remainder_cancelled(
+            msg, order.order_id, cum_qty.to_double()));
+    }
+
+    process_triggered();
+    return responses;
+}
+
+std::vector<fix::FixMessage> OrderManager::handle_mass_cancel(
+    const fix::FixMessage& msg, const std::string& session) {
+    std::vector<fix::FixMessage> responses;
+
+    if (!msg.has_order_mass_cancel_request()) {
+        responses.push_back(messaging::make_reject(msg, "Message has no OrderMassCancelRequest body"));
+        return responses;
+    }
+
+    const auto& req = msg.order_mass_cancel_request();
+    auto report_id = "MC-" + std::to_string(++mass_cancel_seq_);
+
+    MassCancelFilter filter;
+    filter.session = session;
+    filter.strategy_id = req.text();
+
+    fix::MassCancelResponse response;
+    switch (req.mass_cancel_request_type()) {
+        case fix::MASS_CANCEL_SECURITY:
+            if (req.instrument().symbol().empty()) {
+                responses.push_back(messaging::make_mass_cancel_report(
+                    msg, report_id, fix::MASS_CANCEL_RESPONSE_REJECTED, 0,
+                    "Symbol (tag 55) is required to cancel by security"));
+                return responses;
+            }
+            filter.symbol = req.instrument().symbol();
+            response = fix::MASS_CANCEL_RESPONSE_SECURITY;
+            break;
+        case fix::MASS_CANCEL_ALL:
+            response = fix::MASS_CANCEL_RESPONSE_ALL;
+            break;
+        default:
+            responses.push_back(messaging::make_mass_cancel_report(
+                msg, report_id, fix::MASS_CANCEL_RESPONSE_REJECTED, 0,
+                "Unsupported MassCancelRequestType (tag 530)"));
+            return responses;
+    }
+
+    auto affected = cancel_orders(filter);
+    responses.push_back(messaging::make_mass_cancel_report(
+        msg, report_id, response, static_cast<int>(affected)));
+    return responses;
+}
+
+size_t OrderManager::cancel_orders(const MassCancelFilter& filter) {
+    // Start from the narrowest index the filter names, then check the rest
+    static const std::unordered_set<std::string> kNone;
+    const std::unordered_set<std::string>* candidates = nullptr;
+    auto narrow = [&](const OrderIndex& index, const std::string& key) {
+        if (key.empty()) return;
+        auto it = index.find(key);
+        const auto* ids = (it != index.end()) ? &it->second : &kNone;
+        if (!candidates || ids->size() < candidates->size()) candidates = ids;
+    };
+    narrow(by_session_, filter.session);
+    narrow(by_symbol_, filter.symbol);
+    narrow(by_strategy_, filter.strategy_id);
+
+    // Group by symbol so each book is swept once
+    OrderIndex per_symbol;
+    auto select = [&](const std::string& order_id) {
+        const auto& order = orders_.at(order_id);
+        if (!filter.session.empty() && order.session != filter.session) return;
+        if (!filter.symbol.empty() && order.instrument->symbol != filter.symbol) return;
+        if (!filter.strategy_id.empty() && order.strategy_id != filter.strategy_id) return;
+        per_symbol[order.instrument->symbol].insert(order_id);
+    };
+    if (candidates) {
+        for (const auto& id : *candidates) select(id);
+    } else {
+        for (const auto& [symbol, ids] : by_symbol_) {
+            for (const auto& id : ids) select(id);
+        }
+    }
+
+    size_t cancelled = remove_open_orders(per_symbol, OrderStatus::Cancelled);
+
+    spdlog::info("[CANCEL] Mass cancel {} orders | session={} symbol={} strategy={}",
+                 cancelled, filter.session, filter.symbol, filter.strategy_id);
+    return cancelled;
+}
+
+size_t OrderManager::expire_day_orders() {
+    OrderIndex per_symbol;
+    for (const auto& id : day_orders_) {
+        per_symbol[orders_.at(id).instrument->symbol].insert(id);
+    }
+    size_t expired = remove_open_orders(per_symbol, OrderStatus::Expired);
+    spdlog::info("[EXPIRE] {} Day orders expired at session end", expired);
+    return expired;
+}
+
+size_t OrderManager::remove_open_orders(const OrderIndex& by_symbol, OrderStatus status) {
+    // Only what the book still held; the rest already traded away
+    size_t removed = 0;
+    for (const auto& [symbol, ids] : by_symbol) {
+        for (const auto& id : matcher_.cancel_orders(symbol, ids)) {
+            auto& order = orders_.at(id);
+            order.status = status;
+            unindex(order);
+            ++removed;
+        }
+    }
+    return removed;
+}
+
+matching::AuctionResult OrderManager::uncross(const std::string& symbol) {
+    auto auction = matcher_.uncross(symbol);
+    spdlog::info("[AUCTION] Uncrossed {} | {} @ {} in {} fills, {} remainders cancelled",
+                 symbol, auction.volume.to_double(), auction.price.to_double(), auction.fills.size(),
+                 auction.cancelled.size());
+    settle_auction(auction);
+    return auction;
+}
+
+matching::AuctionResult OrderManager::close_auction(const std::string& symbol) {
+    auto auction = matcher_.close_auction(symbol);
+    spdlog::info("[AUCTION] Closed {} | {} @ {} in {} fills", symbol,
+                 auction.volume.to_double(), auction.price.to_double(), auction.fills.size());
+    settle_auction(auction);
+
+    // Leftovers rest as ordinary limit orders from here on
+    auto open_it = by_symbol_.find(symbol);
+    if (open_it != by_symbol_.end()) {
+        for (const auto& id : open_it->second) auction_orders_.erase(id);
+    }
+    process_triggered();
+    return auction;
+}
+
+void OrderManager::settle_auction(const matching::AuctionResult& auction) {
+    // Group the prints by participant, keeping first-fill order. Counterparties
+    // without a collected request (seed liquidity, orders resting from
+    // continuous trading) are not reported, as with passive fills.
+    std::vector<std::string> filled;
+    std::vector<std::string> resting;
+    std::unordered_map<std::string, matching::MatchResult> per_order;
+    for (const auto& fill : auction.fills) {
+        for (const auto* id : {&fill.order_id, &fill.resting_order_id}) {
+            if (!auction_orders_.count(*id)) {
+                resting.push_back(*id);
+                continue;
+            }
+            auto& result = per_order[*id];
+            if (result.fills.empty()) filled.push_back(*id);
+            result.fills.push_back(fill);
+        }
+    }
+
+    auto send = [&](const Order& order, const std::vector<fix::FixMessage>& reports) {
+        if (!report_sink_) return;
+        for (const auto& report : reports) report_sink_(order.session, report);
+    };
+
+    for (const auto& id : filled) {
+        auto& order = orders_.at(id);
+        auto& entry = auction_orders_.at(id);
+        std::vector<fix::FixMessage> reports;
+        entry.cum_qty = book_fills(entry.request, order, per_order[id], entry.cum_qty, reports);
+        if (entry.cum_qty >= order.quantity) {
+            order.status = OrderStatus::Filled;
+            unindex(order);
+        } else {
+            order.status = OrderStatus::PartiallyFilled;
+        }
+        send(order, reports);
+    }
+    for (const auto& id : resting) settle_resting(id);
+
+    for (const auto& id : auction.cancelled) {
+        auto entry_it = auction_orders_.find(id);
+        if (entry_it == auction_orders_.end()) continue;
+        auto& order = orders_.at(id);
+        std::vector<fix::FixMessage> reports{messaging::make_execution_report_remainder_cancelled(
+            entry_it->second.request, order.order_id, entry_it->second.cum_qty.to_double())};
+        order.status = OrderStatus::Cancelled;
+        unindex(order);
+        send(order, reports);
+    }
+}
+
+void OrderManager::settle_resting(const matching::MatchResult& result) {
+    for (const auto& fill : result.fills) settle_resting(fill.resting_order_id);
+}
+
+void OrderManager::settle_resting(const std::string& order_id) {
+    auto it = orders_.find(order_id);
+    if (it == orders_.end()) return;
+    auto& order = it->second;
+    if (order.status != OrderStatus::Accepted && order.status != OrderStatus::PartiallyFilled) {
+        return;
+    }
+    const auto* book = matcher_.get_book(order.instrument->symbol);
+    if (book && book->find_order(order_id)) {
+        order.status = OrderStatus::PartiallyFilled;
+        return;
+    }
+    order.status = OrderStatus::Filled;
+    unindex(order);
+}
+
+uint32_t OrderManager::owner_id_for(const Order& order) {
+    if (matcher_.self_trade_prevention() == matching::SelfTradePrevention::None) return 0;
+    const auto& key = (stp_key_ == SelfTradeKey::Account) ? order.account : order.strategy_id;
+    if (key.empty()) return 0;
+    auto [it, inserted] = owner_ids_.try_emplace(key, static_cast<uint32_t>(owner_ids_.size() + 1));
+    return it->second;
+}
+
+bool OrderManager::apply_self_trades(Order& order, const matching::MatchResult& result) {
+    bool decrement =
+        matcher_.self_trade_prevention() == matching::SelfTradePrevention::DecrementBoth;
+
+    for (const auto& event : result.self_trades) {
+        auto it = orders_.find(event.resting_order_id);
+        if (it == orders_.end()) continue;
+        auto& resting = it->second;
+        spdlog::info("[STP] {} would trade with {} | {} {}", order.order_id, resting.order_id,
+                     event.quantity.to_double(), event.removed ? "cancelled" : "decremented");
+
+        Qty cum_qty = resting.quantity - event.quantity;
+        if (decrement) resting.quantity -= event.quantity;
+        if (!event.removed) continue;
+
+        resting.status = OrderStatus::Cancelled;
+        unindex(resting);
+        if (report_sink_) {
+            report_sink_(resting.session, messaging::make_execution_report_remainder_cancelled(
+                request_for(resting), resting.order_id, cum_qty.to_double()));
+        }
+    }
+
+    if (!result.self_trade_quantity.positive()) return false;
+    if (decrement) {
+        order.quantity -= result.self_trade_quantity;
+        return false;
+    }
+    return true;
+}
+
+void OrderManager::process_triggered() {
+    for (auto& triggered : matcher_.take_triggered()) {
+        auto order_it = orders_.find(triggered.order.order_id);
+        auto request_it = stop_requests_.find(triggered.order.order_id);
+        if (order_it == orders_.end() || request_it == stop_requests_.end()) continue;
+        auto& order = order_it->second;
+        auto request = std::move(request_it->second);
+        stop_requests_.erase(request_it);
+
+        order.order_type = triggered.order.order_type;
+        const auto& result = triggered.result;
+        spdlog::info("[STOP] Triggered {} | {} {} @ stop {} as {}", order.order_id,
+                     side_to_string(order.side), order.instrument->symbol, order.stop_price.to_double(),
+                     order_type_to_string(order.order_type));
+
+        bool stp_cancelled = apply_self_trades(order, result);
+        std::vector<fix::FixMessage> reports;
+        Qty cum_qty = book_fills(request, order, result, Qty{}, reports);
+        settle_resting(result);
+        bool rests = order.order_type == OrderType::Limit && !stp_cancelled &&
+                     order.time_in_force != TimeInForce::IOC && result.remaining_quantity.positive();
+
+        if (!result.remaining_quantity.positive() && cum_qty.positive() && !stp_cancelled) {
+            order.status = OrderStatus::Filled;
+            unindex(order);
+        } else if (rests) {
+            order.status = cum_qty.positive() ? OrderStatus::PartiallyFilled : OrderStatus::Accepted;
+        } else {
+            // Market (or IOC) remainder the book could not absorb
+            order.status = OrderStatus::Cancelled;
+            reports.push_back(messaging::make_execution_report_remainder_cancelled(
+                request, order.order_id, cum_qty.to_double()));
+            unindex(order);
+        }
+
+        if (report_sink_) {
+            for (const auto& report : reports) report_sink_(order.session, report);
+        }
+    }
+}
+
+size_t OrderManager::open_order_count(const std::string& session) const {
+    auto it = by_session_.find(session);
+    return (it != by_session_.end()) ? it->second.size() : 0;
+}
+
+void OrderManager::index_open(const Order& order) {
+    by_session_[order.session].insert(order.order_id);
+    by_symbol_[order.instrument->symbol].insert(order.order_id);
+    by_strategy_[order.strategy_id].insert(order.order_id);
+    if (order.time_in_force == TimeInForce::Day) day_orders_.insert(order.order_id);
+}
+
+void OrderManager::unindex(const Order& order) {
+    auto erase_from = [&](OrderIndex& index, const std::string& key) {
+        auto it = index.find(key);
+        if (it == index.end()) return;
+        it->second.erase(order.order_id);
+        if (it->second.empty()) index.erase(it);
+    };
+    erase_from(by_session_, order.session);
+    erase_from(by_symbol_, order.instrument->symbol);
+    erase_from(by_strategy_, order.strategy_id);
+    day_orders_.erase(order.order_id);
+    stop_requests_.erase(order.order_id);
+    auction_orders_.erase(order.order_id);
+}
+
 std::string OrderManager::validate(const Order& order) const {
     if (order.cl_ord_id.empty()) return "ClOrdID (tag 11) is required";
-    if (order.instrument.symbol.empty()) return "Symbol (tag 55) is required";
-    if (order.quantity <= 0.0) return "OrderQty (tag 38) must be positive";
-    if (order.order_type == OrderType::Limit && order.limit_price <= 0.0) {
+    if (order.instrument->symbol.empty()) return "Symbol (tag 55) is required";
+    if (!order.quantity.positive()) return "OrderQty (tag 38) must be positive";
+    if ((order.order_type == OrderType::Limit || order.order_type == OrderType::StopLimit) &&
+        !order.limit_price.positive()) {
         return "Price (tag 44) must be positive for limit orders";
     }
+    if (is_stop(order.order_type) && !order.stop_price.positive()) {
+        return "StopPx (tag 99) must be positive for stop orders";
+    }
+    if (order.display_quantity < Qty{}) return "MaxFloor (tag 111) must not be negative";
+    if (order.display_quantity.positive() || order.hidden) {
+        if (order.order_type != OrderType::Limit && order.order_type != OrderType::StopLimit) {
+            return "Iceberg and hidden orders must be limit orders";
+        }
+        if (order.display_quantity.positive() && order.hidden) {
+            return "An order cannot be both iceberg and hidden";
+        }
+    }
     return "";
 }
 
@@ -192,6 +693,48 @@ const Order* OrderManager::find_order_by_cl_ord_id(const std::string& cl_ord_id)
     return find_order(cl_it->second);
 }
 
+Qty OrderManager::book_fills(const fix::FixMessage& msg, const Order& order,
+                             const matching::MatchResult& result, Qty cum_qty,
+                             std::vector<fix::FixMessage>& responses) {
+    // All fills of one match share a timestamp and are booked as one batch
+    auto timestamp = result.fills.empty() ? std::string() : messaging::current_timestamp();
+    trade_batch_.clear();
+
+    // Emit per-fill ExecutionReports
+    for (const auto& fill : result.fills) {
+        cum_qty += fill.fill_quantity;
+        Qty leaves = order.quantity - cum_qty;
+        double commission = core::notional(fill.fill_price, fill.fill_quantity) * commission_rate_;
+
+        auto fill_id = next_fill_id();
+        auto trade_id = next_trade_id();
+
+        auto& trade = trade_batch_.emplace_back();
+        trade.trade_id = trade_id;
+        trade.order_id = order.order_id;
+        trade.cl_ord_id = order.cl_ord_id;
+        trade.symbol = order.instrument->symbol;
+        trade.side = order.side;
+        trade.quantity = fill.fill_quantity;
+        trade.price = fill.fill_price;
+        trade.commission = commission;
+        trade.timestamp = timestamp;
+        trade.strategy_id = order.strategy_id;
+        trade.account = order.account;
+
+        spdlog::info("[FILL]  {} | {} {} @ {}",
+                     fill_id, order.instrument->symbol,
+                     fill.fill_quantity.to_double(), fill.fill_price.to_double());
+
+        responses.push_back(messaging::make_execution_report_fill(
+            msg, order.order_id, fill_id,
+            fill.fill_price.to_double(), fill.fill_quantity.to_double(),
+            leaves.to_double(), cum_qty.to_double(), commission));
+    }
+    if (!trade_batch_.empty()) book_keeper_.book_trades(trade_batch_, *order.instrument);
+    return cum_qty;
+}
+
 std::string OrderManager::next_order_id() {
     std::ostringstream ss;
     ss << "TC-" << std::setfill('0') << std::setw(5) << ++order_seq_;
@@ -1,28 +1,102 @@
 #pragma once
 
+#include <functional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <fix_messages.pb.h>
 #include "booking/book_keeper.hpp"
+#include "instrument/instrument_registry.hpp"
 #include "matching/matching_engine.hpp"
 #include "messaging/protocol.hpp"
 #include "orders/order.hpp"
+#include "risk/risk_engine.hpp"
 
 namespace tradecore::orders {
 
+/// Which order field groups orders for self-trade prevention.
+enum class SelfTradeKey { Strategy, Account };
+
+inline SelfTradeKey self_trade_key_from_string(const std::string& s) {
+    return (s == "account") ? SelfTradeKey::Account : SelfTradeKey::Strategy;
+}
+
+/// Selects resting orders for a mass cancel. Empty fields match anything.
+struct MassCancelFilter {
+    std::string session;
+    std::string symbol;
+    std::string strategy_id;
+};
+
 class OrderManager {
 public:
     OrderManager(matching::MatchingEngine& matcher, booking::BookKeeper& book_keeper,
                  double commission_rate = 0.001);
 
     /// Process an incoming NewOrderSingle. Returns response FixMessages.
-    std::vector<fix::FixMessage> handle_new_order(const fix::FixMessage& msg);
+    /// session identifies the submitting connection for mass cancels.
+    std::vector<fix::FixMessage> handle_new_order(const fix::FixMessage& msg,
+                                                  const std::string& session = "");
 
     /// Process an incoming OrderCancelRequest. Returns response FixMessages.
     std::vector<fix::FixMessage> handle_cancel_request(const fix::FixMessage& msg);
 
+    /// Process an incoming OrderCancelReplaceRequest (amend price/quantity of a
+    /// resting limit order). Returns response FixMessages.
+    std::vector<fix::FixMessage> handle_cancel_replace(const fix::FixMessage& msg);
+
+    /// Process an incoming OrderMassCancelRequest, scoped to the requesting
+    /// session. Returns an OrderMassCancelReport.
+    std::vector<fix::FixMessage> handle_mass_cancel(const fix::FixMessage& msg,
+                                                    const std::string& session = "");
+
+    /// Cancel every open order matching the filter, removing each symbol's
+    /// set from the book in one sweep. Returns the number the books actually
+    /// removed, so cancel-on-disconnect never counts quotes that already traded.
+    size_t cancel_orders(const MassCancelFilter& filter);
+
+    /// Expire every resting Day order (end of the trading session), removing
+    /// each symbol's set from the book in one sweep. GTC orders are kept.
+    /// Returns the number expired.
+    size_t expire_day_orders();
+
+    /// Collect orders for a symbol without matching until uncross().
+    void open_auction(const std::string& symbol) { matcher_.open_auction(symbol); }
+
+    /// Run the symbol's call auction: book every participant's fills at the
+    /// clearing price and send their reports to the report sink. Market and
+    /// IOC remainders are cancelled; the symbol stays in auction mode.
+    matching::AuctionResult uncross(const std::string& symbol);
+
+    /// Uncross and return the symbol to continuous matching.
+    matching::AuctionResult close_auction(const std::string& symbol);
+
+    /// Open (accepted, resting) orders submitted by a session.
+    size_t open_order_count(const std::string& session) const;
+
+    /// Receives reports nobody asked for in the current request, addressed to
+    /// the session that owns the order (e.g. fills of a triggered stop).
+    using ReportSink = std::function<void(const std::string& session, const fix::FixMessage& report)>;
+    void set_report_sink(ReportSink sink) { report_sink_ = std::move(sink); }
+
+    /// Orders sharing this field never trade with each other when the
+    /// matcher's self-trade prevention is on. Orders with it empty are exempt.
+    void set_self_trade_key(SelfTradeKey key) { stp_key_ = key; }
+
+    /// Run pre-trade risk checks on every new order (nullptr disables).
+    void set_risk_engine(risk::RiskEngine* risk) { risk_ = risk; }
+
+    /// Resolve new orders' instruments against this master. It must outlive
+    /// every order. Without one, the manager keeps its own. With listed_only,
+    /// orders for symbols the master lacks are rejected; otherwise an accepted
+    /// order registers its symbol from the message.
+    void set_instruments(instrument::InstrumentRegistry* instruments, bool listed_only = false) {
+        instruments_ = instruments ? instruments : &own_instruments_;
+        listed_only_ = instruments && listed_only;
+    }
+
     /// Validate order fields. Returns empty string if valid, error otherwise.
     std::string validate(const Order& order) const;
 
@@ -34,6 +108,38 @@ public:
     size_t order_count() const { return orders_.size(); }
 
 private:
+    /// Book each fill and append its ExecutionReport. cum_qty is the quantity
+    /// filled before this match; returns the cumulative quantity after it.
+    Qty book_fills(const fix::FixMessage& msg, const Order& order,
+                   const matching::MatchResult& result, Qty cum_qty,
+                      std::vector<fix::FixMessage>& responses);
+
+    using OrderIndex = std::unordered_map<std::string, std::unordered_set<std::string>>;
+
+    /// Book and report stops the matcher triggered during the last match.
+    void process_triggered();
+
+    /// Compact ID of the order's self-trade group (0 when unchecked).
+    uint32_t owner_id_for(const Order& order);
+
+    /// Apply self-trade prevention from a match: close or shrink the resting
+    /// orders it removed (reporting to their owners) and decrement the
+    /// incoming order. Returns true if the incoming remainder was cancelled.
+    bool apply_self_trades(Order& order, const matching::MatchResult& result);
+
+    /// Book and report the fills and cancels of an uncross.
+    void settle_auction(const matching::AuctionResult& auction);
+
+    /// Update the status of resting orders a match traded against: filled
+    /// and unindexed once the book no longer holds them.
+    void settle_resting(const matching::MatchResult& result);
+    void settle_resting(const std::string& order_id);
+
+    void index_open(const Order& order);
+    void unindex(const Order& order);
+    /// Pull per-symbol sets of open orders from the books and close them with status.
+    size_t remove_open_orders(const OrderIndex& by_symbol, OrderStatus status);
+
     std::string next_order_id();
     std::string next_fill_id();
     std::string next_trade_id();
@@ -41,11 +147,33 @@ private:
     matching::MatchingEngine& matcher_;
     booking::BookKeeper& book_keeper_;
     double commission_rate_;
+    risk::RiskEngine* risk_ = nullptr;
+    instrument::InstrumentRegistry own_instruments_;
+    instrument::InstrumentRegistry* instruments_ = &own_instruments_;
+    bool listed_only_ = false;
+    ReportSink report_sink_;
+    SelfTradeKey stp_key_ = SelfTradeKey::Strategy;
+    std::unordered_map<std::string, uint32_t> owner_ids_;
     std::unordered_map<std::string, Order> orders_;
     std::unordered_map<std::string, std::string> cl_ord_to_order_id_;
+    // Open order IDs by session, symbol and strategy_id, for mass cancels
+    OrderIndex by_session_;
+    OrderIndex by_symbol_;
+    OrderIndex by_strategy_;
+    std::unordered_set<std::string> day_orders_;  // open orders with TimeInForce::Day
+    // NewOrderSingle of each parked stop, for the reports once it triggers
+    std::unordered_map<std::string, fix::FixMessage> stop_requests_;
+    // Orders collected for a call auction, reported when an uncross fills them
+    struct AuctionOrder {
+        fix::FixMessage request;
+        Qty cum_qty;
+    };
+    std::unordered_map<std::string, AuctionOrder> auction_orders_;
+    std::vector<booking::Trade> trade_batch_;  // reused by book_fills
     uint64_t order_seq_ = 0;
     uint64_t fill_seq_ = 0;
     uint64_t trade_seq_ = 0;
+    uint64_t mass_cancel_seq_ = 0;
 };
 
 }  // namespace tradecore::orders
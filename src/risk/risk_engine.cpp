@@ -0,0 +1,116 @@
+#include "risk/risk_engine.hpp"
+
+#include <cmath>
+#include <sstream>
+
+#include <spdlog/spdlog.h>
+
+namespace tradecore::risk {
+
+namespace {
+
+std::string breach(const char* what, double value, double limit, const std::string& scope) {
+    std::ostringstream ss;
+    ss << "Risk: " << what << " " << value << " exceeds limit " << limit << " for " << scope;
+    return ss.str();
+}
+
+}  // namespace
+
+RiskEngine::RiskEngine(const booking::BookKeeper& book_keeper, LimitSet limits)
+    : book_keeper_(book_keeper) {
+    publish(std::move(limits));
+}
+
+void RiskEngine::publish(LimitSet limits) {
+    std::lock_guard<std::mutex> lock(publish_mutex_);
+    auto table = std::make_unique<Table>();
+    table->limits = std::move(limits);
+    table->generation = tables_.size() + 1;
+    table_.store(table.get(), std::memory_order_release);
+    tables_.push_back(std::move(table));
+    spdlog::info("[RISK] limits generation {} active ({} symbol, {} account overrides)",
+                 tables_.size(), tables_.back()->limits.symbols.size(),
+                 tables_.back()->limits.accounts.size());
+}
+
+std::string RiskEngine::check(const orders::Order& order, double reference_price,
+                              Clock::time_point now) {
+    const Table* table = table_.load(std::memory_order_acquire);
+
+    uint32_t sid = symbol_ids_.intern(order.instrument->symbol);
+    if (sid >= symbols_.size()) symbols_.resize(sid + 1);
+    auto& sym = symbols_[sid];
+    if (sym.generation != table->generation) {
+        sym.limits = &table->limits.for_symbol(order.instrument->symbol);
+        sym.generation = table->generation;
+    }
+    if (!sym.position) sym.position = book_keeper_.get_position(order.instrument->symbol);
+
+    uint32_t aid = account_ids_.intern(order.account);
+    if (aid >= accounts_.size()) accounts_.resize(aid + 1);
+    auto& acct = accounts_[aid];
+    if (acct.generation != table->generation) {
+        acct.limits = &table->limits.for_account(order.account);
+        acct.generation = table->generation;
+    }
+
+    const Limits& sl = *sym.limits;
+    const Limits& al = *acct.limits;
+
+    // Rate is counted first so rejected floods still consume the budget
+    if (al.max_orders_per_sec > 0) {
+        if (now - acct.window_start >= std::chrono::seconds(1)) {
+            acct.window_start = now;
+            acct.window_count = 0;
+        }
+        if (++acct.window_count > al.max_orders_per_sec) {
+            return breach("order rate", acct.window_count, al.max_orders_per_sec,
+                          "account '" + order.account + "'");
+        }
+    }
+
+    // Limits are configured as doubles; compare in double
+    double quantity = order.quantity.to_double();
+    if (sl.max_order_qty > 0.0 && quantity > sl.max_order_qty) {
+        return breach("OrderQty", quantity, sl.max_order_qty, order.instrument->symbol);
+    }
+
+    bool is_limit = order.order_type == orders::OrderType::Limit ||
+                    order.order_type == orders::OrderType::StopLimit;
+    double price = is_limit ? order.limit_price.to_double() : reference_price;
+    if (price > 0.0) {
+        // Limits are in the base currency
+        double notional = quantity * price * order.instrument->contract_size *
+                          book_keeper_.fx_rates().rate(order.instrument->currency);
+        if (sl.max_order_notional > 0.0 && notional > sl.max_order_notional) {
+            return breach("order notional", notional, sl.max_order_notional, order.instrument->symbol);
+        }
+        if (al.max_order_notional > 0.0 && notional > al.max_order_notional) {
+            return breach("order notional", notional, al.max_order_notional,
+                          "account '" + order.account + "'");
+        }
+    }
+
+    if (is_limit && sl.price_collar_bps > 0.0 && reference_price > 0.0) {
+        double deviation_bps = std::abs(price - reference_price) / reference_price * 10000.0;
+        if (deviation_bps > sl.price_collar_bps) {
+            return breach("price deviation (bps)", deviation_bps, sl.price_collar_bps,
+                          order.instrument->symbol);
+        }
+    }
+
+    if (sl.max_position > 0.0) {
+        double current = sym.position ? sym.position->quantity.to_double() : 0.0;
+        double projected = current + (order.side == orders::Side::Buy ? quantity : -quantity);
+        // Orders that reduce exposure are always allowed
+        if (std::abs(projected) > sl.max_position && std::abs(projected) > std::abs(current)) {
+            return breach("projected position", std::abs(projected), sl.max_position,
+                          order.instrument->symbol);
+        }
+    }
+
+    return "";
+}
+
+}  // namespace tradecore::risk
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "booking/book_keeper.hpp"
+#include "instrument/symbol_table.hpp"
+#include "orders/order.hpp"
+#include "risk/risk_limits.hpp"
+
+namespace tradecore::risk {
+
+/// Inline pre-trade checks run by OrderManager before matching: fat-finger
+/// quantity, order notional, price collar, position limit and per-account
+/// order rate.
+///
+/// Limits live in an immutable table that publish() swaps in through an atomic
+/// pointer, so a reload from any thread never blocks check(). Per-symbol and
+/// per-account state sits in flat vectors indexed by interned ID and caches the
+/// resolved limits until the table generation changes. Positions are read
+/// in place from the BookKeeper's Position entries rather than recomputed.
+class RiskEngine {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit RiskEngine(const booking::BookKeeper& book_keeper, LimitSet limits = {});
+
+    /// Replace the active limits. Safe to call from any thread.
+    void publish(LimitSet limits);
+
+    /// Generation of the active limit table (1 for the initial table).
+    uint64_t generation() const { return table_.load(std::memory_order_acquire)->generation; }
+
+    /// Check an order against the active limits. reference_price is the
+    /// current market price (0 if unknown: notional and collar checks on
+    /// market orders are then skipped). Returns empty string if the order
+    /// passes, otherwise the reason. Must be called from the order thread.
+    std::string check(const orders::Order& order, double reference_price,
+                      Clock::time_point now = Clock::now());
+
+private:
+    struct Table {
+        LimitSet limits;
+        uint64_t generation = 0;
+    };
+
+    struct SymbolState {
+        const Limits* limits = nullptr;
+        uint64_t generation = 0;
+        const booking::Position* position = nullptr;  // stable once the symbol has traded
+    };
+
+    struct AccountState {
+        const Limits* limits = nullptr;
+        uint64_t generation = 0;
+        Clock::time_point window_start{};
+        uint32_t window_count = 0;
+    };
+
+    const booking::BookKeeper& book_keeper_;
+    std::atomic<const Table*> table_{nullptr};
+
+    // Publishers only. Superseded tables are kept until shutdown so a reader
+    // holding an old pointer never touches freed memory; reloads are rare.
+    std::mutex publish_mutex_;
+    std::vector<std::unique_ptr<const Table>> tables_;
+
+    // Order thread only
+    instrument::SymbolTable symbol_ids_;
+    instrument::SymbolTable account_ids_;
+    std::vector<SymbolState> symbols_;    // index = symbol ID
+    std::vector<AccountState> accounts_;  // index = account ID
+};
+
+}  // namespace tradecore::risk
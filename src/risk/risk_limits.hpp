@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace tradecore::risk {
+
+/// Pre-trade limits. A value of 0 disables that check.
+/// Symbol entries use the per-order and position fields; account entries use
+/// max_order_notional and max_orders_per_sec.
+struct Limits {
+    double max_order_qty = 0.0;        // fat-finger quantity cap
+    double max_order_notional = 0.0;   // qty * price (reference price for market orders)
+    double price_collar_bps = 0.0;     // max limit-price distance from the reference price
+    double max_position = 0.0;         // max absolute net position after the order fills
+    uint32_t max_orders_per_sec = 0;   // per-account message rate throttle
+};
+
+/// A complete limit configuration: defaults plus full overrides by name.
+struct LimitSet {
+    Limits defaults;
+    std::unordered_map<std::string, Limits> symbols;
+    std::unordered_map<std::string, Limits> accounts;
+
+    const Limits& for_symbol(const std::string& symbol) const {
+        auto it = symbols.find(symbol);
+        return (it != symbols.end()) ? it->second : defaults;
+    }
+
+    const Limits& for_account(const std::string& account) const {
+        auto it = accounts.find(account);
+        return (it != accounts.end()) ? it->second : defaults;
+    }
+};
+
+}  // namespace tradecore::risk
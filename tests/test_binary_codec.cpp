@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include "messaging/binary_codec.hpp"
+#include "messaging/protocol.hpp"
+
+using namespace tradecore;
+using namespace tradecore::messaging;
+
+class BinaryCodecTest : public ::testing::Test {
+protected:
+    instrument::SymbolTable symbols;
+    std::unique_ptr<BinaryCodec> codec;
+    char buf[binary::kMaxFrameSize];
+
+    void SetUp() override {
+        symbols.intern("AAPL");
+        symbols.intern("MSFT");
+        codec = std::make_unique<BinaryCodec>(symbols);
+    }
+};
+
+TEST_F(BinaryCodecTest, NewOrderRoundtrip) {
+    binary::NewOrder nos;
+    nos.header.msg_type = binary::MsgType::NewOrder;
+    nos.header.length = sizeof(nos);
+    nos.header.seq_num = 42;
+    nos.symbol_id = 2;
+    nos.side = fix::SIDE_SELL;
+    nos.ord_type = fix::ORD_TYPE_LIMIT;
+    nos.time_in_force = fix::TIF_IOC;
+    nos.order_qty = 250 * binary::kScale;
+    nos.price = 30012500000;  // 300.125
+    std::strcpy(nos.cl_ord_id, "bin-001");
+    std::strcpy(nos.strategy_id, "mm_alpha");
+
+    ASSERT_TRUE(BinaryCodec::is_binary(&nos, sizeof(nos)));
+
+    fix::FixMessage msg;
+    ASSERT_TRUE(codec->decode(&nos, sizeof(nos), msg));
+    ASSERT_TRUE(msg.has_new_order_single());
+    const auto& decoded = msg.new_order_single();
+    EXPECT_EQ(msg.msg_seq_num(), "42");
+    EXPECT_EQ(decoded.cl_ord_id(), "bin-001");
+    EXPECT_EQ(decoded.instrument().symbol(), "MSFT");
+    EXPECT_EQ(decoded.side(), fix::SIDE_SELL);
+    EXPECT_EQ(decoded.ord_type(), fix::ORD_TYPE_LIMIT);
+    EXPECT_EQ(decoded.time_in_force(), fix::TIF_IOC);
+    EXPECT_EQ(decoded.order_qty(), 250.0);
+    EXPECT_DOUBLE_EQ(decoded.price(), 300.125);
+    EXPECT_EQ(decoded.text(), "mm_alpha");
+
+    // And back again
+    size_t n = codec->encode(msg, buf, sizeof(buf));
+    ASSERT_EQ(n, sizeof(binary::NewOrder));
+    binary::NewOrder again;
+    std::memcpy(&again, buf, sizeof(again));
+    EXPECT_EQ(again.symbol_id, 2u);
+    EXPECT_EQ(again.price, nos.price);
+    EXPECT_EQ(again.header.seq_num, 42u);
+}
+
+TEST_F(BinaryCodecTest, ExecutionReportRoundtrip) {
+    fix::FixMessage request;
+    request.set_msg_seq_num("7");
+    auto* nos = request.mutable_new_order_single();
+    nos->set_cl_ord_id("bin-002");
+    nos->mutable_instrument()->set_symbol("AAPL");
+    nos->set_side(fix::SIDE_BUY);
+    nos->set_order_qty(100.0);
+
+    auto report = make_execution_report_fill(request, "TC-00001", "F-00001",
+                                             150.08, 100.0, 0.0, 100.0, 15.008);
+    size_t n = codec->encode(report, buf, sizeof(buf));
+    ASSERT_EQ(n, sizeof(binary::ExecutionReport));
+
+    fix::FixMessage decoded;
+    ASSERT_TRUE(codec->decode(buf, n, decoded));
+    ASSERT_TRUE(decoded.has_execution_report());
+    const auto& er = decoded.execution_report();
+    EXPECT_EQ(er.order_id(), "TC-00001");
+    EXPECT_EQ(er.cl_ord_id(), "bin-002");
+    EXPECT_EQ(er.exec_id(), "F-00001");
+    EXPECT_EQ(er.exec_type(), fix::EXEC_TYPE_FILL);
+    EXPECT_EQ(er.instrument().symbol(), "AAPL");
+    EXPECT_DOUBLE_EQ(er.last_px(), 150.08);
+    EXPECT_EQ(er.last_qty(), 100.0);
+    EXPECT_NEAR(er.commission(), 15.008, 1e-8);
+}
+
+TEST_F(BinaryCodecTest, RejectCarriesRefSeqNum) {
+    fix::FixMessage request;
+    request.set_msg_seq_num("99");
+    auto rej = make_reject(request, "OrderQty (tag 38) must be positive");
+
+    size_t n = codec->encode(rej, buf, sizeof(buf));
+    ASSERT_EQ(n, sizeof(binary::Reject));
+
+    fix::FixMessage decoded;
+    ASSERT_TRUE(codec->decode(buf, n, decoded));
+    ASSERT_TRUE(decoded.has_reject());
+    EXPECT_EQ(decoded.reject().ref_msg_seq_num(), "99");
+    EXPECT_EQ(decoded.reject().text(), "OrderQty (tag 38) must be positive");
+}
+
+TEST_F(BinaryCodecTest, ProtobufIsNotBinary) {
+    fix::FixMessage msg;
+    msg.set_sender_comp_id("CLIENT");
+    msg.mutable_heartbeat();
+    auto bytes = serialize(msg);
+    EXPECT_FALSE(BinaryCodec::is_binary(bytes.data(), bytes.size()));
+}
+
+TEST_F(BinaryCodecTest, RejectsUnknownSymbolAndShortFrames) {
+    binary::NewOrder nos;
+    nos.symbol_id = 17;
+    fix::FixMessage msg;
+    EXPECT_FALSE(codec->decode(&nos, sizeof(nos), msg));
+
+    nos.symbol_id = 1;
+    EXPECT_FALSE(codec->decode(&nos, sizeof(nos) - 1, msg));
+    EXPECT_TRUE(codec->decode(&nos, sizeof(nos), msg));
+}
+
+TEST_F(BinaryCodecTest, HeaderCarriesGivenSeqNum) {
+    fix::FixMessage request;
+    request.set_msg_seq_num("3f2c9a1e-uuid");
+    auto rej = make_reject(request, "rejected");
+
+    binary::Reject out;
+    ASSERT_EQ(codec->encode(rej, buf, sizeof(buf)), sizeof(out));
+    std::memcpy(&out, buf, sizeof(out));
+    EXPECT_EQ(out.header.seq_num, 0u);  // a UUID is not a sequence number
+
+    ASSERT_EQ(codec->encode(rej, 12, buf, sizeof(buf)), sizeof(out));
+    std::memcpy(&out, buf, sizeof(out));
+    EXPECT_EQ(out.header.seq_num, 12u);
+}
+
+TEST_F(BinaryCodecTest, PositionReportHasNoBinaryForm) {
+    fix::FixMessage msg;
+    msg.mutable_position_report();
+    EXPECT_EQ(codec->encode(msg, buf, sizeof(buf)), 0u);
+}
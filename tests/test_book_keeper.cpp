@@ -2,10 +2,11 @@
 #include "booking/book_keeper.hpp"
 
 using namespace tradecore::booking;
+using tradecore::orders::Side;
 
 namespace {
 
-Trade make_trade(const std::string& symbol, const std::string& side,
+Trade make_trade(const std::string& symbol, Side side,
                  double qty, double price, const std::string& trade_id = "T-001") {
     Trade trade;
     trade.trade_id = trade_id;
@@ -13,8 +14,8 @@ Trade make_trade(const std::string& symbol, const std::string& side,
     trade.cl_ord_id = "test-001";
     trade.symbol = symbol;
     trade.side = side;
-    trade.quantity = qty;
-    trade.price = price;
+    trade.quantity = Qty(qty);
+    trade.price = Price(price);
     trade.commission = 0.0;
     trade.timestamp = "2024-01-01T00:00:00Z";
     trade.strategy_id = "test_strat";
@@ -25,40 +26,40 @@ Trade make_trade(const std::string& symbol, const std::string& side,
 
 TEST(BookKeeper, BookTradeCreatesPosition) {
     BookKeeper keeper;
-    keeper.book_trade(make_trade("AAPL", "buy", 100, 150.0));
+    keeper.book_trade(make_trade("AAPL", Side::Buy, 100, 150.0));
 
     auto* pos = keeper.get_position("AAPL");
     ASSERT_NE(pos, nullptr);
-    EXPECT_EQ(pos->quantity, 100.0);
+    EXPECT_EQ(pos->quantity, Qty(100.0));
     EXPECT_EQ(pos->avg_price, 150.0);
 }
 
 TEST(BookKeeper, BookMultipleTradesSameSymbol) {
     BookKeeper keeper;
-    keeper.book_trade(make_trade("AAPL", "buy", 100, 150.0, "T-001"));
-    keeper.book_trade(make_trade("AAPL", "buy", 100, 160.0, "T-002"));
+    keeper.book_trade(make_trade("AAPL", Side::Buy, 100, 150.0, "T-001"));
+    keeper.book_trade(make_trade("AAPL", Side::Buy, 100, 160.0, "T-002"));
 
     auto* pos = keeper.get_position("AAPL");
     ASSERT_NE(pos, nullptr);
-    EXPECT_EQ(pos->quantity, 200.0);
+    EXPECT_EQ(pos->quantity, Qty(200.0));
     EXPECT_DOUBLE_EQ(pos->avg_price, 155.0);  // (15000+16000)/200
 }
 
 TEST(BookKeeper, BookBuySellCalculatesPnL) {
     BookKeeper keeper;
-    keeper.book_trade(make_trade("AAPL", "buy", 100, 150.0, "T-001"));
-    keeper.book_trade(make_trade("AAPL", "sell", 100, 160.0, "T-002"));
+    keeper.book_trade(make_trade("AAPL", Side::Buy, 100, 150.0, "T-001"));
+    keeper.book_trade(make_trade("AAPL", Side::Sell, 100, 160.0, "T-002"));
 
     auto* pos = keeper.get_position("AAPL");
     ASSERT_NE(pos, nullptr);
-    EXPECT_EQ(pos->quantity, 0.0);
+    EXPECT_EQ(pos->quantity, Qty(0.0));
     EXPECT_DOUBLE_EQ(pos->realized_pnl, 1000.0);
 }
 
 TEST(BookKeeper, TradeHistory) {
     BookKeeper keeper;
-    keeper.book_trade(make_trade("AAPL", "buy", 100, 150.0, "T-001"));
-    keeper.book_trade(make_trade("MSFT", "buy", 50, 300.0, "T-002"));
+    keeper.book_trade(make_trade("AAPL", Side::Buy, 100, 150.0, "T-001"));
+    keeper.book_trade(make_trade("MSFT", Side::Buy, 50, 300.0, "T-002"));
 
     EXPECT_EQ(keeper.trade_count(), 2);
     EXPECT_EQ(keeper.get_trades()[0].symbol, "AAPL");
@@ -67,8 +68,8 @@ TEST(BookKeeper, TradeHistory) {
 
 TEST(BookKeeper, GetAllPositions) {
     BookKeeper keeper;
-    keeper.book_trade(make_trade("AAPL", "buy", 100, 150.0, "T-001"));
-    keeper.book_trade(make_trade("MSFT", "buy", 50, 300.0, "T-002"));
+    keeper.book_trade(make_trade("AAPL", Side::Buy, 100, 150.0, "T-001"));
+    keeper.book_trade(make_trade("MSFT", Side::Buy, 50, 300.0, "T-002"));
 
     auto positions = keeper.get_all_positions();
     EXPECT_EQ(positions.size(), 2);
@@ -81,10 +82,244 @@ TEST(BookKeeper, NoPositionReturnsNull) {
 
 TEST(BookKeeper, ShortPosition) {
     BookKeeper keeper;
-    keeper.book_trade(make_trade("AAPL", "sell", 100, 150.0, "T-001"));
+    keeper.book_trade(make_trade("AAPL", Side::Sell, 100, 150.0, "T-001"));
 
     auto* pos = keeper.get_position("AAPL");
     ASSERT_NE(pos, nullptr);
-    EXPECT_EQ(pos->quantity, -100.0);
+    EXPECT_EQ(pos->quantity, Qty(-100.0));
     EXPECT_EQ(pos->avg_price, 150.0);
 }
+
+TEST(BookKeeper, FlipThroughFlatReopensAtFillPrice) {
+    BookKeeper keeper;
+    keeper.book_trade(make_trade("AAPL", Side::Buy, 100, 150.0, "T-001"));
+    keeper.book_trade(make_trade("AAPL", Side::Sell, 40, 160.0, "T-002"));
+
+    auto* pos = keeper.get_position("AAPL");
+    EXPECT_EQ(pos->quantity, Qty(60.0));
+    EXPECT_DOUBLE_EQ(pos->avg_price, 150.0);  // reducing keeps the cost
+    EXPECT_DOUBLE_EQ(pos->realized_pnl, 400.0);
+
+    // Closes the 60 long at a 5 loss each, then opens 40 short at 145
+    keeper.book_trade(make_trade("AAPL", Side::Sell, 100, 145.0, "T-003"));
+    EXPECT_EQ(pos->quantity, Qty(-40.0));
+    EXPECT_DOUBLE_EQ(pos->avg_price, 145.0);
+    EXPECT_DOUBLE_EQ(pos->cost_basis, 5800.0);
+    EXPECT_DOUBLE_EQ(pos->realized_pnl, 100.0);
+}
+
+TEST(BookKeeper, BookTradesMatchesOneAtATime) {
+    std::vector<Trade> batch = {
+        make_trade("AAPL", Side::Buy, 100, 150.0, "T-001"),
+        make_trade("AAPL", Side::Buy, 50, 156.0, "T-002"),
+        make_trade("MSFT", Side::Sell, 20, 300.0, "T-003"),
+        make_trade("AAPL", Side::Sell, 200, 149.0, "T-004"),
+    };
+    BookKeeper batched, single;
+    batched.book_trades(batch);
+    for (const auto& trade : batch) single.book_trade(trade);
+
+    EXPECT_EQ(batched.trade_count(), 4);
+    EXPECT_EQ(batched.get_trades()[3].trade_id, "T-004");
+    for (const auto* symbol : {"AAPL", "MSFT"}) {
+        const auto* a = batched.get_position(symbol);
+        const auto* b = single.get_position(symbol);
+        ASSERT_NE(a, nullptr);
+        EXPECT_EQ(a->quantity, b->quantity);
+        EXPECT_DOUBLE_EQ(a->avg_price, b->avg_price);
+        EXPECT_DOUBLE_EQ(a->realized_pnl, b->realized_pnl);
+    }
+    EXPECT_EQ(batched.get_position("AAPL")->quantity, Qty(-50.0));
+    EXPECT_DOUBLE_EQ(batched.get_position("AAPL")->avg_price, 149.0);
+}
+
+TEST(BookKeeper, LedgerRollsUpStrategyAccountAndFirm) {
+    BookKeeper keeper;
+    auto trade = [&](const std::string& account, const std::string& strategy, Side side,
+                     double qty, double price) {
+        auto t = make_trade("AAPL", side, qty, price);
+        t.account = account;
+        t.strategy_id = strategy;
+        return t;
+    };
+    keeper.book_trade(trade("ACC1", "momo", Side::Buy, 100, 150.0));
+    keeper.book_trade(trade("ACC1", "mr", Side::Sell, 40, 155.0));
+    keeper.book_trades({trade("ACC2", "momo", Side::Buy, 10, 150.0),
+                        trade("ACC2", "momo", Side::Sell, 10, 152.0)});
+
+    const auto& ledger = keeper.ledger();
+    const auto* momo = ledger.strategy("ACC1", "momo");
+    ASSERT_NE(momo, nullptr);
+    EXPECT_EQ(ledger.position(*momo, "AAPL")->quantity, Qty(100.0));
+    EXPECT_EQ(ledger.position(*ledger.strategy("ACC1", "mr"), "AAPL")->quantity, Qty(-40.0));
+
+    // The account nets its strategies: the short closes part of the long
+    auto acc1 = keeper.get_account_positions("ACC1");
+    ASSERT_EQ(acc1.size(), 1);
+    EXPECT_EQ(acc1[0].quantity, Qty(60.0));
+    EXPECT_DOUBLE_EQ(acc1[0].realized_pnl, 200.0);
+    EXPECT_DOUBLE_EQ(ledger.account("ACC1")->realized_pnl, 200.0);
+
+    EXPECT_EQ(keeper.get_position("AAPL")->quantity, Qty(60.0));
+    EXPECT_DOUBLE_EQ(ledger.firm().realized_pnl, 220.0);
+    EXPECT_EQ(keeper.get_strategy_positions("ACC2", "momo")[0].quantity, Qty(0.0));
+    EXPECT_TRUE(keeper.get_account_positions("NOPE").empty());
+    EXPECT_EQ(ledger.strategy("ACC1", "NOPE"), nullptr);
+}
+
+TEST(BookKeeper, PnlAppliesMultiplierAndConvertsToBaseCurrency) {
+    BookKeeper keeper;
+    MarkToMarket valuation;
+    keeper.set_valuation(&valuation);
+
+    tradecore::instrument::Instrument es;
+    es.symbol = "ESZ4";
+    es.asset_class = tradecore::instrument::AssetClass::Future;
+    es.contract_size = 50.0;
+    keeper.book_trades({make_trade("ESZ4", Side::Buy, 2, 4000.0),
+                        make_trade("ESZ4", Side::Sell, 2, 4010.0)}, es);
+    EXPECT_DOUBLE_EQ(keeper.get_position("ESZ4")->realized_pnl, 1000.0);
+
+    tradecore::instrument::Instrument sap;
+    sap.symbol = "SAP";
+    sap.currency = "EUR";
+    keeper.book_trade(make_trade("SAP", Side::Buy, 10, 100.0), sap);
+
+    // An EURUSD fill sets the EUR rate and re-caches it on the open SAP row
+    tradecore::instrument::Instrument eurusd;
+    eurusd.symbol = "EURUSD";
+    eurusd.asset_class = tradecore::instrument::AssetClass::FX;
+    keeper.book_trade(make_trade("EURUSD", Side::Buy, 1000, 1.10), eurusd);
+    EXPECT_DOUBLE_EQ(keeper.fx_rates().rate("EUR"), 1.10);
+    EXPECT_DOUBLE_EQ(keeper.get_position("SAP")->fx_rate, 1.10);
+
+    valuation.on_mark("SAP", 105.0);
+    EXPECT_NEAR(valuation.unrealized_pnl("SAP"), 55.0, 1e-9);
+
+    keeper.book_trade(make_trade("SAP", Side::Sell, 10, 110.0), sap);
+    const auto* pos = keeper.get_position("SAP");
+    EXPECT_DOUBLE_EQ(pos->realized_pnl, 100.0);        // EUR
+    EXPECT_NEAR(pos->realized_pnl_base, 110.0, 1e-9);  // USD
+    EXPECT_NEAR(keeper.ledger().firm().realized_pnl, 1110.0, 1e-9);
+}
+
+TEST(FxRates, CrossPairConvertsThroughKnownLeg) {
+    FxRates rates("USD");
+    tradecore::instrument::Instrument pair;
+    pair.asset_class = tradecore::instrument::AssetClass::FX;
+
+    pair.symbol = "EUR/JPY";
+    EXPECT_FALSE(rates.on_trade(pair, 160.0).has_value());  // neither leg known yet
+
+    pair.symbol = "USDJPY";
+    EXPECT_EQ(rates.on_trade(pair, 150.0), "JPY");
+    EXPECT_DOUBLE_EQ(rates.rate("JPY"), 1.0 / 150.0);
+
+    pair.symbol = "EUR/JPY";
+    EXPECT_EQ(rates.on_trade(pair, 165.0), "EUR");
+    EXPECT_DOUBLE_EQ(rates.rate("EUR"), 165.0 / 150.0);
+    EXPECT_DOUBLE_EQ(rates.rate("USD"), 1.0);
+}
+
+TEST(BookKeeper, PositionAddressStableAsLedgerGrows) {
+    BookKeeper keeper;
+    keeper.book_trade(make_trade("AAPL", Side::Buy, 100, 150.0));
+    const Position* aapl = keeper.get_position("AAPL");
+    for (int i = 0; i < 1000; ++i) {
+        keeper.book_trade(make_trade("SYM" + std::to_string(i), Side::Buy, 1, 10.0));
+    }
+    keeper.book_trade(make_trade("AAPL", Side::Buy, 50, 150.0));
+    EXPECT_EQ(keeper.get_position("AAPL"), aapl);
+    EXPECT_EQ(aapl->quantity, Qty(150.0));
+}
+
+TEST(BookKeeper, PublishesPositionSnapshotsAtEveryLevel) {
+    BookKeeper keeper;
+    PositionSnapshots snapshots;
+    keeper.set_snapshots(&snapshots);
+
+    auto t = make_trade("AAPL", Side::Buy, 100, 150.0);
+    t.account = "ACC1";
+    keeper.book_trade(t);
+    t.side = Side::Sell;
+    t.quantity = Qty(40.0);
+    t.price = Price(155.0);
+    keeper.book_trade(t);
+
+    PositionSnapshot snap;
+    ASSERT_TRUE(snapshots.load("AAPL", snap));
+    EXPECT_EQ(snap.quantity, Qty(60.0));
+    ASSERT_TRUE(snapshots.load(BookKeeper::account_key("ACC1", "AAPL"), snap));
+    EXPECT_DOUBLE_EQ(snap.realized_pnl, 200.0);
+    ASSERT_TRUE(snapshots.load(BookKeeper::strategy_key("ACC1", "test_strat", "AAPL"), snap));
+    EXPECT_EQ(snap.quantity, Qty(60.0));
+    EXPECT_FALSE(snapshots.load(BookKeeper::account_key("NOPE", "AAPL"), snap));
+
+    // A new FX rate is republished on every row in that currency
+    tradecore::instrument::Instrument sap;
+    sap.symbol = "SAP";
+    sap.currency = "EUR";
+    keeper.book_trade(make_trade("SAP", Side::Buy, 10, 120.0), sap);
+    keeper.set_fx_rate("EUR", 1.10);
+    ASSERT_TRUE(snapshots.load("SAP", snap));
+    EXPECT_DOUBLE_EQ(snap.fx_rate, 1.10);
+    ASSERT_TRUE(snapshots.load(BookKeeper::strategy_key("", "test_strat", "SAP"), snap));
+    EXPECT_DOUBLE_EQ(snap.fx_rate, 1.10);
+    ASSERT_TRUE(snapshots.load("AAPL", snap));
+    EXPECT_DOUBLE_EQ(snap.fx_rate, 1.0);
+}
+
+TEST(BookKeeper, IndexedTradeQueries) {
+    BookKeeper keeper;
+    auto trade = [](const std::string& symbol, const std::string& strategy,
+                    const std::string& order_id, const std::string& time) {
+        auto t = make_trade(symbol, Side::Buy, 10, 100.0);
+        t.strategy_id = strategy;
+        t.order_id = order_id;
+        t.timestamp = time;
+        return t;
+    };
+    keeper.book_trade(trade("AAPL", "momo", "TC-1", "20240101-09:30:00.000"));
+    keeper.book_trades({trade("MSFT", "momo", "TC-2", "20240101-09:31:00.000"),
+                        trade("MSFT", "momo", "TC-2", "20240101-09:31:00.000")});
+    keeper.book_trade(trade("AAPL", "mr", "TC-3", "20240101-09:32:00.000"));
+    keeper.book_trade(trade("AAPL", "momo", "TC-4", "20240101-09:33:00.000"));
+
+    auto aapl = keeper.trades_for_symbol("AAPL");
+    ASSERT_EQ(aapl.size(), 3);
+    EXPECT_EQ(aapl[0].order_id, "TC-1");
+    EXPECT_EQ(aapl.position(2), 4u);
+
+    auto recent = keeper.trades_for_strategy_symbol("momo", "AAPL", "20240101-09:31:00.000");
+    ASSERT_EQ(recent.size(), 1);
+    EXPECT_EQ(recent[0].order_id, "TC-4");
+    EXPECT_EQ(&recent[0], &keeper.get_trades()[4]);  // a view, not a copy
+
+    EXPECT_EQ(keeper.trades_for_strategy("momo", {}, "20240101-09:33:00.000").size(), 3);
+    EXPECT_EQ(keeper.trades_for_order("TC-2").size(), 2);
+    EXPECT_EQ(keeper.trades_between("20240101-09:31:00.000", "20240101-09:32:00.001").size(), 3);
+    EXPECT_TRUE(keeper.trades_for_symbol("NOPE").empty());
+    EXPECT_TRUE(keeper.trades_for_strategy_symbol("mr", "MSFT").empty());
+
+    size_t momo = 0;
+    for (const auto& t : keeper.trades_for_strategy("momo")) momo += t.strategy_id == "momo";
+    EXPECT_EQ(momo, 4u);
+}
+
+TEST(BookKeeper, TradeTimestampsNeverGoBack) {
+    BookKeeper keeper;
+    auto trade = [](const std::string& time) {
+        auto t = make_trade("AAPL", Side::Buy, 10, 100.0);
+        t.timestamp = time;
+        return t;
+    };
+    // The wall clock stepped back a second between the first and second trade
+    keeper.book_trade(trade("20240101-09:30:01.000"));
+    keeper.book_trades({trade("20240101-09:30:00.000"), trade("20240101-09:30:01.500")});
+
+    const auto& log = keeper.get_trades();
+    EXPECT_EQ(log[1].timestamp, "20240101-09:30:01.000");
+    EXPECT_EQ(log[2].timestamp, "20240101-09:30:01.500");
+    EXPECT_EQ(keeper.trades_between("20240101-09:30:01.000").size(), 3);
+    EXPECT_TRUE(keeper.trades_between({}, "20240101-09:30:01.000").empty());
+}
@@ -30,8 +30,12 @@ TEST_F(ConfigTest, DefaultValues) {
     auto cfg = Config::defaults();
     EXPECT_EQ(cfg.server.bind_address, "tcp://*:5555");
     EXPECT_EQ(cfg.server.poll_timeout_ms, 100);
+    EXPECT_TRUE(cfg.server.query_bind_address.empty());
     EXPECT_EQ(cfg.matching.spread_bps, 10.0);
     EXPECT_EQ(cfg.commission.rate, 0.001);
+    EXPECT_EQ(cfg.booking.base_currency, "USD");
+    EXPECT_TRUE(cfg.booking.archive_path.empty());
+    EXPECT_TRUE(cfg.instruments.reference_file.empty());
     EXPECT_EQ(cfg.logging.level, "info");
     EXPECT_TRUE(cfg.metrics.enabled);
 }
@@ -41,10 +45,19 @@ TEST_F(ConfigTest, LoadFromFile) {
 [server]
 bind_address = "tcp://*:6666"
 poll_timeout_ms = 200
+query_bind_address = "tcp://*:6667"
 
 [commission]
 rate = 0.002
 
+[instruments]
+reference_file = "config/instruments.csv"
+
+[booking]
+base_currency = "EUR"
+position_update_interval_ms = 250
+archive_path = "data/trades.tca"
+
 [logging]
 level = "debug"
 )");
@@ -52,7 +65,12 @@ level = "debug"
     auto cfg = Config::load(path);
     EXPECT_EQ(cfg.server.bind_address, "tcp://*:6666");
     EXPECT_EQ(cfg.server.poll_timeout_ms, 200);
+    EXPECT_EQ(cfg.server.query_bind_address, "tcp://*:6667");
     EXPECT_EQ(cfg.commission.rate, 0.002);
+    EXPECT_EQ(cfg.instruments.reference_file, "config/instruments.csv");
+    EXPECT_EQ(cfg.booking.base_currency, "EUR");
+    EXPECT_EQ(cfg.booking.position_update_interval_ms, 250);
+    EXPECT_EQ(cfg.booking.archive_path, "data/trades.tca");
     EXPECT_EQ(cfg.logging.level, "debug");
     // Unset values use defaults
     EXPECT_EQ(cfg.matching.spread_bps, 10.0);
@@ -97,3 +115,104 @@ depth_levels = 10
     EXPECT_EQ(cfg.server.bind_address, "tcp://*:5555");
     EXPECT_EQ(cfg.commission.rate, 0.001);
 }
+
+TEST_F(ConfigTest, LiquidityModelKeys) {
+    auto path = write_toml(R"(
+[matching]
+depth_profile = "decay"
+depth_decay = 0.5
+tick_aligned = true
+replenish = true
+self_trade_prevention = "cancel_resting"
+)");
+
+    auto cfg = Config::load(path);
+    EXPECT_EQ(cfg.matching.depth_profile, "decay");
+    EXPECT_EQ(cfg.matching.depth_decay, 0.5);
+    EXPECT_TRUE(cfg.matching.tick_aligned);
+    EXPECT_TRUE(cfg.matching.replenish);
+    EXPECT_EQ(cfg.matching.self_trade_prevention, "cancel_resting");
+    EXPECT_EQ(cfg.matching.self_trade_key, "strategy");
+    EXPECT_EQ(cfg.matching.depth_levels, 5);
+}
+
+TEST_F(ConfigTest, BinaryWireSymbols) {
+    auto path = write_toml(R"(
+[binary]
+enabled = true
+symbols = ["AAPL", "MSFT", "ESZ5"]
+)");
+
+    auto cfg = Config::load(path);
+    EXPECT_TRUE(cfg.binary.enabled);
+    ASSERT_EQ(cfg.binary.symbols.size(), 3);
+    EXPECT_EQ(cfg.binary.symbols[2], "ESZ5");
+}
+
+TEST_F(ConfigTest, DayOrderExpiry) {
+    EXPECT_TRUE(Config::defaults().orders.day_end_utc.empty());
+    auto path = write_toml(R"(
+[orders]
+day_end_utc = "21:00"
+)");
+    EXPECT_EQ(Config::load(path).orders.day_end_utc, "21:00");
+}
+
+TEST_F(ConfigTest, AuctionSymbols) {
+    EXPECT_TRUE(Config::defaults().auction.symbols.empty());
+    auto path = write_toml(R"(
+[auction]
+symbols = ["AAPL", "MSFT"]
+interval_ms = 250
+)");
+    auto cfg = Config::load(path);
+    ASSERT_EQ(cfg.auction.symbols.size(), 2);
+    EXPECT_EQ(cfg.auction.symbols[1], "MSFT");
+    EXPECT_EQ(cfg.auction.interval_ms, 250);
+}
+
+TEST_F(ConfigTest, RiskLimitOverrides) {
+    auto path = write_toml(R"(
+[risk]
+enabled = true
+max_order_qty = 1000
+max_orders_per_sec = 50
+
+[risk.symbols.AAPL]
+max_order_qty = 5000.0
+price_collar_bps = 200.0
+
+[risk.accounts.ACC1]
+max_order_notional = 1000000.0
+)");
+
+    auto cfg = Config::load(path);
+    EXPECT_TRUE(cfg.risk.enabled);
+    EXPECT_EQ(cfg.risk.limits.defaults.max_order_qty, 1000.0);
+    const auto& aapl = cfg.risk.limits.for_symbol("AAPL");
+    EXPECT_EQ(aapl.max_order_qty, 5000.0);
+    EXPECT_EQ(aapl.price_collar_bps, 200.0);
+    EXPECT_EQ(aapl.max_orders_per_sec, 50u);  // inherited
+    EXPECT_EQ(cfg.risk.limits.for_symbol("MSFT").max_order_qty, 1000.0);
+    EXPECT_EQ(cfg.risk.limits.for_account("ACC1").max_order_notional, 1000000.0);
+}
+
+TEST_F(ConfigTest, ReloadKeepsLimitsOnBadFile) {
+    auto path = write_toml(R"(
+[risk]
+max_order_qty = 1000
+)");
+    auto limits = Config::load(path).risk.limits;
+
+    write_toml("[risk\nmax_order_qty = ");
+    std::string error;
+    auto reloaded = Config::try_load(path, error);
+    if (reloaded) limits = reloaded->risk.limits;
+    EXPECT_FALSE(reloaded);
+    EXPECT_FALSE(error.empty());
+    EXPECT_EQ(limits.defaults.max_order_qty, 1000.0);
+
+    error.clear();
+    EXPECT_FALSE(Config::try_load("/nonexistent/path.toml", error));
+    EXPECT_NE(error.find("not found"), std::string::npos);
+}
@@ -0,0 +1,242 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include "messaging/fix_codec.hpp"
+#include "messaging/protocol.hpp"
+
+using namespace tradecore::messaging;
+
+namespace {
+
+// Tests write '|' for SOH
+std::string soh(std::string s) {
+    std::replace(s.begin(), s.end(), '|', kSoh);
+    return s;
+}
+
+std::string frame(const std::string& msg_type, const std::string& body, uint64_t seq = 1) {
+    std::string out;
+    build_fix(msg_type, "CLIENT1", "TRADECORE", seq, soh(body), out);
+    return out;
+}
+
+}  // namespace
+
+TEST(FixCodecTest, ChecksumMatchesScalarSum) {
+    std::string data(1000, '\0');
+    unsigned sum = 0;
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<char>(i * 7 + 3);
+        sum += static_cast<uint8_t>(data[i]);
+    }
+    EXPECT_EQ(fix_checksum(data.data(), data.size()), sum % 256);
+    EXPECT_EQ(fix_checksum(data.data(), 5), (3u + 10 + 17 + 24 + 31) % 256);
+}
+
+TEST(FixCodecTest, ParsesFramedMessage) {
+    auto wire = frame("D", "11=ord-1|55=AAPL|54=1|38=100|40=2|44=150.25|");
+
+    FixMessageView view;
+    size_t consumed = 0;
+    ASSERT_EQ(parse_fix(wire, view, consumed), FixParseStatus::Ok);
+    EXPECT_EQ(consumed, wire.size());
+    EXPECT_EQ(view.msg_type(), "D");
+    EXPECT_EQ(view.get(49), "CLIENT1");
+    EXPECT_EQ(view.get(11), "ord-1");
+    EXPECT_EQ(view.get(44), "150.25");
+    EXPECT_TRUE(view.get(999).empty());
+    EXPECT_EQ(view.field(0).tag, 8);
+    EXPECT_EQ(view.field(view.field_count() - 1).tag, 10);
+
+    // Field values are views into the input buffer
+    EXPECT_GE(view.get(11).data(), wire.data());
+    EXPECT_LT(view.get(11).data(), wire.data() + wire.size());
+}
+
+TEST(FixCodecTest, ValueMayContainEquals) {
+    auto wire = frame("D", "11=ord-1|58=a=b=c|55=AAPL|");
+    FixMessageView view;
+    size_t consumed = 0;
+    ASSERT_EQ(parse_fix(wire, view, consumed), FixParseStatus::Ok);
+    EXPECT_EQ(view.get(58), "a=b=c");
+    EXPECT_EQ(view.get(55), "AAPL");
+}
+
+TEST(FixCodecTest, IncompleteUntilWholeFrameArrives) {
+    auto wire = frame("0", "");
+    FixMessageView view;
+    size_t consumed = 0;
+    for (size_t n = 0; n < wire.size(); ++n) {
+        EXPECT_EQ(parse_fix(std::string_view(wire).substr(0, n), view, consumed),
+                  FixParseStatus::Incomplete) << "prefix " << n;
+    }
+
+    // Two frames back to back: only the first is consumed
+    auto two = wire + frame("0", "", 2);
+    ASSERT_EQ(parse_fix(two, view, consumed), FixParseStatus::Ok);
+    EXPECT_EQ(consumed, wire.size());
+    ASSERT_EQ(parse_fix(std::string_view(two).substr(consumed), view, consumed), FixParseStatus::Ok);
+    EXPECT_EQ(view.get(34), "2");
+}
+
+TEST(FixCodecTest, RejectsBadChecksumAndFraming) {
+    auto wire = frame("0", "112=abc|");
+    FixMessageView view;
+    size_t consumed = 0;
+
+    auto bad_sum = wire;
+    bad_sum[bad_sum.size() - 2] = (bad_sum[bad_sum.size() - 2] == '0') ? '1' : '0';
+    EXPECT_EQ(parse_fix(bad_sum, view, consumed), FixParseStatus::BadChecksum);
+    EXPECT_EQ(consumed, wire.size());
+
+    auto bad_len = wire;
+    bad_len.insert(bad_len.find("112="), "X");
+    EXPECT_EQ(parse_fix(bad_len, view, consumed), FixParseStatus::BadBodyLength);
+
+    EXPECT_EQ(parse_fix(soh("8=FIX.4.2|9=5|35=0|10=000|"), view, consumed),
+              FixParseStatus::BadBeginString);
+}
+
+TEST(FixCodecTest, RejectsFieldWithoutTag) {
+    std::string body = soh("35=0|=oops|");
+    std::string wire = soh("8=FIX.4.4|9=") + std::to_string(body.size()) + soh("|") + body;
+    char trailer[8];
+    std::snprintf(trailer, sizeof(trailer), "10=%03u", fix_checksum(wire.data(), wire.size()));
+    wire += trailer;
+    wire += kSoh;
+
+    FixMessageView view;
+    size_t consumed = 0;
+    EXPECT_EQ(parse_fix(wire, view, consumed), FixParseStatus::Malformed);
+    EXPECT_EQ(consumed, wire.size());
+}
+
+TEST(FixCodecTest, NewOrderSingleToProto) {
+    auto wire = frame("D", "11=ord-7|1=ACC1|55=ESZ6|167=FUT|207=CME|15=USD|54=2|38=5|40=2|"
+                           "44=4501.25|59=3|58=mm_alpha|60=20260101-12:00:00.000|", 7);
+    FixMessageView view;
+    size_t consumed = 0;
+    ASSERT_EQ(parse_fix(wire, view, consumed), FixParseStatus::Ok);
+
+    fix::FixMessage msg;
+    ASSERT_EQ(fix_to_proto(view, msg), "");
+    ASSERT_TRUE(msg.has_new_order_single());
+    const auto& nos = msg.new_order_single();
+    EXPECT_EQ(msg.sender_comp_id(), "CLIENT1");
+    EXPECT_EQ(msg.msg_seq_num(), "7");
+    EXPECT_EQ(nos.cl_ord_id(), "ord-7");
+    EXPECT_EQ(nos.account(), "ACC1");
+    EXPECT_EQ(nos.instrument().symbol(), "ESZ6");
+    EXPECT_EQ(nos.instrument().security_type(), fix::SECURITY_TYPE_FUTURE);
+    EXPECT_EQ(nos.instrument().exchange(), "CME");
+    EXPECT_EQ(nos.side(), fix::SIDE_SELL);
+    EXPECT_EQ(nos.order_qty(), 5.0);
+    EXPECT_EQ(nos.ord_type(), fix::ORD_TYPE_LIMIT);
+    EXPECT_DOUBLE_EQ(nos.price(), 4501.25);
+    EXPECT_EQ(nos.time_in_force(), fix::TIF_IOC);
+    EXPECT_EQ(nos.text(), "mm_alpha");
+}
+
+TEST(FixCodecTest, CancelReplaceAndUnsupportedToProto) {
+    FixMessageView view;
+    size_t consumed = 0;
+    fix::FixMessage msg;
+
+    auto cancel = frame("F", "11=c-1|41=ord-1|55=AAPL|54=1|38=100|");
+    ASSERT_EQ(parse_fix(cancel, view, consumed), FixParseStatus::Ok);
+    ASSERT_EQ(fix_to_proto(view, msg), "");
+    ASSERT_TRUE(msg.has_order_cancel_request());
+    EXPECT_EQ(msg.order_cancel_request().orig_cl_ord_id(), "ord-1");
+
+    auto replace = frame("G", "11=c-2|41=ord-1|55=AAPL|54=1|38=50|40=2|44=151.5|");
+    ASSERT_EQ(parse_fix(replace, view, consumed), FixParseStatus::Ok);
+    ASSERT_EQ(fix_to_proto(view, msg), "");
+    ASSERT_TRUE(msg.has_order_cancel_replace_request());
+    EXPECT_EQ(msg.order_cancel_replace_request().orig_cl_ord_id(), "ord-1");
+    EXPECT_DOUBLE_EQ(msg.order_cancel_replace_request().price(), 151.5);
+
+    auto unknown = frame("ZZ", "");
+    ASSERT_EQ(parse_fix(unknown, view, consumed), FixParseStatus::Ok);
+    EXPECT_FALSE(fix_to_proto(view, msg).empty());
+}
+
+TEST(FixCodecTest, ExecutionReportToFix) {
+    fix::FixMessage request;
+    auto* nos = request.mutable_new_order_single();
+    nos->set_cl_ord_id("ord-1");
+    nos->mutable_instrument()->set_symbol("AAPL");
+    nos->set_side(fix::SIDE_BUY);
+    nos->set_order_qty(100);
+    auto report = make_execution_report_fill(request, "o-1", "e-1", 150.5, 100, 0, 100, 15.05);
+
+    std::string wire;
+    ASSERT_TRUE(proto_to_fix(report, "TRADECORE", "CLIENT1", 3, wire));
+
+    FixMessageView view;
+    size_t consumed = 0;
+    ASSERT_EQ(parse_fix(wire, view, consumed), FixParseStatus::Ok);
+    EXPECT_EQ(consumed, wire.size());
+    EXPECT_EQ(view.msg_type(), "8");
+    EXPECT_EQ(view.get(49), "TRADECORE");
+    EXPECT_EQ(view.get(56), "CLIENT1");
+    EXPECT_EQ(view.get(34), "3");
+    EXPECT_EQ(view.get(11), "ord-1");
+    EXPECT_EQ(view.get(150), "2");
+    EXPECT_EQ(view.get(39), "2");
+    EXPECT_EQ(view.get(54), "1");
+    EXPECT_EQ(view.get(31), "150.5");
+    EXPECT_EQ(view.get(32), "100");
+}
+
+TEST(FixCodecTest, MassCancelRoundTrip) {
+    FixMessageView view;
+    size_t consumed = 0;
+    fix::FixMessage msg;
+
+    auto request = frame("q", "11=mc-1|530=1|55=AAPL|58=mm|");
+    ASSERT_EQ(parse_fix(request, view, consumed), FixParseStatus::Ok);
+    ASSERT_EQ(fix_to_proto(view, msg), "");
+    ASSERT_TRUE(msg.has_order_mass_cancel_request());
+    EXPECT_EQ(msg.order_mass_cancel_request().mass_cancel_request_type(), fix::MASS_CANCEL_SECURITY);
+    EXPECT_EQ(msg.order_mass_cancel_request().instrument().symbol(), "AAPL");
+    EXPECT_EQ(msg.order_mass_cancel_request().text(), "mm");
+
+    auto report = make_mass_cancel_report(msg, "MC-1", fix::MASS_CANCEL_RESPONSE_SECURITY, 42);
+    std::string wire;
+    ASSERT_TRUE(proto_to_fix(report, "TRADECORE", "CLIENT1", 4, wire));
+    ASSERT_EQ(parse_fix(wire, view, consumed), FixParseStatus::Ok);
+    EXPECT_EQ(view.msg_type(), "r");
+    EXPECT_EQ(view.get(11), "mc-1");
+    EXPECT_EQ(view.get(530), "1");
+    EXPECT_EQ(view.get(531), "1");
+    EXPECT_EQ(view.get(533), "42");
+}
+
+TEST(FixCodecTest, MarketDataHasNoTagValueMapping) {
+    fix::FixMessage msg;
+    msg.mutable_market_data_snapshot()->set_symbol("AAPL");
+    std::string wire;
+    EXPECT_FALSE(proto_to_fix(msg, "TRADECORE", "CLIENT1", 1, wire));
+}
+
+TEST(FixCodecTest, PositionSubscriptionRoundTrip) {
+    FixMessageView view;
+    size_t consumed = 0;
+    fix::FixMessage msg;
+
+    auto request = frame("AN", "710=pr-1|1=ACC1|263=1|");
+    ASSERT_EQ(parse_fix(request, view, consumed), FixParseStatus::Ok);
+    ASSERT_EQ(fix_to_proto(view, msg), "");
+    ASSERT_TRUE(msg.has_position_request());
+    EXPECT_EQ(msg.position_request().subscription_request_type(),
+              fix::SUBSCRIPTION_SNAPSHOT_PLUS_UPDATES);
+
+    auto report = make_position_report(msg, "PR-2");
+    report.mutable_position_report()->set_unsolicited(true);
+    std::string wire;
+    ASSERT_TRUE(proto_to_fix(report, "TRADECORE", "CLIENT1", 5, wire));
+    ASSERT_EQ(parse_fix(wire, view, consumed), FixParseStatus::Ok);
+    EXPECT_EQ(view.msg_type(), "AP");
+    EXPECT_EQ(view.get(710), "pr-1");
+    EXPECT_EQ(view.get(325), "Y");
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include "instrument/instrument_registry.hpp"
+
+using namespace tradecore::instrument;
+
+class InstrumentRegistryTest : public ::testing::Test {
+protected:
+    std::string temp_dir_;
+
+    void SetUp() override {
+        temp_dir_ = std::filesystem::temp_directory_path() / "tradecore_test_instruments";
+        std::filesystem::create_directories(temp_dir_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(temp_dir_);
+    }
+
+    std::string write_csv(const std::string& content) {
+        auto path = temp_dir_ + "/instruments.csv";
+        std::ofstream f(path);
+        f << content;
+        return path;
+    }
+};
+
+TEST_F(InstrumentRegistryTest, LoadsReferenceFile) {
+    auto path = write_csv(R"(# symbol,asset_class,exchange,currency,tick_size,multiplier
+AAPL,equity,XNAS,USD,0.01,1
+ESZ6, future, XCME, USD, 0.25, 50, 20261218
+
+EURUSD,fx,,USD,0.00001,
+SAP,equity,XETR,EUR,,    # defaults for tick size and multiplier
+)");
+    InstrumentRegistry registry;
+    ASSERT_EQ(registry.load(path), "");
+    ASSERT_EQ(registry.size(), 4u);
+
+    const auto* es = registry.find("ESZ6");
+    ASSERT_NE(es, nullptr);
+    EXPECT_EQ(es->id, 2u);
+    EXPECT_EQ(es->asset_class, AssetClass::Future);
+    EXPECT_EQ(es->exchange, "XCME");
+    EXPECT_DOUBLE_EQ(es->tick_size, 0.25);
+    EXPECT_DOUBLE_EQ(es->contract_size, 50.0);
+    EXPECT_EQ(es->expiry, "20261218");
+    EXPECT_EQ(&registry.get(es->id), es);
+
+    const auto& eurusd = registry.get(3);
+    EXPECT_EQ(eurusd.symbol, "EURUSD");
+    EXPECT_EQ(eurusd.pip_size, 0.00001);
+    EXPECT_DOUBLE_EQ(eurusd.contract_size, 1.0);
+
+    const auto* sap = registry.find("SAP");
+    ASSERT_NE(sap, nullptr);
+    EXPECT_EQ(sap->currency, "EUR");
+    EXPECT_DOUBLE_EQ(sap->tick_size, 0.01);
+
+    EXPECT_EQ(registry.find("MSFT"), nullptr);
+    EXPECT_EQ(registry.get(0).symbol, "");
+    EXPECT_EQ(&registry.get(99), &kUnknownInstrument);
+}
+
+TEST_F(InstrumentRegistryTest, ReportsBadLine) {
+    auto path = write_csv("AAPL,equity,XNAS,USD,0.01,1\nGILT,bond,XLON,GBP,0.01,1\n");
+    InstrumentRegistry registry;
+    auto error = registry.load(path);
+    EXPECT_NE(error.find("instruments.csv:2:"), std::string::npos) << error;
+    EXPECT_NE(error.find("bond"), std::string::npos) << error;
+    EXPECT_NE(registry.find("AAPL"), nullptr);
+
+    EXPECT_NE(registry.load(temp_dir_ + "/missing.csv"), "");
+}
+
+TEST_F(InstrumentRegistryTest, RowsKeepTheirAddress) {
+    InstrumentRegistry registry;
+    Instrument es;
+    es.symbol = "ESZ6";
+    es.asset_class = AssetClass::Future;
+    es.contract_size = 50.0;
+    const auto& row = registry.add(es);
+    EXPECT_EQ(registry.find("ESZ6"), &row);
+    EXPECT_EQ(registry.find("NQZ6"), nullptr);
+    EXPECT_EQ(registry.size(), 1u);
+
+    // An empty symbol is never registered
+    EXPECT_EQ(&registry.add(Instrument{}), &kUnknownInstrument);
+    EXPECT_EQ(&registry.intern(""), &kUnknownInstrument);
+    EXPECT_EQ(registry.size(), 1u);
+
+    // Rows keep their address as the registry grows and when updated
+    for (int i = 0; i < 1000; ++i) registry.intern("SYM" + std::to_string(i));
+    es.contract_size = 20.0;
+    EXPECT_EQ(&registry.add(es), &row);
+    EXPECT_DOUBLE_EQ(row.contract_size, 20.0);
+    EXPECT_EQ(row.id, 1u);
+}
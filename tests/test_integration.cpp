@@ -1,10 +1,21 @@
 #include <gtest/gtest.h>
 #include <zmq.hpp>
+#include <algorithm>
+#include <atomic>
 #include <thread>
 #include <chrono>
+#include <cstring>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 #include "booking/book_keeper.hpp"
 #include "matching/matching_engine.hpp"
+#include "instrument/symbol_table.hpp"
+#include "messaging/binary_codec.hpp"
+#include "messaging/fix_gateway.hpp"
+#include "messaging/md_publisher.hpp"
 #include "messaging/protocol.hpp"
 #include "messaging/zmq_server.hpp"
 #include "orders/order_manager.hpp"
@@ -17,6 +28,7 @@ protected:
 
     matching::MatchingEngine matcher;
     booking::BookKeeper book_keeper;
+    instrument::SymbolTable wire_symbols;
     std::unique_ptr<orders::OrderManager> order_mgr;
     std::unique_ptr<messaging::ZmqServer> server;
     std::thread server_thread;
@@ -24,6 +36,9 @@ protected:
     void SetUp() override {
         order_mgr = std::make_unique<orders::OrderManager>(matcher, book_keeper);
         server = std::make_unique<messaging::ZmqServer>(BIND_ADDR);
+        wire_symbols.intern("AAPL");
+        wire_symbols.intern("MSFT");
+        server->enable_binary(wire_symbols);
 
         server->set_handler(
             [&](const std::string& client_id,
@@ -53,10 +68,10 @@ protected:
                     entry->mutable_instrument()->set_symbol(pos.symbol);
                     entry->mutable_instrument()->set_security_type(
                         fix::SECURITY_TYPE_COMMON_STOCK);
-                    if (pos.quantity >= 0) {
-                        entry->set_long_qty(pos.quantity);
+                    if (pos.quantity >= core::Qty{}) {
+                        entry->set_long_qty(pos.quantity.to_double());
                     } else {
-                        entry->set_short_qty(-pos.quantity);
+                        entry->set_short_qty((-pos.quantity).to_double());
                     }
                     entry->set_avg_price(pos.avg_price);
                     entry->set_realized_pnl(pos.realized_pnl);
@@ -108,6 +123,33 @@ protected:
         return {};
     }
 
+    // Send raw bytes and return the raw response frame
+    std::string send_and_recv_raw(const void* data, size_t size, int timeout_ms = 2000) {
+        zmq::context_t ctx(1);
+        zmq::socket_t sock(ctx, zmq::socket_type::dealer);
+        sock.set(zmq::sockopt::routing_id, "test-binary-client");
+        sock.connect(BIND_ADDR);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        sock.send(zmq::message_t{}, zmq::send_flags::sndmore);
+        sock.send(zmq::buffer(data, size), zmq::send_flags::none);
+
+        std::string result;
+        zmq::pollitem_t items[] = {{sock, 0, ZMQ_POLLIN, 0}};
+        zmq::poll(items, 1, std::chrono::milliseconds(timeout_ms));
+        if (items[0].revents & ZMQ_POLLIN) {
+            zmq::message_t empty, response;
+            (void)sock.recv(empty, zmq::recv_flags::none);
+            (void)sock.recv(response, zmq::recv_flags::none);
+            result = response.to_string();
+        }
+
+        sock.close();
+        ctx.close();
+        return result;
+    }
+
     fix::FixMessage make_order_msg(const std::string& cl_ord_id,
                                     const std::string& symbol = "AAPL",
                                     fix::Side side = fix::SIDE_BUY,
@@ -210,7 +252,336 @@ TEST_F(IntegrationTest, MultipleOrdersBookedCorrectly) {
 
     auto* pos = book_keeper.get_position("NVDA");
     ASSERT_NE(pos, nullptr);
-    EXPECT_EQ(pos->quantity, 150.0);
+    EXPECT_EQ(pos->quantity, core::Qty(150.0));
     // With order book, both fill from the book seeded at ~500
     EXPECT_NEAR(pos->avg_price, 500.25, 1.0);
 }
+
+TEST_F(IntegrationTest, BinaryOrderFillOverZmq) {
+    messaging::binary::NewOrder nos;
+    nos.header.msg_type = messaging::binary::MsgType::NewOrder;
+    nos.header.length = sizeof(nos);
+    nos.header.seq_num = 1;
+    nos.symbol_id = wire_symbols.find("AAPL");
+    nos.side = fix::SIDE_BUY;
+    nos.ord_type = fix::ORD_TYPE_MARKET;
+    nos.time_in_force = fix::TIF_DAY;
+    nos.order_qty = 100 * messaging::binary::kScale;
+    nos.market_price = 150 * messaging::binary::kScale;
+    std::strcpy(nos.cl_ord_id, "bin-001");
+
+    auto response = send_and_recv_raw(&nos, sizeof(nos));
+    ASSERT_TRUE(messaging::BinaryCodec::is_binary(response.data(), response.size()));
+    ASSERT_EQ(response.size(), sizeof(messaging::binary::ExecutionReport));
+
+    messaging::binary::ExecutionReport er;
+    std::memcpy(&er, response.data(), sizeof(er));
+    EXPECT_EQ(er.header.msg_type, messaging::binary::MsgType::ExecutionReport);
+    EXPECT_STREQ(er.cl_ord_id, "bin-001");
+    EXPECT_EQ(er.symbol_id, nos.symbol_id);
+    EXPECT_EQ(er.ord_status, fix::ORD_STATUS_FILLED);
+    EXPECT_EQ(er.last_qty, nos.order_qty);
+    EXPECT_EQ(er.header.seq_num, 1u);
+
+    // The session's outbound sequence advances per frame
+    nos.header.seq_num = 2;
+    std::strcpy(nos.cl_ord_id, "bin-002");
+    response = send_and_recv_raw(&nos, sizeof(nos));
+    ASSERT_EQ(response.size(), sizeof(er));
+    std::memcpy(&er, response.data(), sizeof(er));
+    EXPECT_EQ(er.header.seq_num, 2u);
+}
+
+TEST(MarketDataIntegration, PublishesIncrementalThenSnapshot) {
+    static constexpr const char* MD_ADDR = "tcp://127.0.0.1:5559";
+
+    matching::MatchingEngine engine;
+    engine.set_publish_updates(true);
+    messaging::MarketDataPublisher publisher(MD_ADDR, 5, std::chrono::milliseconds(0));
+
+    zmq::context_t ctx(1);
+    zmq::socket_t sub(ctx, zmq::socket_type::sub);
+    sub.set(zmq::sockopt::subscribe, "AAPL");
+    sub.connect(MD_ADDR);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));  // PUB/SUB slow joiner
+
+    engine.seed_book("AAPL", 150.0, 10.0, 2, 100.0);
+    publisher.on_tick(engine);  // zero interval: incremental, then snapshot
+
+    auto recv_md = [&]() -> fix::FixMessage {
+        zmq::pollitem_t items[] = {{sub, 0, ZMQ_POLLIN, 0}};
+        zmq::poll(items, 1, std::chrono::milliseconds(2000));
+        if (!(items[0].revents & ZMQ_POLLIN)) return {};
+        zmq::message_t topic, payload;
+        (void)sub.recv(topic, zmq::recv_flags::none);
+        (void)sub.recv(payload, zmq::recv_flags::none);
+        EXPECT_EQ(topic.to_string(), "AAPL");
+        return messaging::deserialize(payload.data(), payload.size());
+    };
+
+    auto inc = recv_md();
+    ASSERT_TRUE(inc.has_market_data_incremental());
+    EXPECT_EQ(inc.market_data_incremental().entries_size(), 4);
+
+    auto snap = recv_md();
+    ASSERT_TRUE(snap.has_market_data_snapshot());
+    EXPECT_GT(snap.market_data_snapshot().rpt_seq(), inc.market_data_incremental().rpt_seq());
+    EXPECT_EQ(snap.market_data_snapshot().entries_size(), 4);
+
+    sub.close();
+    ctx.close();
+}
+
+// Server driven by poll_once() from the test thread, so everything the
+// clients sent is already queued on the socket when the server looks.
+class ZmqSchedulingIntegration : public ::testing::Test {
+protected:
+    static constexpr const char* BIND_ADDR = "tcp://127.0.0.1:5561";
+
+    zmq::context_t ctx{1};
+    std::unique_ptr<messaging::ZmqServer> server;
+    std::vector<std::string> served;
+
+    void SetUp() override {
+        server = std::make_unique<messaging::ZmqServer>(BIND_ADDR);
+        server->set_handler(
+            [&](const std::string& client_id, const fix::FixMessage& msg) -> std::vector<fix::FixMessage> {
+            served.push_back(client_id);
+            return {messaging::make_heartbeat_response(msg)};
+        });
+    }
+
+    zmq::socket_t connect(const std::string& identity) {
+        zmq::socket_t sock(ctx, zmq::socket_type::dealer);
+        sock.set(zmq::sockopt::routing_id, identity);
+        sock.connect(BIND_ADDR);
+        return sock;
+    }
+
+    static void send_heartbeat(zmq::socket_t& sock) {
+        fix::FixMessage msg;
+        msg.mutable_heartbeat();
+        std::string data = messaging::serialize(msg);
+        sock.send(zmq::message_t{}, zmq::send_flags::sndmore);
+        sock.send(zmq::buffer(data), zmq::send_flags::none);
+    }
+
+    static std::vector<fix::FixMessage> recv_all(zmq::socket_t& sock) {
+        std::vector<fix::FixMessage> out;
+        while (true) {
+            zmq::message_t empty, response;
+            if (!sock.recv(empty, zmq::recv_flags::dontwait)) break;
+            (void)sock.recv(response, zmq::recv_flags::none);
+            out.push_back(messaging::deserialize(response.data(), response.size()));
+        }
+        return out;
+    }
+};
+
+TEST_F(ZmqSchedulingIntegration, RoundRobinAcrossClients) {
+    auto flooder = connect("flooder");
+    auto quiet = connect("quiet");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    for (int i = 0; i < 20; ++i) send_heartbeat(flooder);
+    send_heartbeat(quiet);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    while (server->poll_once(0)) {}
+
+    ASSERT_EQ(served.size(), 21u);
+    auto pos = std::find(served.begin(), served.end(), "quiet") - served.begin();
+    EXPECT_LE(pos, 1);  // served in the first round, not behind the flood
+}
+
+TEST_F(ZmqSchedulingIntegration, TokenBucketRejectsExcess) {
+    server->set_rate_limit(1.0, 3.0);
+    auto flooder = connect("flooder");
+    auto quiet = connect("quiet");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    for (int i = 0; i < 10; ++i) send_heartbeat(flooder);
+    send_heartbeat(quiet);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    while (server->poll_once(0)) {}
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    auto flooded = recv_all(flooder);
+    ASSERT_EQ(flooded.size(), 10u);
+    int rejects = 0;
+    for (const auto& r : flooded) rejects += r.has_reject();
+    EXPECT_EQ(rejects, 7);  // burst of 3 admitted
+    EXPECT_EQ(std::count(served.begin(), served.end(), "flooder"), 3);
+
+    auto calm = recv_all(quiet);
+    ASSERT_EQ(calm.size(), 1u);
+    EXPECT_TRUE(calm[0].has_heartbeat());
+}
+
+TEST_F(ZmqSchedulingIntegration, SilentClientTimesOut) {
+    std::vector<std::string> disconnected;
+    server->set_session_timeout(std::chrono::milliseconds(100),
+        [&](const std::string& client_id) { disconnected.push_back(client_id); });
+    auto alive = connect("alive");
+    auto silent = connect("silent");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    send_heartbeat(alive);
+    send_heartbeat(silent);
+    for (int i = 0; i < 8; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(25));
+        send_heartbeat(alive);
+        server->poll_once(0);
+    }
+    while (server->poll_once(0)) {}
+
+    ASSERT_EQ(disconnected, std::vector<std::string>{"silent"});
+    EXPECT_EQ(server->session_count(), 1u);
+}
+
+// Plays the initiator side of a FIX session against the gateway, which is
+// driven from a ZmqServer event loop through watch_fd().
+class FixGatewayIntegration : public ::testing::Test {
+protected:
+    matching::MatchingEngine matcher;
+    booking::BookKeeper book_keeper;
+    std::unique_ptr<orders::OrderManager> order_mgr;
+    std::unique_ptr<messaging::ZmqServer> server;
+    std::unique_ptr<messaging::FixGateway> gateway;
+    std::thread server_thread;
+    int client_fd = -1;
+    int heartbeat_s = 30;
+    std::atomic<int> disconnects{0};
+    std::string in;
+    uint64_t seq = 1;
+
+    void SetUp() override {
+        order_mgr = std::make_unique<orders::OrderManager>(matcher, book_keeper);
+        matcher.update_market_price("AAPL", 150.0);
+        server = std::make_unique<messaging::ZmqServer>("tcp://127.0.0.1:5560");
+        gateway = std::make_unique<messaging::FixGateway>(0, "TRADECORE", heartbeat_s);
+        gateway->set_disconnect_handler([&](const std::string&) { ++disconnects; });
+        gateway->set_handler(
+            [&](const std::string&, const fix::FixMessage& msg) -> std::vector<fix::FixMessage> {
+            if (msg.has_new_order_single()) return order_mgr->handle_new_order(msg);
+            if (msg.has_order_cancel_request()) return order_mgr->handle_cancel_request(msg);
+            return {messaging::make_reject(msg, "Unknown message type")};
+        });
+        server->watch_fd(gateway->poll_fd(), [this] { gateway->poll_once(0); });
+        server_thread = std::thread([this] { server->run(); });
+
+        client_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        timeval tv{2, 0};
+        ::setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(gateway->port());
+        ASSERT_EQ(::connect(client_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    }
+
+    void TearDown() override {
+        if (client_fd >= 0) ::close(client_fd);
+        server->stop();
+        if (server_thread.joinable()) server_thread.join();
+        server.reset();
+        gateway.reset();
+    }
+
+    void send_fix(const std::string& msg_type, std::string body) {
+        std::replace(body.begin(), body.end(), '|', messaging::kSoh);
+        std::string wire;
+        messaging::build_fix(msg_type, "CLIENT1", "TRADECORE", seq++, body, wire);
+        ASSERT_EQ(::send(client_fd, wire.data(), wire.size(), 0),
+                  static_cast<ssize_t>(wire.size()));
+    }
+
+    // Next frame from the gateway; msg_type is empty on timeout or disconnect.
+    // The returned view points into `in`, valid until the next call.
+    messaging::FixMessageView recv_fix() {
+        messaging::FixMessageView view;
+        while (true) {
+            size_t consumed = 0;
+            if (!in.empty() && messaging::parse_fix(in, view, consumed) == messaging::FixParseStatus::Ok) {
+                last_frame_ = in.substr(0, consumed);
+                in.erase(0, consumed);
+                messaging::parse_fix(last_frame_, view, consumed);
+                return view;
+            }
+            char buf[4096];
+            ssize_t n = ::recv(client_fd, buf, sizeof(buf), 0);
+            if (n <= 0) return {};
+            in.append(buf, static_cast<size_t>(n));
+        }
+    }
+
+private:
+    std::string last_frame_;
+};
+
+TEST_F(FixGatewayIntegration, LogonOrderFillOverTcp) {
+    send_fix("A", "98=0|108=30|");
+    auto logon = recv_fix();
+    ASSERT_EQ(logon.msg_type(), "A");
+    EXPECT_EQ(logon.get(108), "30");
+    EXPECT_EQ(logon.get(56), "CLIENT1");
+
+    send_fix("D", "11=fix-1|55=AAPL|54=1|38=100|40=1|");
+    auto fill = recv_fix();
+    ASSERT_EQ(fill.msg_type(), "8");
+    EXPECT_EQ(fill.get(11), "fix-1");
+    EXPECT_EQ(fill.get(150), "2");
+    EXPECT_EQ(fill.get(32), "100");
+    EXPECT_EQ(fill.get(34), "2");
+    EXPECT_EQ(book_keeper.trade_count(), 1u);
+
+    send_fix("1", "112=ping|");
+    auto hb = recv_fix();
+    ASSERT_EQ(hb.msg_type(), "0");
+    EXPECT_EQ(hb.get(112), "ping");
+
+    send_fix("5", "");
+    EXPECT_EQ(recv_fix().msg_type(), "5");
+    EXPECT_TRUE(recv_fix().msg_type().empty());  // gateway closed the session
+}
+
+TEST_F(FixGatewayIntegration, RequiresLogonFirst) {
+    send_fix("D", "11=fix-1|55=AAPL|54=1|38=100|40=1|");
+    auto logout = recv_fix();
+    ASSERT_EQ(logout.msg_type(), "5");
+    EXPECT_TRUE(recv_fix().msg_type().empty());
+    EXPECT_EQ(book_keeper.trade_count(), 0u);
+}
+
+TEST_F(FixGatewayIntegration, UnsupportedMsgTypeIsSessionRejected) {
+    send_fix("A", "98=0|108=30|");
+    ASSERT_EQ(recv_fix().msg_type(), "A");
+    send_fix("ZZ", "");
+    auto reject = recv_fix();
+    ASSERT_EQ(reject.msg_type(), "3");
+    EXPECT_EQ(reject.get(45), "2");
+    EXPECT_EQ(reject.get(373), "11");
+}
+
+class FixGatewayHeartbeat : public FixGatewayIntegration {
+protected:
+    FixGatewayHeartbeat() { heartbeat_s = 1; }
+};
+
+TEST_F(FixGatewayHeartbeat, SilentPeerIsProbedThenDisconnected) {
+    send_fix("A", "98=0|108=1|");
+    ASSERT_EQ(recv_fix().msg_type(), "A");
+
+    // Never answer: a Heartbeat may come first, then a TestRequest, then close
+    bool probed = false;
+    for (auto msg = recv_fix(); !msg.msg_type().empty(); msg = recv_fix()) {
+        EXPECT_TRUE(msg.msg_type() == "0" || msg.msg_type() == "1") << msg.msg_type();
+        if (msg.msg_type() == "1") probed = true;
+    }
+    EXPECT_TRUE(probed);
+    for (int i = 0; i < 100 && disconnects == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(disconnects, 1);
+}
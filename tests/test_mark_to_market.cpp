@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "booking/book_keeper.hpp"
+#include "booking/mark_to_market.hpp"
+#include "instrument/instrument_registry.hpp"
+#include "matching/matching_engine.hpp"
+
+using namespace tradecore;
+using namespace tradecore::booking;
+
+namespace {
+
+Trade make_trade(const std::string& symbol, orders::Side side, double qty, double price) {
+    Trade trade;
+    trade.symbol = symbol;
+    trade.side = side;
+    trade.quantity = Qty(qty);
+    trade.price = Price(price);
+    return trade;
+}
+
+}  // namespace
+
+TEST(MarkToMarket, FillsAndMarksUpdateIncrementally) {
+    MarkToMarket mtm;
+    BookKeeper keeper;
+    keeper.set_valuation(&mtm);
+
+    keeper.book_trade(make_trade("AAPL", orders::Side::Buy, 100, 150.0));
+    EXPECT_DOUBLE_EQ(mtm.unrealized_pnl("AAPL"), 0.0);  // no mark yet
+
+    mtm.on_mark("AAPL", 152.0);
+    EXPECT_DOUBLE_EQ(mtm.unrealized_pnl("AAPL"), 200.0);
+
+    keeper.book_trade(make_trade("MSFT", orders::Side::Sell, 10, 300.0));
+    mtm.on_mark("MSFT", 310.0);
+    EXPECT_DOUBLE_EQ(mtm.unrealized_pnl("MSFT"), -100.0);
+    EXPECT_DOUBLE_EQ(mtm.total_unrealized_pnl(), 100.0);
+
+    // Closing the position takes its row out of the total
+    keeper.book_trade(make_trade("AAPL", orders::Side::Sell, 100, 152.0));
+    EXPECT_DOUBLE_EQ(mtm.unrealized_pnl("AAPL"), 0.0);
+    EXPECT_DOUBLE_EQ(mtm.total_unrealized_pnl(), -100.0);
+
+    EXPECT_EQ(mtm.size(), 2);
+    EXPECT_DOUBLE_EQ(mtm.unrealized_pnl("NOPE"), 0.0);
+}
+
+TEST(MarkToMarket, RevalueMatchesRunningTotal) {
+    MarkToMarket mtm;
+    BookKeeper keeper;
+    keeper.set_valuation(&mtm);
+    for (int i = 0; i < 1000; ++i) {
+        auto symbol = "S" + std::to_string(i);
+        auto side = (i % 3 == 0) ? orders::Side::Sell : orders::Side::Buy;
+        keeper.book_trade(make_trade(symbol, side, 10 + i % 7, 50.0 + i * 0.01));
+        mtm.on_mark(symbol, 50.0 + i * 0.013);
+    }
+    double running = mtm.total_unrealized_pnl();
+    EXPECT_NEAR(mtm.revalue(), running, 1e-6);
+    EXPECT_DOUBLE_EQ(mtm.total_unrealized_pnl(), mtm.revalue());
+}
+
+TEST(MarkToMarket, EngineMarksAtMidThenLastTrade) {
+    matching::MatchingEngine engine;
+    MarkToMarket mtm;
+    engine.set_mark_listener([&](const std::string& symbol, double mark) {
+        mtm.on_mark(symbol, mark);
+    });
+
+    engine.update_market_price("AAPL", 150.0);
+    EXPECT_DOUBLE_EQ(mtm.mark("AAPL"), 150.0);
+
+    // Seeding shows both sides around the market price
+    engine.seed_book("AAPL", 100.0, 20.0, 1, 100.0);
+    EXPECT_DOUBLE_EQ(engine.get_mark_price("AAPL"), 100.0);
+    EXPECT_DOUBLE_EQ(mtm.mark("AAPL"), 100.0);
+
+    // With the ask side gone the last trade marks the symbol
+    orders::Order buy;
+    buy.order_id = "B1";
+    instrument::InstrumentRegistry instruments;
+    buy.instrument = &instruments.intern("AAPL");
+    buy.quantity = Qty(100.0);
+    auto result = engine.try_match(buy);
+    ASSERT_TRUE(result.matched);
+    EXPECT_DOUBLE_EQ(mtm.mark("AAPL"), result.fill_price.to_double());
+}
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include "instrument/instrument_registry.hpp"
+#include "matching/matching_engine.hpp"
+#include "messaging/market_data.hpp"
+
+using namespace tradecore;
+using namespace tradecore::matching;
+
+namespace {
+
+OrderEntry make_entry(const std::string& id, double price, double qty) {
+    OrderEntry e;
+    e.order_id = id;
+    e.cl_ord_id = "cl-" + id;
+    e.price = Price(price);
+    e.remaining_quantity = Qty(qty);
+    e.original_quantity = Qty(qty);
+    return e;
+}
+
+}  // namespace
+
+TEST(MarketData, IncrementalFromBookUpdates) {
+    OrderBook book;
+    book.set_track_updates(true);
+    book.add_order(BookSide::Bid, make_entry("B1", 99.0, 50));
+    book.add_order(BookSide::Ask, make_entry("A1", 101.0, 40));
+    book.add_order(BookSide::Ask, make_entry("A2", 101.0, 10));
+
+    auto msg = messaging::make_md_incremental("AAPL", 7, book, book.level_updates());
+
+    ASSERT_TRUE(msg.has_market_data_incremental());
+    const auto& inc = msg.market_data_incremental();
+    EXPECT_EQ(inc.symbol(), "AAPL");
+    EXPECT_EQ(inc.rpt_seq(), 7u);
+    ASSERT_EQ(inc.entries_size(), 3);
+    EXPECT_EQ(inc.entries(0).update_action(), fix::MD_UPDATE_ACTION_NEW);
+    EXPECT_EQ(inc.entries(0).entry_type(), fix::MD_ENTRY_TYPE_BID);
+    EXPECT_EQ(inc.entries(2).update_action(), fix::MD_UPDATE_ACTION_CHANGE);
+    EXPECT_EQ(inc.entries(2).size(), 50.0);
+    EXPECT_EQ(inc.entries(2).number_of_orders(), 2);
+
+    EXPECT_EQ(inc.top_of_book().bid_px(), 99.0);
+    EXPECT_EQ(inc.top_of_book().offer_px(), 101.0);
+    EXPECT_EQ(inc.top_of_book().offer_size(), 50.0);
+}
+
+TEST(MarketData, SnapshotHonoursDepth) {
+    MatchingEngine engine;
+    engine.seed_book("AAPL", 150.0, 10.0, 5, 100.0);
+
+    auto msg = messaging::make_md_snapshot("AAPL", 1, *engine.get_book("AAPL"), 2);
+
+    ASSERT_TRUE(msg.has_market_data_snapshot());
+    const auto& snap = msg.market_data_snapshot();
+    ASSERT_EQ(snap.entries_size(), 4);
+    EXPECT_EQ(snap.entries(0).entry_type(), fix::MD_ENTRY_TYPE_BID);
+    EXPECT_EQ(snap.entries(2).entry_type(), fix::MD_ENTRY_TYPE_OFFER);
+    EXPECT_GT(snap.entries(0).price(), snap.entries(1).price());
+    EXPECT_LT(snap.entries(2).price(), snap.entries(3).price());
+}
+
+TEST(MarketData, EngineDrainsOnlyChangedBooks) {
+    MatchingEngine engine;
+    engine.set_publish_updates(true);
+    engine.seed_book("AAPL", 150.0, 10.0, 2, 100.0);
+    engine.seed_book("MSFT", 300.0, 10.0, 2, 100.0);
+
+    int books = 0;
+    engine.drain_book_updates([&](const std::string&, const OrderBook&,
+                                  const std::vector<LevelUpdate>& updates) {
+        ++books;
+        EXPECT_EQ(updates.size(), 4u);
+    });
+    EXPECT_EQ(books, 2);
+
+    // A market buy touching one ask level yields exactly one delta on one book
+    orders::Order order;
+    order.order_id = "TC-1";
+    instrument::InstrumentRegistry instruments;
+    order.instrument = &instruments.intern("MSFT");
+    order.side = orders::Side::Buy;
+    order.quantity = Qty(10.0);
+    engine.try_match(order);
+
+    std::vector<std::string> changed;
+    engine.drain_book_updates([&](const std::string& symbol, const OrderBook&,
+                                  const std::vector<LevelUpdate>& updates) {
+        changed.push_back(symbol);
+        ASSERT_EQ(updates.size(), 1u);
+        EXPECT_EQ(updates[0].side, BookSide::Ask);
+        EXPECT_EQ(updates[0].action, LevelAction::Change);
+        EXPECT_EQ(updates[0].quantity, Qty(90.0));
+    });
+    ASSERT_EQ(changed.size(), 1u);
+    EXPECT_EQ(changed[0], "MSFT");
+
+    // Nothing left to drain
+    engine.drain_book_updates([&](const std::string&, const OrderBook&,
+                                  const std::vector<LevelUpdate>&) { FAIL(); });
+}
+
+// --- Conflated top-of-book ---
+
+TEST(BboConflator, OverwritesInPlace) {
+    messaging::BboConflator conflator(8);
+    messaging::BboConflator::Cursor cursor;
+    OrderBook book;
+    book.add_order(BookSide::Bid, make_entry("B1", 99.0, 10));
+    book.add_order(BookSide::Ask, make_entry("A1", 101.0, 10));
+
+    EXPECT_TRUE(conflator.update("AAPL", book));
+    book.add_order(BookSide::Bid, make_entry("B2", 100.0, 5));
+    EXPECT_TRUE(conflator.update("AAPL", book));
+
+    // Two writes, one slot: the reader only sees the latest value
+    std::vector<messaging::BboSnapshot> seen;
+    EXPECT_EQ(conflator.drain(cursor, [&](const messaging::BboSnapshot& b) { seen.push_back(b); }), 1u);
+    ASSERT_EQ(seen.size(), 1u);
+    EXPECT_EQ(*seen[0].symbol, "AAPL");
+    EXPECT_EQ(seen[0].bid_px, 100.0);
+    EXPECT_EQ(seen[0].bid_size, 5.0);
+    EXPECT_EQ(seen[0].ask_px, 101.0);
+
+    EXPECT_EQ(conflator.drain(cursor, [](const messaging::BboSnapshot&) {}), 0u);
+}
+
+TEST(BboConflator, UnchangedBboIsNotRewritten) {
+    messaging::BboConflator conflator(8);
+    OrderBook book;
+    book.add_order(BookSide::Bid, make_entry("B1", 99.0, 10));
+    book.add_order(BookSide::Bid, make_entry("B2", 98.0, 10));
+
+    EXPECT_TRUE(conflator.update("AAPL", book));
+    book.cancel_order("B2");  // below the touch
+    EXPECT_FALSE(conflator.update("AAPL", book));
+}
+
+TEST(BboConflator, CursorsDrainIndependently) {
+    messaging::BboConflator conflator(8);
+    messaging::BboConflator::Cursor fast, slow;
+    OrderBook aapl, msft;
+    aapl.add_order(BookSide::Bid, make_entry("B1", 99.0, 10));
+    msft.add_order(BookSide::Bid, make_entry("B2", 299.0, 10));
+
+    conflator.update("AAPL", aapl);
+    EXPECT_EQ(conflator.drain(fast, [](const messaging::BboSnapshot&) {}), 1u);
+    conflator.update("MSFT", msft);
+    EXPECT_EQ(conflator.drain(fast, [](const messaging::BboSnapshot&) {}), 1u);
+
+    // The slow reader catches up with one value per symbol, however many writes it missed
+    EXPECT_EQ(conflator.drain(slow, [](const messaging::BboSnapshot&) {}), 2u);
+}
+
+TEST(BboConflator, FullTableRejectsNewSymbols) {
+    messaging::BboConflator conflator(1);
+    OrderBook book;
+    book.add_order(BookSide::Bid, make_entry("B1", 99.0, 10));
+
+    EXPECT_TRUE(conflator.update("AAPL", book));
+    EXPECT_FALSE(conflator.update("MSFT", book));
+    EXPECT_EQ(conflator.symbol_count(), 1u);
+}
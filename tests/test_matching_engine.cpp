@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include "instrument/instrument_registry.hpp"
 #include "matching/matching_engine.hpp"
 
 using namespace tradecore::matching;
@@ -7,14 +8,15 @@ using namespace tradecore::instrument;
 
 namespace {
 
+InstrumentRegistry instruments;
+
 Order make_market_order(const std::string& symbol, Side side, double qty) {
     Order order;
     order.cl_ord_id = "test-001";
     order.order_id = "TC-00001";
-    order.instrument.symbol = symbol;
-    order.instrument.asset_class = AssetClass::Equity;
+    order.instrument = &instruments.intern(symbol);
     order.side = side;
-    order.quantity = qty;
+    order.quantity = Qty(qty);
     order.order_type = OrderType::Market;
     return order;
 }
@@ -22,7 +24,7 @@ Order make_market_order(const std::string& symbol, Side side, double qty) {
 Order make_limit_order(const std::string& symbol, Side side, double qty, double price) {
     Order order = make_market_order(symbol, side, qty);
     order.order_type = OrderType::Limit;
-    order.limit_price = price;
+    order.limit_price = Price(price);
     return order;
 }
 
@@ -36,9 +38,9 @@ TEST(MatchingEngine, MarketOrderFillsAtMarketPrice) {
     auto result = engine.try_match(order);
 
     EXPECT_TRUE(result.matched);
-    EXPECT_NEAR(result.fill_price, 150.075, 0.1);  // fills at best ask (150 + half-spread)
-    EXPECT_EQ(result.fill_quantity, 100.0);
-    EXPECT_EQ(result.remaining_quantity, 0.0);
+    EXPECT_NEAR(result.fill_price.to_double(), 150.075, 0.1);  // fills at best ask (150 + half-spread)
+    EXPECT_EQ(result.fill_quantity, Qty(100.0));
+    EXPECT_EQ(result.remaining_quantity, Qty(0.0));
 }
 
 TEST(MatchingEngine, MarketOrderNoPrice) {
@@ -54,11 +56,11 @@ TEST(MatchingEngine, MarketOrderFallsBackToLimitPrice) {
     MatchingEngine engine;
 
     auto order = make_market_order("AAPL", Side::Buy, 100.0);
-    order.limit_price = 155.0;
+    order.limit_price = Price(155.0);
     auto result = engine.try_match(order);
 
     EXPECT_TRUE(result.matched);
-    EXPECT_EQ(result.fill_price, 155.0);
+    EXPECT_EQ(result.fill_price, Price(155.0));
 }
 
 TEST(MatchingEngine, LimitOrderFills) {
@@ -70,8 +72,8 @@ TEST(MatchingEngine, LimitOrderFills) {
     auto result = engine.try_match(order);
 
     EXPECT_TRUE(result.matched);
-    EXPECT_GT(result.fill_quantity, 0.0);
-    EXPECT_EQ(result.remaining_quantity, 0.0);
+    EXPECT_GT(result.fill_quantity, Qty{});
+    EXPECT_EQ(result.remaining_quantity, Qty(0.0));
 }
 
 TEST(MatchingEngine, UpdateMarketPrice) {
@@ -97,8 +99,8 @@ TEST(MatchingEngine, PartialFillMarketOrder) {
     auto result = engine.try_match(order);
 
     EXPECT_TRUE(result.matched);
-    EXPECT_EQ(result.fill_quantity, 200.0);
-    EXPECT_EQ(result.remaining_quantity, 50.0);
+    EXPECT_EQ(result.fill_quantity, Qty(200.0));
+    EXPECT_EQ(result.remaining_quantity, Qty(50.0));
     EXPECT_GE(result.fills.size(), 1);
 }
 
@@ -112,7 +114,7 @@ TEST(MatchingEngine, LimitOrderRests) {
     auto result = engine.try_match(order);
 
     EXPECT_FALSE(result.matched);
-    EXPECT_EQ(result.remaining_quantity, 50.0);
+    EXPECT_EQ(result.remaining_quantity, Qty(50.0));
 
     // Should be resting in the book
     auto* book = engine.get_book("AAPL");
@@ -120,7 +122,7 @@ TEST(MatchingEngine, LimitOrderRests) {
     auto depth = book->get_depth(BookSide::Bid, 10);
     bool found = false;
     for (const auto& d : depth) {
-        if (d.price == 140.0) found = true;
+        if (d.price == Price(140.0)) found = true;
     }
     EXPECT_TRUE(found);
 }
@@ -134,8 +136,8 @@ TEST(MatchingEngine, LimitOrderCrosses) {
     auto result = engine.try_match(order);
 
     EXPECT_TRUE(result.matched);
-    EXPECT_EQ(result.fill_quantity, 50.0);
-    EXPECT_EQ(result.remaining_quantity, 0.0);
+    EXPECT_EQ(result.fill_quantity, Qty(50.0));
+    EXPECT_EQ(result.remaining_quantity, Qty(0.0));
 }
 
 TEST(MatchingEngine, SeedBookCreatesDepth) {
@@ -151,8 +153,8 @@ TEST(MatchingEngine, SeedBookCreatesDepth) {
     auto ask = book->best_ask();
     ASSERT_TRUE(bid.has_value());
     ASSERT_TRUE(ask.has_value());
-    EXPECT_LT(bid.value(), 200.0);
-    EXPECT_GT(ask.value(), 200.0);
+    EXPECT_LT(bid.value(), Price(200.0));
+    EXPECT_GT(ask.value(), Price(200.0));
 }
 
 TEST(MatchingEngine, CancelOrder) {
@@ -180,10 +182,307 @@ TEST(MatchingEngine, WalkPriceLevels) {
     auto result = engine.try_match(order);
 
     EXPECT_TRUE(result.matched);
-    EXPECT_EQ(result.fill_quantity, 25.0);
-    EXPECT_EQ(result.remaining_quantity, 0.0);
+    EXPECT_EQ(result.fill_quantity, Qty(25.0));
+    EXPECT_EQ(result.remaining_quantity, Qty(0.0));
     // Should have fills from multiple levels
     EXPECT_GE(result.fills.size(), 2);
     // VWAP should be higher than best ask since we walked levels
     EXPECT_GT(result.fill_price, result.fills[0].fill_price);
 }
+
+// --- Liquidity models ---
+
+TEST(MatchingEngine, DecayingDepthProfile) {
+    LiquidityModel model;
+    model.profile = DepthProfile::Decaying;
+    model.decay = 0.5;
+    MatchingEngine engine(model);
+    engine.seed_book("AAPL", 150.0, 10.0, 3, 800.0);
+
+    auto depth = engine.get_book("AAPL")->get_depth(BookSide::Ask, 3);
+    ASSERT_EQ(depth.size(), 3);
+    EXPECT_EQ(depth[0].quantity, Qty(800.0));
+    EXPECT_EQ(depth[1].quantity, Qty(400.0));
+    EXPECT_EQ(depth[2].quantity, Qty(200.0));
+}
+
+TEST(MatchingEngine, TickAlignedGrid) {
+    LiquidityModel model;
+    model.tick_aligned = true;
+    model.spread_bps = 10.0;  // half-spread 0.075 -> 8 ticks of 0.01
+    model.depth_levels = 3;
+    MatchingEngine engine(model);
+    engine.seed_book_from_model("AAPL", 150.0, 0.01);
+
+    auto* book = engine.get_book("AAPL");
+    ASSERT_NE(book, nullptr);
+    EXPECT_EQ(book->best_bid().value(), Price(149.92));
+    EXPECT_EQ(book->best_ask().value(), Price(150.08));
+
+    auto asks = book->get_depth(BookSide::Ask, 3);
+    ASSERT_EQ(asks.size(), 3);
+    EXPECT_EQ(asks[1].price - asks[0].price, Price(0.08));
+    for (const auto& level : asks) {
+        EXPECT_EQ(level.price, level.price.round_to(Price(0.01)));
+    }
+}
+
+TEST(MatchingEngine, ReplenishesConsumedSeedLevels) {
+    LiquidityModel model;
+    model.replenish = true;
+    MatchingEngine engine(model);
+    engine.seed_book("GOOG", 100.0, 100.0, 3, 10.0);
+
+    // Sweep the whole ask side
+    auto sweep = engine.try_match(make_market_order("GOOG", Side::Buy, 30.0));
+    EXPECT_EQ(sweep.fill_quantity, Qty(30.0));
+    EXPECT_EQ(engine.get_book("GOOG")->ask_levels(), 0);
+
+    // The next order on the symbol sees the ladder restored
+    auto result = engine.try_match(make_market_order("GOOG", Side::Buy, 5.0));
+    EXPECT_TRUE(result.matched);
+    EXPECT_EQ(result.fills[0].resting_order_id, "SEED-A-GOOG-0");
+    EXPECT_EQ(engine.get_book("GOOG")->ask_levels(), 3);
+}
+
+TEST(MatchingEngine, NoReplenishByDefault) {
+    MatchingEngine engine;
+    engine.seed_book("GOOG", 100.0, 100.0, 2, 10.0);
+
+    engine.try_match(make_market_order("GOOG", Side::Buy, 20.0));
+    auto result = engine.try_match(make_market_order("GOOG", Side::Buy, 5.0));
+    EXPECT_FALSE(result.matched);
+}
+
+TEST(MatchingEngine, ReplenishDoesNotCrossClientOrders) {
+    LiquidityModel model;
+    model.replenish = true;
+    MatchingEngine engine(model);
+    engine.seed_book("GOOG", 100.0, 100.0, 1, 10.0);  // bid 99.5 / ask 100.5
+
+    // Client bid lifts the seeded ask and rests the remainder at 101
+    auto order = make_limit_order("GOOG", Side::Buy, 15.0, 101.0);
+    order.order_id = "CLIENT-BID";
+    engine.try_match(order);
+
+    engine.try_match(make_market_order("GOOG", Side::Sell, 1.0));
+    auto* book = engine.get_book("GOOG");
+    EXPECT_FALSE(book->best_ask().has_value());
+    EXPECT_EQ(book->best_bid().value(), Price(101.0));
+}
+
+TEST(MatchingEngine, ReplaceRestingOrder) {
+    MatchingEngine engine;
+    engine.seed_book("AAPL", 150.0, 10.0, 5, 1000.0);
+
+    auto order = make_limit_order("AAPL", Side::Buy, 50.0, 140.0);
+    order.order_id = "AMEND-ME";
+    engine.try_match(order);
+
+    auto result = engine.replace_order(order, Price(141.0), Qty(80.0));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_FALSE(result->matched);
+    const auto* entry = engine.get_book("AAPL")->find_order("AMEND-ME");
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->price, Price(141.0));
+    EXPECT_EQ(entry->remaining_quantity, Qty(80.0));
+
+    EXPECT_FALSE(engine.replace_order(make_limit_order("AAPL", Side::Buy, 1.0, 1.0), Price(2.0), Qty(1.0)));
+}
+
+TEST(MatchingEngine, ReplaceThroughSpreadMatches) {
+    MatchingEngine engine;
+    engine.seed_book("AAPL", 150.0, 10.0, 5, 1000.0);
+
+    auto order = make_limit_order("AAPL", Side::Buy, 50.0, 140.0);
+    order.order_id = "AMEND-ME";
+    engine.try_match(order);
+
+    Price best_ask = engine.get_book("AAPL")->best_ask().value();
+    auto result = engine.replace_order(order, best_ask, Qty(50.0));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_TRUE(result->matched);
+    EXPECT_EQ(result->fill_quantity, Qty(50.0));
+    EXPECT_EQ(result->fill_price, best_ask);
+    EXPECT_FALSE(engine.get_book("AAPL")->contains("AMEND-ME"));
+}
+
+TEST(MatchingEngine, IocRemainderDoesNotRest) {
+    MatchingEngine engine;
+    engine.seed_book("AAPL", 150.0, 10.0, 1, 100.0);
+    double best_ask = engine.get_book("AAPL")->best_ask()->to_double();
+
+    auto order = make_limit_order("AAPL", Side::Buy, 250.0, best_ask);
+    order.order_id = "IOC-1";
+    order.time_in_force = TimeInForce::IOC;
+    auto result = engine.try_match(order);
+    EXPECT_TRUE(result.matched);
+    EXPECT_EQ(result.fill_quantity, Qty(100.0));
+    EXPECT_EQ(result.remaining_quantity, Qty(150.0));
+    EXPECT_FALSE(engine.get_book("AAPL")->contains("IOC-1"));
+
+    auto passive = make_limit_order("AAPL", Side::Buy, 10.0, 100.0);
+    passive.order_id = "IOC-2";
+    passive.time_in_force = TimeInForce::IOC;
+    result = engine.try_match(passive);
+    EXPECT_FALSE(result.matched);
+    EXPECT_EQ(result.remaining_quantity, Qty(10.0));
+    EXPECT_EQ(engine.get_book("AAPL")->bid_levels(), 1);  // only the seeded level
+}
+
+TEST(MatchingEngine, StopParksUntilTradeReachesIt) {
+    MatchingEngine engine;
+    engine.seed_book("AAPL", 150.0, 10.0, 5, 100.0);
+    Price ask1 = engine.get_book("AAPL")->best_ask().value();
+
+    auto stop = make_market_order("AAPL", Side::Buy, 50.0);
+    stop.order_id = "STOP-1";
+    stop.order_type = OrderType::Stop;
+    stop.stop_price = ask1 + Price(0.01);  // just above the touch
+    auto parked = engine.try_match(stop);
+    EXPECT_TRUE(parked.parked);
+    EXPECT_FALSE(parked.matched);
+    ASSERT_NE(engine.get_stops("AAPL"), nullptr);
+    EXPECT_EQ(engine.get_stops("AAPL")->size(), 1u);
+
+    auto sell_stop = make_market_order("AAPL", Side::Sell, 10.0);
+    sell_stop.order_id = "STOP-2";
+    sell_stop.order_type = OrderType::Stop;
+    sell_stop.stop_price = Price(100.0);
+    EXPECT_TRUE(engine.try_match(sell_stop).parked);
+
+    // Trading only the first ask level leaves the stop untouched
+    engine.try_match(make_market_order("AAPL", Side::Buy, 100.0));
+    EXPECT_TRUE(engine.take_triggered().empty());
+
+    // Sweeping into the second level trades through the stop
+    auto sweep = engine.try_match(make_market_order("AAPL", Side::Buy, 50.0));
+    ASSERT_TRUE(sweep.matched);
+    auto triggered = engine.take_triggered();
+    ASSERT_EQ(triggered.size(), 1u);
+    EXPECT_EQ(triggered[0].order.order_id, "STOP-1");
+    EXPECT_EQ(triggered[0].order.order_type, OrderType::Market);
+    EXPECT_EQ(triggered[0].result.fill_quantity, Qty(50.0));
+    EXPECT_GT(engine.get_last_trade_price("AAPL"), ask1);
+
+    EXPECT_TRUE(engine.cancel_order("AAPL", "STOP-2"));
+    EXPECT_TRUE(engine.get_stops("AAPL")->empty());
+}
+
+TEST(MatchingEngine, StopLimitTriggeredAtOnceAndRests) {
+    MatchingEngine engine;
+    engine.update_market_price("AAPL", 150.0);
+    engine.seed_book("AAPL", 150.0, 10.0, 5, 100.0);
+
+    // Market is already through the stop: behaves as a plain limit order
+    auto order = make_limit_order("AAPL", Side::Sell, 20.0, 160.0);
+    order.order_id = "SL-1";
+    order.order_type = OrderType::StopLimit;
+    order.stop_price = Price(155.0);
+    auto result = engine.try_match(order);
+    EXPECT_FALSE(result.parked);
+    EXPECT_FALSE(result.matched);
+    EXPECT_TRUE(engine.get_book("AAPL")->contains("SL-1"));
+}
+
+TEST(MatchingEngine, IcebergRestsShowingOnlyItsPeak) {
+    MatchingEngine engine;
+    engine.update_market_price("AAPL", 150.0);
+    engine.seed_book("AAPL", 150.0, 10.0, 5, 100.0);
+
+    auto order = make_limit_order("AAPL", Side::Buy, 500.0, 140.0);
+    order.order_id = "ICE-1";
+    order.display_quantity = Qty(50.0);
+    engine.try_match(order);
+
+    const auto* book = engine.get_book("AAPL");
+    const auto* entry = book->find_order("ICE-1");
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->remaining_quantity, Qty(50.0));
+    EXPECT_EQ(entry->reserve_quantity, Qty(450.0));
+    EXPECT_EQ(entry->leaves_quantity(), Qty(500.0));
+    EXPECT_EQ(book->get_depth(BookSide::Bid, 10).back().quantity, Qty(50.0));
+}
+
+TEST(MatchingEngine, CallAuctionUncrossesAtVolumeMaximizingPrice) {
+    MatchingEngine engine;
+    engine.open_auction("AAPL");
+
+    auto submit = [&](Order order, const std::string& id) {
+        order.order_id = id;
+        auto result = engine.try_match(order);
+        EXPECT_TRUE(result.collected);
+        EXPECT_FALSE(result.matched);
+    };
+    submit(make_limit_order("AAPL", Side::Buy, 100.0, 101.0), "B1");
+    submit(make_limit_order("AAPL", Side::Buy, 100.0, 100.0), "B2");
+    submit(make_market_order("AAPL", Side::Buy, 50.0), "B3");
+    submit(make_limit_order("AAPL", Side::Sell, 80.0, 99.0), "S1");
+    submit(make_limit_order("AAPL", Side::Sell, 100.0, 100.0), "S2");
+    submit(make_limit_order("AAPL", Side::Sell, 100.0, 102.0), "S3");
+
+    // Collected, not matched: the book is crossed until the uncross
+    const auto* book = engine.get_book("AAPL");
+    EXPECT_GT(book->best_bid().value(), book->best_ask().value());
+
+    // Executable volume: 80 at 99, 180 at 100, 150 at 101, 50 at 102
+    auto auction = engine.uncross("AAPL");
+    EXPECT_EQ(auction.price, Price(100.0));
+    EXPECT_EQ(auction.volume, Qty(180.0));
+    ASSERT_EQ(auction.fills.size(), 4);
+    EXPECT_EQ(auction.fills[0].order_id, "B3");  // market orders allocate first
+    EXPECT_EQ(auction.fills[0].resting_order_id, "S1");
+    EXPECT_EQ(auction.fills[0].fill_quantity, Qty(50.0));
+    EXPECT_EQ(auction.fills[3].order_id, "B2");
+    EXPECT_EQ(auction.fills[3].resting_order_id, "S2");
+    EXPECT_EQ(auction.fills[3].fill_quantity, Qty(30.0));
+    for (const auto& fill : auction.fills) EXPECT_EQ(fill.fill_price, Price(100.0));
+    EXPECT_TRUE(auction.cancelled.empty());
+
+    EXPECT_EQ(book->best_bid().value(), Price(100.0));
+    EXPECT_EQ(book->find_order("B2")->remaining_quantity, Qty(70.0));
+    EXPECT_EQ(book->best_ask().value(), Price(102.0));
+    EXPECT_EQ(engine.get_last_trade_price("AAPL"), Price(100.0));
+
+    // Still in auction mode: the next order waits for the next uncross
+    EXPECT_TRUE(engine.in_auction("AAPL"));
+    auto late = make_market_order("AAPL", Side::Sell, 500.0);
+    late.order_id = "S4";
+    EXPECT_TRUE(engine.try_match(late).collected);
+    auction = engine.close_auction("AAPL");
+    EXPECT_EQ(auction.volume, Qty(70.0));
+    ASSERT_EQ(auction.cancelled.size(), 1);
+    EXPECT_EQ(auction.cancelled[0], "S4");
+    EXPECT_FALSE(engine.in_auction("AAPL"));
+}
+
+TEST(MatchingEngine, PublishesBookSnapshotsForReaders) {
+    MatchingEngine engine;
+    BookSnapshots snapshots;
+    engine.set_snapshots(&snapshots);
+
+    auto bid = make_limit_order("AAPL", Side::Buy, 100.0, 149.0);
+    engine.try_match(bid);
+    auto ask = make_limit_order("AAPL", Side::Sell, 50.0, 151.0);
+    ask.order_id = "TC-00002";
+    engine.try_match(ask);
+
+    BookSnapshot snap;
+    EXPECT_FALSE(snapshots.load("AAPL", snap));  // nothing until published
+    engine.publish_snapshots();
+    ASSERT_TRUE(snapshots.load("AAPL", snap));
+    ASSERT_NE(snap.best_bid(), nullptr);
+    EXPECT_EQ(snap.best_bid()->price, Price(149.0));
+    EXPECT_EQ(snap.best_ask()->quantity, Qty(50.0));
+    EXPECT_EQ(snap.bid_levels, 1u);
+    uint64_t version = snap.version;
+
+    auto take = make_limit_order("AAPL", Side::Buy, 20.0, 151.0);
+    take.order_id = "TC-00003";
+    engine.try_match(take);
+    engine.publish_snapshots();
+    ASSERT_TRUE(snapshots.load("AAPL", snap));
+    EXPECT_GT(snap.version, version);
+    EXPECT_EQ(snap.best_ask()->quantity, Qty(30.0));
+    EXPECT_EQ(snap.last_trade, Price(151.0));
+}
@@ -9,9 +9,9 @@ OrderEntry make_entry(const std::string& id, double price, double qty) {
     OrderEntry e;
     e.order_id = id;
     e.cl_ord_id = "cl-" + id;
-    e.price = price;
-    e.remaining_quantity = qty;
-    e.original_quantity = qty;
+    e.price = Price(price);
+    e.remaining_quantity = Qty(qty);
+    e.original_quantity = Qty(qty);
     return e;
 }
 
@@ -24,8 +24,8 @@ TEST(OrderBook, AddAndBestBidAsk) {
     book.add_order(BookSide::Ask, make_entry("A1", 102.0, 40));
     book.add_order(BookSide::Ask, make_entry("A2", 103.0, 20));
 
-    EXPECT_EQ(book.best_bid().value(), 101.0);
-    EXPECT_EQ(book.best_ask().value(), 102.0);
+    EXPECT_EQ(book.best_bid().value(), Price(101.0));
+    EXPECT_EQ(book.best_ask().value(), Price(102.0));
     EXPECT_EQ(book.bid_levels(), 2);
     EXPECT_EQ(book.ask_levels(), 2);
 }
@@ -35,18 +35,18 @@ TEST(OrderBook, FIFOPriority) {
     book.add_order(BookSide::Ask, make_entry("A1", 100.0, 50));
     book.add_order(BookSide::Ask, make_entry("A2", 100.0, 30));
 
-    auto fills = book.consume_asks(60);
+    auto fills = book.consume_asks(Qty(60));
     // Should fill A1 fully (50), then A2 partially (10)
     ASSERT_EQ(fills.size(), 2);
     EXPECT_EQ(fills[0].order_id, "A1");
-    EXPECT_EQ(fills[0].remaining_quantity, 50.0);
+    EXPECT_EQ(fills[0].remaining_quantity, Qty(50.0));
     EXPECT_EQ(fills[1].order_id, "A2");
-    EXPECT_EQ(fills[1].remaining_quantity, 10.0);
+    EXPECT_EQ(fills[1].remaining_quantity, Qty(10.0));
 
     // A2 should still have 20 remaining in the book
     auto depth = book.get_depth(BookSide::Ask, 5);
     ASSERT_EQ(depth.size(), 1);
-    EXPECT_EQ(depth[0].quantity, 20.0);
+    EXPECT_EQ(depth[0].quantity, Qty(20.0));
 }
 
 TEST(OrderBook, CancelOrder) {
@@ -59,7 +59,7 @@ TEST(OrderBook, CancelOrder) {
 
     auto depth = book.get_depth(BookSide::Bid, 5);
     ASSERT_EQ(depth.size(), 1);
-    EXPECT_EQ(depth[0].quantity, 30.0);
+    EXPECT_EQ(depth[0].quantity, Qty(30.0));
 }
 
 TEST(OrderBook, DepthMultipleLevels) {
@@ -71,13 +71,13 @@ TEST(OrderBook, DepthMultipleLevels) {
 
     auto depth = book.get_depth(BookSide::Ask, 3);
     ASSERT_EQ(depth.size(), 3);
-    EXPECT_EQ(depth[0].price, 100.0);
-    EXPECT_EQ(depth[0].quantity, 80.0);
+    EXPECT_EQ(depth[0].price, Price(100.0));
+    EXPECT_EQ(depth[0].quantity, Qty(80.0));
     EXPECT_EQ(depth[0].order_count, 2);
-    EXPECT_EQ(depth[1].price, 101.0);
-    EXPECT_EQ(depth[1].quantity, 20.0);
-    EXPECT_EQ(depth[2].price, 102.0);
-    EXPECT_EQ(depth[2].quantity, 10.0);
+    EXPECT_EQ(depth[1].price, Price(101.0));
+    EXPECT_EQ(depth[1].quantity, Qty(20.0));
+    EXPECT_EQ(depth[2].price, Price(102.0));
+    EXPECT_EQ(depth[2].quantity, Qty(10.0));
 }
 
 TEST(OrderBook, Spread) {
@@ -89,7 +89,7 @@ TEST(OrderBook, Spread) {
     auto ask = book.best_ask();
     ASSERT_TRUE(bid.has_value());
     ASSERT_TRUE(ask.has_value());
-    EXPECT_EQ(ask.value() - bid.value(), 2.0);
+    EXPECT_EQ(ask.value() - bid.value(), Price(2.0));
 }
 
 TEST(OrderBook, EmptyBookReturnsNullopt) {
@@ -104,12 +104,253 @@ TEST(OrderBook, ConsumeEntireBook) {
     book.add_order(BookSide::Ask, make_entry("A1", 100.0, 30));
     book.add_order(BookSide::Ask, make_entry("A2", 101.0, 20));
 
-    auto fills = book.consume_asks(100);
+    auto fills = book.consume_asks(Qty(100));
     // Should consume all 50 available, leaving 50 unfilled
     ASSERT_EQ(fills.size(), 2);
-    double total_filled = 0;
+    Qty total_filled;
     for (const auto& f : fills) total_filled += f.remaining_quantity;
-    EXPECT_EQ(total_filled, 50.0);
+    EXPECT_EQ(total_filled, Qty(50.0));
 
     EXPECT_FALSE(book.best_ask().has_value());
 }
+
+TEST(OrderBook, LevelUpdatesTrackMutations) {
+    OrderBook book;
+    book.set_track_updates(true);
+    book.add_order(BookSide::Ask, make_entry("A1", 100.0, 30));
+    book.add_order(BookSide::Ask, make_entry("A2", 101.0, 20));
+    book.clear_level_updates();
+
+    book.consume_asks(Qty(40));
+    const auto& updates = book.level_updates();
+    ASSERT_EQ(updates.size(), 2);
+    EXPECT_EQ(updates[0].action, LevelAction::Delete);
+    EXPECT_EQ(updates[0].price, Price(100.0));
+    EXPECT_EQ(updates[1].action, LevelAction::Change);
+    EXPECT_EQ(updates[1].quantity, Qty(10.0));
+    book.clear_level_updates();
+
+    EXPECT_TRUE(book.cancel_order("A2"));
+    ASSERT_EQ(book.level_updates().size(), 1);
+    EXPECT_EQ(book.level_updates()[0].action, LevelAction::Delete);
+}
+
+TEST(OrderBook, LevelUpdatesOffByDefault) {
+    OrderBook book;
+    book.add_order(BookSide::Bid, make_entry("B1", 100.0, 50));
+    EXPECT_TRUE(book.level_updates().empty());
+}
+
+TEST(OrderBook, ModifyQuantityDownKeepsPriority) {
+    OrderBook book;
+    book.add_order(BookSide::Ask, make_entry("A1", 100.0, 50));
+    book.add_order(BookSide::Ask, make_entry("A2", 100.0, 30));
+
+    ASSERT_TRUE(book.modify_order("A1", Price(100.0), Qty(20)));
+    EXPECT_EQ(book.best_level(BookSide::Ask)->total_quantity(), Qty(50.0));
+
+    auto fills = book.consume_asks(Qty(25));
+    ASSERT_EQ(fills.size(), 2);
+    EXPECT_EQ(fills[0].order_id, "A1");  // still first in the queue
+    EXPECT_EQ(fills[0].remaining_quantity, Qty(20.0));
+}
+
+TEST(OrderBook, ModifyQuantityUpLosesPriority) {
+    OrderBook book;
+    book.add_order(BookSide::Bid, make_entry("B1", 100.0, 50));
+    book.add_order(BookSide::Bid, make_entry("B2", 100.0, 30));
+
+    ASSERT_TRUE(book.modify_order("B1", Price(100.0), Qty(60)));
+    EXPECT_EQ(book.best_level(BookSide::Bid)->total_quantity(), Qty(90.0));
+
+    auto fills = book.consume_bids(Qty(10));
+    ASSERT_EQ(fills.size(), 1);
+    EXPECT_EQ(fills[0].order_id, "B2");
+}
+
+TEST(OrderBook, ModifyPriceMovesLevel) {
+    OrderBook book;
+    book.set_track_updates(true);
+    book.add_order(BookSide::Bid, make_entry("B1", 100.0, 50));
+    book.add_order(BookSide::Bid, make_entry("B2", 99.0, 30));
+    book.clear_level_updates();
+
+    ASSERT_TRUE(book.modify_order("B1", Price(99.0), Qty(40)));
+    EXPECT_EQ(book.bid_levels(), 1);
+    EXPECT_EQ(book.best_bid().value(), Price(99.0));
+    EXPECT_EQ(book.best_level(BookSide::Bid)->total_quantity(), Qty(70.0));
+    ASSERT_NE(book.find_order("B1"), nullptr);
+    EXPECT_EQ(book.find_order("B1")->price, Price(99.0));
+
+    const auto& updates = book.level_updates();
+    ASSERT_EQ(updates.size(), 2);
+    EXPECT_EQ(updates[0].action, LevelAction::Delete);
+    EXPECT_EQ(updates[0].price, Price(100.0));
+    EXPECT_EQ(updates[1].action, LevelAction::Change);
+    EXPECT_EQ(updates[1].order_count, 2);
+
+    // The index follows the move: cancel finds it at the new price
+    EXPECT_TRUE(book.cancel_order("B1"));
+    EXPECT_EQ(book.best_level(BookSide::Bid)->total_quantity(), Qty(30.0));
+}
+
+TEST(OrderBook, ModifyUnknownOrZeroQuantity) {
+    OrderBook book;
+    book.add_order(BookSide::Ask, make_entry("A1", 100.0, 50));
+    EXPECT_FALSE(book.modify_order("NOPE", Price(100.0), Qty(10)));
+    EXPECT_TRUE(book.modify_order("A1", Price(100.0), Qty(0)));
+    EXPECT_FALSE(book.contains("A1"));
+    EXPECT_EQ(book.ask_levels(), 0);
+}
+
+TEST(OrderBook, CancelOrdersSweepsEachLevelOnce) {
+    OrderBook book;
+    book.set_track_updates(true);
+    book.add_order(BookSide::Bid, make_entry("B1", 99.0, 10));
+    book.add_order(BookSide::Bid, make_entry("B2", 99.0, 20));
+    book.add_order(BookSide::Bid, make_entry("B3", 99.0, 30));
+    book.add_order(BookSide::Ask, make_entry("A1", 101.0, 40));
+    book.add_order(BookSide::Ask, make_entry("A2", 102.0, 50));
+    book.clear_level_updates();
+
+    EXPECT_EQ(book.cancel_orders({"B1", "B3", "A1", "NOPE"}), 3);
+    EXPECT_FALSE(book.contains("B1"));
+    EXPECT_TRUE(book.contains("B2"));
+    EXPECT_EQ(book.best_level(BookSide::Bid)->total_quantity(), Qty(20.0));
+    EXPECT_EQ(book.best_ask().value(), Price(102.0));
+
+    // One update per affected level, not per order
+    const auto& updates = book.level_updates();
+    ASSERT_EQ(updates.size(), 2);
+    EXPECT_EQ(updates[0].action, LevelAction::Change);
+    EXPECT_EQ(updates[0].quantity, Qty(20.0));
+    EXPECT_EQ(updates[1].action, LevelAction::Delete);
+    EXPECT_EQ(updates[1].price, Price(101.0));
+}
+
+TEST(OrderBook, IcebergReplenishesBehindTheLevel) {
+    OrderBook book;
+    auto ice = make_entry("ICE", 100.0, 10);
+    ice.peak_quantity = Qty(10);
+    ice.reserve_quantity = Qty(25);
+    book.add_order(BookSide::Ask, ice);
+    book.add_order(BookSide::Ask, make_entry("A2", 100.0, 5));
+
+    // Only the peak is displayed; the reserve is not
+    auto depth = book.get_depth(BookSide::Ask);
+    ASSERT_EQ(depth.size(), 1);
+    EXPECT_EQ(depth[0].quantity, Qty(15.0));
+
+    // Exhausting the tranche refills it and sends it behind A2
+    auto fills = book.consume_asks(Qty(12));
+    ASSERT_EQ(fills.size(), 2);
+    EXPECT_EQ(fills[0].order_id, "ICE");
+    EXPECT_EQ(fills[0].remaining_quantity, Qty(10.0));
+    EXPECT_EQ(fills[1].order_id, "A2");
+    EXPECT_EQ(fills[1].remaining_quantity, Qty(2.0));
+
+    const auto* level = book.best_level(BookSide::Ask);
+    ASSERT_EQ(level->orders.size(), 2);
+    EXPECT_EQ(level->orders.back().order_id, "ICE");
+    EXPECT_EQ(level->orders.back().remaining_quantity, Qty(10.0));
+    EXPECT_EQ(level->orders.back().reserve_quantity, Qty(15.0));
+    EXPECT_EQ(level->total_quantity(), Qty(13.0));
+
+    // A sweep works through every refill; the last tranche is the odd 5
+    fills = book.consume_asks(Qty(100));
+    Qty filled;
+    for (const auto& f : fills) filled += f.remaining_quantity;
+    EXPECT_EQ(filled, Qty(28.0));
+    EXPECT_FALSE(book.contains("ICE"));
+    EXPECT_EQ(book.ask_levels(), 0);
+}
+
+TEST(OrderBook, HiddenOrdersMatchButStayOutOfDepth) {
+    OrderBook book;
+    book.set_track_updates(true);
+    auto hidden = make_entry("H1", 100.0, 40);
+    hidden.hidden = true;
+    book.add_order(BookSide::Bid, hidden);
+    book.add_order(BookSide::Bid, make_entry("B2", 99.0, 10));
+
+    // The hidden-only level is never announced or shown
+    auto depth = book.get_depth(BookSide::Bid);
+    ASSERT_EQ(depth.size(), 1);
+    EXPECT_EQ(depth[0].price, Price(99.0));
+    EXPECT_EQ(book.best_displayed_level(BookSide::Bid)->price, Price(99.0));
+    EXPECT_EQ(book.best_bid().value(), Price(100.0));
+    ASSERT_EQ(book.level_updates().size(), 1);
+    EXPECT_EQ(book.level_updates()[0].price, Price(99.0));
+
+    // A visible order at the hidden price shows only its own size
+    book.add_order(BookSide::Bid, make_entry("B3", 100.0, 5));
+    EXPECT_EQ(book.level_updates().back().action, LevelAction::New);
+    EXPECT_EQ(book.level_updates().back().quantity, Qty(5.0));
+    EXPECT_EQ(book.level_updates().back().order_count, 1);
+
+    // Hidden liquidity still trades in time priority; the level is withdrawn
+    // once only hidden quantity remains
+    book.clear_level_updates();
+    auto fills = book.consume_bids(Qty(45));
+    ASSERT_EQ(fills.size(), 2);
+    EXPECT_EQ(fills[0].order_id, "H1");
+    EXPECT_EQ(book.best_level(BookSide::Bid)->price, Price(99.0));
+
+    book.add_order(BookSide::Bid, hidden);
+    book.add_order(BookSide::Bid, make_entry("B4", 100.0, 5));
+    book.clear_level_updates();
+    EXPECT_TRUE(book.cancel_order("B4"));
+    ASSERT_EQ(book.level_updates().size(), 1);
+    EXPECT_EQ(book.level_updates()[0].action, LevelAction::Delete);
+    EXPECT_EQ(book.get_depth(BookSide::Bid).size(), 1);
+}
+
+TEST(OrderBook, SelfTradePreventionModes) {
+    auto own = [](const std::string& id, double qty) {
+        auto e = make_entry(id, 100.0, qty);
+        e.owner_id = 7;
+        return e;
+    };
+    const SelfTradeGuard cancel_resting{7, SelfTradePrevention::CancelResting};
+    const SelfTradeGuard cancel_aggressor{7, SelfTradePrevention::CancelAggressor};
+    const SelfTradeGuard decrement{7, SelfTradePrevention::DecrementBoth};
+
+    // Cancel resting: the own order leaves the book and matching goes on
+    OrderBook book;
+    book.add_order(BookSide::Ask, own("OWN", 30));
+    book.add_order(BookSide::Ask, make_entry("A2", 100.0, 50));
+    SelfTradeOutcome outcome;
+    auto fills = book.consume_asks(Qty(40), cancel_resting, &outcome);
+    ASSERT_EQ(fills.size(), 1);
+    EXPECT_EQ(fills[0].order_id, "A2");
+    EXPECT_EQ(fills[0].remaining_quantity, Qty(40.0));
+    ASSERT_EQ(outcome.resting.size(), 1);
+    EXPECT_EQ(outcome.resting[0].remaining_quantity, Qty(30.0));
+    EXPECT_EQ(outcome.aggressor_quantity, Qty(0.0));
+    EXPECT_FALSE(book.contains("OWN"));
+
+    // Cancel aggressor: matching stops at the own order, which stays
+    OrderBook book2;
+    book2.add_order(BookSide::Ask, make_entry("A1", 100.0, 10));
+    book2.add_order(BookSide::Ask, own("OWN", 30));
+    SelfTradeOutcome outcome2;
+    fills = book2.consume_asks(Qty(40), cancel_aggressor, &outcome2);
+    ASSERT_EQ(fills.size(), 1);
+    EXPECT_EQ(outcome2.aggressor_quantity, Qty(30.0));
+    EXPECT_TRUE(outcome2.resting.empty());
+    EXPECT_EQ(book2.best_level(BookSide::Ask)->total_quantity(), Qty(30.0));
+
+    // Decrement both: the overlap comes off each side without a fill
+    OrderBook book3;
+    book3.add_order(BookSide::Ask, own("OWN", 30));
+    SelfTradeOutcome outcome3;
+    fills = book3.consume_asks(Qty(20), decrement, &outcome3);
+    EXPECT_TRUE(fills.empty());
+    EXPECT_EQ(outcome3.aggressor_quantity, Qty(20.0));
+    EXPECT_EQ(book3.find_order("OWN")->remaining_quantity, Qty(10.0));
+
+    // Other owners trade as usual
+    fills = book3.consume_asks(Qty(5), SelfTradeGuard{8, SelfTradePrevention::CancelResting});
+    ASSERT_EQ(fills.size(), 1);
+    EXPECT_EQ(fills[0].remaining_quantity, Qty(5.0));
+}
@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
 #include "orders/order_manager.hpp"
 
 using namespace tradecore;
@@ -96,6 +98,58 @@ TEST_F(OrderManagerTest, RejectMissingSymbol) {
     EXPECT_TRUE(responses[0].has_reject());
 }
 
+TEST_F(OrderManagerTest, RejectOutOfRangeValues) {
+    // Each would overflow (or be undefined) in the fixed-point conversion
+    auto nan = make_new_order_msg();
+    nan.mutable_new_order_single()->set_order_qty(std::nan(""));
+    auto huge_price = make_new_order_msg();
+    huge_price.mutable_new_order_single()->set_ord_type(fix::ORD_TYPE_LIMIT);
+    huge_price.mutable_new_order_single()->set_price(1e12);
+    auto inf_stop = make_new_order_msg();
+    inf_stop.mutable_new_order_single()->set_stop_px(std::numeric_limits<double>::infinity());
+    auto huge_floor = make_new_order_msg();
+    huge_floor.mutable_new_order_single()->set_max_floor(-1e11);
+
+    for (const auto& msg : {nan, huge_price, inf_stop, huge_floor}) {
+        auto responses = mgr->handle_new_order(msg);
+        ASSERT_EQ(responses.size(), 1);
+        EXPECT_TRUE(responses[0].has_reject());
+    }
+    EXPECT_EQ(mgr->order_count(), 0);
+
+    auto limit_msg = make_new_order_msg("AAPL", fix::SIDE_BUY, 50.0);
+    limit_msg.mutable_new_order_single()->set_ord_type(fix::ORD_TYPE_LIMIT);
+    limit_msg.mutable_new_order_single()->set_price(100.0);
+    mgr->handle_new_order(limit_msg);
+
+    fix::FixMessage replace_msg;
+    auto* rep = replace_msg.mutable_order_cancel_replace_request();
+    rep->set_cl_ord_id("test-002");
+    rep->set_orig_cl_ord_id("test-001");
+    rep->set_order_qty(50.0);
+    rep->set_price(std::nan(""));
+    EXPECT_TRUE(mgr->handle_cancel_replace(replace_msg)[0].has_reject());
+    EXPECT_EQ(mgr->find_order_by_cl_ord_id("test-001")->limit_price, Price(100.0));
+}
+
+TEST_F(OrderManagerTest, MaximalOrdersSumAtOneLevel) {
+    auto sell = [&](const std::string& cl_ord_id, double qty) {
+        auto msg = make_new_order_msg("MSFT", fix::SIDE_SELL, qty);
+        msg.mutable_new_order_single()->set_cl_ord_id(cl_ord_id);
+        msg.mutable_new_order_single()->set_ord_type(fix::ORD_TYPE_LIMIT);
+        msg.mutable_new_order_single()->set_price(100.0);
+        return mgr->handle_new_order(msg);
+    };
+    // Past the bound, even though it would still convert on its own
+    EXPECT_TRUE(sell("too-big", 8e10)[0].has_reject());
+
+    ASSERT_FALSE(sell("max-1", Qty::kMaxDouble)[0].has_reject());
+    ASSERT_FALSE(sell("max-2", Qty::kMaxDouble)[0].has_reject());
+    const auto* level = matcher.get_book("MSFT")->best_level(matching::BookSide::Ask);
+    ASSERT_NE(level, nullptr);
+    EXPECT_EQ(level->total_quantity(), Qty(2 * Qty::kMaxDouble));
+}
+
 TEST_F(OrderManagerTest, FillBooksTrade) {
     auto msg = make_new_order_msg();
     mgr->handle_new_order(msg);
@@ -103,7 +157,7 @@ TEST_F(OrderManagerTest, FillBooksTrade) {
     EXPECT_GE(book_keeper.trade_count(), 1);
     auto* pos = book_keeper.get_position("AAPL");
     ASSERT_NE(pos, nullptr);
-    EXPECT_EQ(pos->quantity, 100.0);
+    EXPECT_EQ(pos->quantity, Qty(100.0));
 }
 
 TEST_F(OrderManagerTest, OrderIdSequence) {
@@ -205,3 +259,457 @@ TEST_F(OrderManagerTest, PartialFillCommission) {
     EXPECT_GE(fill_count, 1);
     EXPECT_GT(total_commission, 0.0);
 }
+
+TEST_F(OrderManagerTest, RiskRejectBeforeMatching) {
+    risk::LimitSet limits;
+    limits.defaults.max_order_qty = 50.0;
+    risk::RiskEngine risk(book_keeper, limits);
+    mgr->set_risk_engine(&risk);
+
+    auto responses = mgr->handle_new_order(make_new_order_msg("AAPL", fix::SIDE_BUY, 100.0));
+    ASSERT_EQ(responses.size(), 1);
+    ASSERT_TRUE(responses[0].has_reject());
+    EXPECT_NE(responses[0].reject().text().find("Risk"), std::string::npos);
+    EXPECT_EQ(book_keeper.trade_count(), 0);
+
+    responses = mgr->handle_new_order(make_new_order_msg("AAPL", fix::SIDE_BUY, 50.0));
+    ASSERT_FALSE(responses.empty());
+    EXPECT_TRUE(responses[0].has_execution_report());
+}
+
+TEST_F(OrderManagerTest, CancelReplaceAmendsRestingOrder) {
+    matcher.seed_book("AAPL", 150.0, 10.0, 5, 1000.0);
+
+    auto limit_msg = make_new_order_msg("AAPL", fix::SIDE_BUY, 50.0);
+    limit_msg.mutable_new_order_single()->set_cl_ord_id("quote-1");
+    limit_msg.mutable_new_order_single()->set_ord_type(fix::ORD_TYPE_LIMIT);
+    limit_msg.mutable_new_order_single()->set_price(140.0);
+    ASSERT_EQ(mgr->handle_new_order(limit_msg)[0].execution_report().exec_type(), fix::EXEC_TYPE_NEW);
+
+    fix::FixMessage replace_msg;
+    replace_msg.set_sender_comp_id("TEST_CLIENT");
+    auto* rep = replace_msg.mutable_order_cancel_replace_request();
+    rep->set_cl_ord_id("quote-2");
+    rep->set_orig_cl_ord_id("quote-1");
+    rep->mutable_instrument()->set_symbol("AAPL");
+    rep->set_side(fix::SIDE_BUY);
+    rep->set_order_qty(30.0);
+    rep->set_ord_type(fix::ORD_TYPE_LIMIT);
+    rep->set_price(141.0);
+
+    auto responses = mgr->handle_cancel_replace(replace_msg);
+    ASSERT_EQ(responses.size(), 1);
+    ASSERT_TRUE(responses[0].has_execution_report());
+    const auto& er = responses[0].execution_report();
+    EXPECT_EQ(er.exec_type(), fix::EXEC_TYPE_REPLACED);
+    EXPECT_EQ(er.ord_status(), fix::ORD_STATUS_NEW);
+    EXPECT_EQ(er.cl_ord_id(), "quote-2");
+    EXPECT_EQ(er.orig_cl_ord_id(), "quote-1");
+    EXPECT_EQ(er.leaves_qty(), 30.0);
+
+    auto* order = mgr->find_order_by_cl_ord_id("quote-2");
+    ASSERT_NE(order, nullptr);
+    EXPECT_EQ(order->limit_price, Price(141.0));
+    EXPECT_EQ(matcher.get_book("AAPL")->find_order(order->order_id)->remaining_quantity, Qty(30.0));
+
+    // Reusing a ClOrdID is rejected
+    rep->set_orig_cl_ord_id("quote-2");
+    EXPECT_TRUE(mgr->handle_cancel_replace(replace_msg)[0].has_reject());
+
+    // Amending through the spread trades
+    rep->set_cl_ord_id("quote-3");
+    rep->set_price(matcher.get_book("AAPL")->best_ask()->to_double());
+    responses = mgr->handle_cancel_replace(replace_msg);
+    ASSERT_EQ(responses.size(), 2);
+    EXPECT_EQ(responses[0].execution_report().exec_type(), fix::EXEC_TYPE_REPLACED);
+    EXPECT_EQ(responses[1].execution_report().exec_type(), fix::EXEC_TYPE_FILL);
+    EXPECT_EQ(responses[1].execution_report().cl_ord_id(), "quote-3");
+    EXPECT_EQ(book_keeper.trade_count(), 1);
+    EXPECT_EQ(mgr->find_order_by_cl_ord_id("quote-3")->status, OrderStatus::Filled);
+}
+
+TEST_F(OrderManagerTest, CancelReplaceUnknownOrder) {
+    fix::FixMessage replace_msg;
+    auto* rep = replace_msg.mutable_order_cancel_replace_request();
+    rep->set_cl_ord_id("x-2");
+    rep->set_orig_cl_ord_id("x-1");
+    rep->set_order_qty(10.0);
+    rep->set_price(100.0);
+    auto responses = mgr->handle_cancel_replace(replace_msg);
+    ASSERT_EQ(responses.size(), 1);
+    EXPECT_TRUE(responses[0].has_reject());
+}
+
+TEST_F(OrderManagerTest, MassCancelBySessionSymbolAndStrategy) {
+    matcher.update_market_price("MSFT", 300.0);
+    auto rest = [&](const std::string& cl_ord_id, const std::string& symbol, double price,
+                    const std::string& strategy, const std::string& session) {
+        auto msg = make_new_order_msg(symbol, fix::SIDE_BUY, 10.0);
+        msg.mutable_new_order_single()->set_cl_ord_id(cl_ord_id);
+        msg.mutable_new_order_single()->set_ord_type(fix::ORD_TYPE_LIMIT);
+        msg.mutable_new_order_single()->set_price(price);
+        msg.mutable_new_order_single()->set_text(strategy);
+        ASSERT_EQ(mgr->handle_new_order(msg, session)[0].execution_report().exec_type(),
+                  fix::EXEC_TYPE_NEW);
+    };
+    rest("a1", "AAPL", 140.0, "mm", "s1");
+    rest("a2", "AAPL", 141.0, "arb", "s1");
+    rest("m1", "MSFT", 290.0, "mm", "s1");
+    rest("x1", "AAPL", 139.0, "mm", "s2");
+    EXPECT_EQ(mgr->open_order_count("s1"), 3);
+
+    fix::FixMessage msg;
+    msg.set_sender_comp_id("TEST_CLIENT");
+    auto* req = msg.mutable_order_mass_cancel_request();
+    req->set_cl_ord_id("mc-1");
+    req->set_mass_cancel_request_type(fix::MASS_CANCEL_SECURITY);
+    req->mutable_instrument()->set_symbol("AAPL");
+    req->set_text("mm");
+
+    // Only s1's AAPL orders for strategy "mm"
+    auto responses = mgr->handle_mass_cancel(msg, "s1");
+    ASSERT_EQ(responses.size(), 1);
+    ASSERT_TRUE(responses[0].has_order_mass_cancel_report());
+    const auto& rpt = responses[0].order_mass_cancel_report();
+    EXPECT_EQ(rpt.cl_ord_id(), "mc-1");
+    EXPECT_EQ(rpt.mass_cancel_response(), fix::MASS_CANCEL_RESPONSE_SECURITY);
+    EXPECT_EQ(rpt.total_affected_orders(), 1);
+    EXPECT_EQ(mgr->find_order_by_cl_ord_id("a1")->status, OrderStatus::Cancelled);
+    EXPECT_FALSE(matcher.get_book("AAPL")->contains(mgr->find_order_by_cl_ord_id("a1")->order_id));
+    EXPECT_EQ(mgr->find_order_by_cl_ord_id("a2")->status, OrderStatus::Accepted);
+
+    // Everything left on s1
+    req->set_mass_cancel_request_type(fix::MASS_CANCEL_ALL);
+    req->clear_text();
+    responses = mgr->handle_mass_cancel(msg, "s1");
+    EXPECT_EQ(responses[0].order_mass_cancel_report().total_affected_orders(), 2);
+    EXPECT_EQ(mgr->open_order_count("s1"), 0);
+    EXPECT_EQ(mgr->find_order_by_cl_ord_id("x1")->status, OrderStatus::Accepted);
+
+    // Kill switch across sessions
+    EXPECT_EQ(mgr->cancel_orders(MassCancelFilter{}), 1);
+    EXPECT_EQ(mgr->open_order_count("s2"), 0);
+
+    // SECURITY without a symbol is rejected
+    req->set_mass_cancel_request_type(fix::MASS_CANCEL_SECURITY);
+    req->mutable_instrument()->clear_symbol();
+    responses = mgr->handle_mass_cancel(msg, "s1");
+    EXPECT_EQ(responses[0].order_mass_cancel_report().mass_cancel_response(),
+              fix::MASS_CANCEL_RESPONSE_REJECTED);
+}
+
+TEST_F(OrderManagerTest, MassCancelSkipsOrdersFilledWhileResting) {
+    auto limit = [&](const std::string& cl_ord_id, fix::Side side, double qty, double price,
+                     const std::string& strategy, const std::string& session) {
+        auto msg = make_new_order_msg("MSFT", side, qty);
+        msg.mutable_new_order_single()->set_cl_ord_id(cl_ord_id);
+        msg.mutable_new_order_single()->set_ord_type(fix::ORD_TYPE_LIMIT);
+        msg.mutable_new_order_single()->set_price(price);
+        msg.mutable_new_order_single()->set_text(strategy);
+        return mgr->handle_new_order(msg, session);
+    };
+    limit("s-1", fix::SIDE_SELL, 10.0, 100.0, "mm", "s1");
+    limit("s-2", fix::SIDE_SELL, 10.0, 101.0, "mm", "s1");
+    EXPECT_EQ(mgr->open_order_count("s1"), 2);
+
+    // Takes all of s-1 and half of s-2
+    auto responses = limit("b-1", fix::SIDE_BUY, 15.0, 101.0, "taker", "s2");
+    ASSERT_EQ(responses.size(), 2);
+    EXPECT_EQ(mgr->find_order_by_cl_ord_id("s-1")->status, OrderStatus::Filled);
+    EXPECT_EQ(mgr->find_order_by_cl_ord_id("s-2")->status, OrderStatus::PartiallyFilled);
+    EXPECT_EQ(mgr->open_order_count("s1"), 1);
+
+    fix::FixMessage msg;
+    auto* req = msg.mutable_order_mass_cancel_request();
+    req->set_cl_ord_id("mc-1");
+    req->set_mass_cancel_request_type(fix::MASS_CANCEL_ALL);
+    responses = mgr->handle_mass_cancel(msg, "s1");
+    ASSERT_EQ(responses.size(), 1);
+    EXPECT_EQ(responses[0].order_mass_cancel_report().total_affected_orders(), 1);
+    EXPECT_EQ(mgr->find_order_by_cl_ord_id("s-1")->status, OrderStatus::Filled);
+    EXPECT_EQ(mgr->find_order_by_cl_ord_id("s-2")->status, OrderStatus::Cancelled);
+    EXPECT_EQ(mgr->open_order_count("s1"), 0);
+
+    // Cancel-on-disconnect counts only what the book still held
+    limit("s-3", fix::SIDE_SELL, 10.0, 102.0, "mm", "s3");
+    limit("s-4", fix::SIDE_SELL, 10.0, 103.0, "mm", "s3");
+    limit("b-2", fix::SIDE_BUY, 10.0, 102.0, "taker", "s2");
+    EXPECT_EQ(mgr->cancel_orders({"s3", "", ""}), 1);
+    EXPECT_EQ(mgr->find_order_by_cl_ord_id("s-3")->status, OrderStatus::Filled);
+    EXPECT_EQ(mgr->find_order_by_cl_ord_id("s-4")->status, OrderStatus::Cancelled);
+}
+
+TEST_F(OrderManagerTest, IocCancelsRemainderInsteadOfResting) {
+    matcher.seed_book("AAPL", 150.0, 10.0, 1, 100.0);
+    double best_ask = matcher.get_book("AAPL")->best_ask()->to_double();
+
+    auto msg = make_new_order_msg("AAPL", fix::SIDE_BUY, 250.0);
+    msg.mutable_new_order_single()->set_ord_type(fix::ORD_TYPE_LIMIT);
+    msg.mutable_new_order_single()->set_price(best_ask);
+    msg.mutable_new_order_single()->set_time_in_force(fix::TIF_IOC);
+
+    auto responses = mgr->handle_new_order(msg);
+    ASSERT_EQ(responses.size(), 2);
+    EXPECT_EQ(responses[0].execution_report().exec_type(), fix::EXEC_TYPE_PARTIAL_FILL);
+    const auto& done = responses[1].execution_report();
+    EXPECT_EQ(done.exec_type(), fix::EXEC_TYPE_CANCELLED);
+    EXPECT_EQ(done.leaves_qty(), 0.0);
+    EXPECT_EQ(done.cum_qty(), 100.0);
+
+    const auto* order = mgr->find_order_by_cl_ord_id("test-001");
+    EXPECT_EQ(order->status, OrderStatus::Cancelled);
+    EXPECT_FALSE(matcher.get_book("AAPL")->contains(order->order_id));
+}
+
+TEST_F(OrderManagerTest, DayOrdersExpireGtcPersist) {
+    matcher.seed_book("AAPL", 150.0, 10.0, 5, 1000.0);
+    auto rest = [&](const std::string& cl_ord_id, fix::TimeInForce tif) {
+        auto msg = make_new_order_msg("AAPL", fix::SIDE_BUY, 10.0);
+        msg.mutable_new_order_single()->set_cl_ord_id(cl_ord_id);
+        msg.mutable_new_order_single()->set_ord_type(fix::ORD_TYPE_LIMIT);
+        msg.mutable_new_order_single()->set_price(140.0);
+        msg.mutable_new_order_single()->set_time_in_force(tif);
+        mgr->handle_new_order(msg);
+        return mgr->find_order_by_cl_ord_id(cl_ord_id)->order_id;
+    };
+    auto day1 = rest("day-1", fix::TIF_DAY);
+    auto day2 = rest("day-2", fix::TIF_DAY);
+    auto gtc = rest("gtc-1", fix::TIF_GTC);
+    ASSERT_EQ(mgr->handle_cancel_request(make_cancel_msg("day-2")).size(), 1);
+
+    EXPECT_EQ(mgr->expire_day_orders(), 1);
+    EXPECT_EQ(mgr->find_order(day1)->status, OrderStatus::Expired);
+    EXPECT_EQ(mgr->find_order(day2)->status, OrderStatus::Cancelled);
+    EXPECT_EQ(mgr->find_order(gtc)->status, OrderStatus::Accepted);
+    EXPECT_FALSE(matcher.get_book("AAPL")->contains(day1));
+    EXPECT_TRUE(matcher.get_book("AAPL")->contains(gtc));
+    EXPECT_EQ(mgr->expire_day_orders(), 0);
+}
+
+TEST_F(OrderManagerTest, DayOrderFilledWhileRestingDoesNotExpire) {
+    auto limit = [&](const std::string& cl_ord_id, fix::Side side, const std::string& session) {
+        auto msg = make_new_order_msg("MSFT", side, 10.0);
+        msg.mutable_new_order_single()->set_cl_ord_id(cl_ord_id);
+        msg.mutable_new_order_single()->set_ord_type(fix::ORD_TYPE_LIMIT);
+        msg.mutable_new_order_single()->set_price(100.0);
+        msg.mutable_new_order_single()->set_time_in_force(fix::TIF_DAY);
+        msg.mutable_new_order_single()->set_text(session);
+        mgr->handle_new_order(msg, session);
+    };
+    limit("day-sell", fix::SIDE_SELL, "s1");
+    limit("day-buy", fix::SIDE_BUY, "s2");
+    EXPECT_EQ(mgr->find_order_by_cl_ord_id("day-sell")->status, OrderStatus::Filled);
+    EXPECT_EQ(mgr->open_order_count("s1"), 0);
+
+    EXPECT_EQ(mgr->expire_day_orders(), 0);
+    EXPECT_EQ(mgr->find_order_by_cl_ord_id("day-sell")->status, OrderStatus::Filled);
+}
+
+TEST_F(OrderManagerTest, StopTriggersAndReportsToOwner) {
+    matcher.seed_book("AAPL", 150.0, 10.0, 5, 100.0);
+    std::vector<std::pair<std::string, fix::FixMessage>> unsolicited;
+    mgr->set_report_sink([&](const std::string& session, const fix::FixMessage& report) {
+        unsolicited.emplace_back(session, report);
+    });
+
+    // Sell stop below the market: parked until a trade prints at or under it
+    auto stop_msg = make_new_order_msg("AAPL", fix::SIDE_SELL, 30.0);
+    stop_msg.mutable_new_order_single()->set_cl_ord_id("stop-1");
+    stop_msg.mutable_new_order_single()->set_ord_type(fix::ORD_TYPE_STOP);
+    stop_msg.mutable_new_order_single()->set_stop_px(149.75);
+    auto responses = mgr->handle_new_order(stop_msg, "owner");
+    ASSERT_EQ(responses.size(), 1);
+    EXPECT_EQ(responses[0].execution_report().exec_type(), fix::EXEC_TYPE_NEW);
+    EXPECT_EQ(mgr->open_order_count("owner"), 1);
+
+    // Another session's sell sweeps four bid levels, down to 149.70
+    auto sweep = make_new_order_msg("AAPL", fix::SIDE_SELL, 400.0);
+    sweep.mutable_new_order_single()->set_cl_ord_id("sweep-1");
+    mgr->handle_new_order(sweep, "other");
+
+    ASSERT_EQ(unsolicited.size(), 1u);
+    EXPECT_EQ(unsolicited[0].first, "owner");
+    const auto& fill = unsolicited[0].second.execution_report();
+    EXPECT_EQ(fill.cl_ord_id(), "stop-1");
+    EXPECT_EQ(fill.exec_type(), fix::EXEC_TYPE_FILL);
+    EXPECT_EQ(fill.last_qty(), 30.0);
+    const auto* stop = mgr->find_order_by_cl_ord_id("stop-1");
+    EXPECT_EQ(stop->order_type, OrderType::Market);
+    EXPECT_EQ(stop->status, OrderStatus::Filled);
+    EXPECT_EQ(book_keeper.trade_count(), 5);  // four sweep fills and the stop
+    EXPECT_EQ(mgr->open_order_count("owner"), 0);
+}
+
+TEST_F(OrderManagerTest, RejectStopWithoutStopPx) {
+    auto msg = make_new_order_msg();
+    msg.mutable_new_order_single()->set_ord_type(fix::ORD_TYPE_STOP);
+    auto responses = mgr->handle_new_order(msg);
+    ASSERT_EQ(responses.size(), 1);
+    EXPECT_TRUE(responses[0].has_reject());
+}
+
+TEST_F(OrderManagerTest, RejectIcebergMarketOrder) {
+    auto msg = make_new_order_msg();
+    msg.mutable_new_order_single()->set_max_floor(10.0);
+    auto responses = mgr->handle_new_order(msg);
+    ASSERT_EQ(responses.size(), 1);
+    EXPECT_TRUE(responses[0].has_reject());
+}
+
+TEST_F(OrderManagerTest, AuctionFillsReportedToEachParticipant) {
+    std::vector<std::pair<std::string, fix::FixMessage>> unsolicited;
+    mgr->set_report_sink([&](const std::string& session, const fix::FixMessage& report) {
+        unsolicited.emplace_back(session, report);
+    });
+    mgr->open_auction("MSFT");
+
+    auto limit = [&](const std::string& cl_ord_id, fix::Side side, double qty, double px) {
+        auto msg = make_new_order_msg("MSFT", side, qty);
+        msg.mutable_new_order_single()->set_cl_ord_id(cl_ord_id);
+        msg.mutable_new_order_single()->set_ord_type(fix::ORD_TYPE_LIMIT);
+        msg.mutable_new_order_single()->set_price(px);
+        return msg;
+    };
+    auto responses = mgr->handle_new_order(limit("buy-1", fix::SIDE_BUY, 100.0, 10.0), "buyer");
+    ASSERT_EQ(responses.size(), 1);
+    EXPECT_EQ(responses[0].execution_report().exec_type(), fix::EXEC_TYPE_NEW);
+    mgr->handle_new_order(limit("sell-1", fix::SIDE_SELL, 60.0, 10.0), "seller");
+    auto market = make_new_order_msg("MSFT", fix::SIDE_SELL, 20.0);
+    market.mutable_new_order_single()->set_cl_ord_id("sell-2");
+    mgr->handle_new_order(market, "seller");
+    EXPECT_EQ(book_keeper.trade_count(), 0);
+
+    auto auction = mgr->uncross("MSFT");
+    EXPECT_EQ(auction.price, Price(10.0));
+    EXPECT_EQ(auction.volume, Qty(80.0));
+    EXPECT_EQ(book_keeper.trade_count(), 4);  // both sides of two prints
+
+    // Buyer first (first fill), then each seller order
+    ASSERT_EQ(unsolicited.size(), 4u);
+    EXPECT_EQ(unsolicited[0].first, "buyer");
+    EXPECT_EQ(unsolicited[1].first, "buyer");
+    EXPECT_EQ(unsolicited[1].second.execution_report().cum_qty(), 80.0);
+    EXPECT_EQ(unsolicited[2].second.execution_report().cl_ord_id(), "sell-2");
+    EXPECT_EQ(unsolicited[3].second.execution_report().cl_ord_id(), "sell-1");
+    EXPECT_EQ(mgr->find_order_by_cl_ord_id("buy-1")->status, OrderStatus::PartiallyFilled);
+    EXPECT_EQ(mgr->find_order_by_cl_ord_id("sell-1")->status, OrderStatus::Filled);
+    EXPECT_EQ(mgr->open_order_count("buyer"), 1);
+    EXPECT_EQ(mgr->open_order_count("seller"), 0);
+
+    // Back to continuous trading, the leftover bid trades at once
+    mgr->close_auction("MSFT");
+    responses = mgr->handle_new_order(limit("sell-3", fix::SIDE_SELL, 20.0, 10.0), "seller");
+    EXPECT_EQ(responses[0].execution_report().exec_type(), fix::EXEC_TYPE_FILL);
+}
+
+TEST_F(OrderManagerTest, SelfTradeCancelsRestingOrderOfSameStrategy) {
+    matcher.set_self_trade_prevention(matching::SelfTradePrevention::CancelResting);
+    matcher.seed_book("AAPL", 150.0, 10.0, 5, 100.0);
+    std::vector<std::pair<std::string, fix::FixMessage>> unsolicited;
+    mgr->set_report_sink([&](const std::string& session, const fix::FixMessage& report) {
+        unsolicited.emplace_back(session, report);
+    });
+
+    // Rest a sell at the front of the book, then buy through it with the same strategy
+    auto rest = make_new_order_msg("AAPL", fix::SIDE_SELL, 50.0);
+    rest.mutable_new_order_single()->set_cl_ord_id("own-sell");
+    rest.mutable_new_order_single()->set_ord_type(fix::ORD_TYPE_LIMIT);
+    rest.mutable_new_order_single()->set_price(150.01);
+    mgr->handle_new_order(rest, "desk");
+
+    auto buy = make_new_order_msg("AAPL", fix::SIDE_BUY, 80.0);
+    buy.mutable_new_order_single()->set_cl_ord_id("own-buy");
+    auto responses = mgr->handle_new_order(buy, "desk");
+
+    // The buy filled against seed liquidity only; the own sell was cancelled
+    ASSERT_EQ(responses.size(), 1);
+    EXPECT_EQ(responses[0].execution_report().exec_type(), fix::EXEC_TYPE_FILL);
+    EXPECT_NE(responses[0].execution_report().last_px(), 150.01);
+    EXPECT_EQ(book_keeper.trade_count(), 1);
+    ASSERT_EQ(unsolicited.size(), 1u);
+    EXPECT_EQ(unsolicited[0].second.execution_report().cl_ord_id(), "own-sell");
+    EXPECT_EQ(unsolicited[0].second.execution_report().exec_type(), fix::EXEC_TYPE_CANCELLED);
+    EXPECT_EQ(mgr->find_order_by_cl_ord_id("own-sell")->status, OrderStatus::Cancelled);
+    EXPECT_EQ(mgr->open_order_count("desk"), 0);
+}
+
+TEST_F(OrderManagerTest, SelfTradePreventionStopsAtLimitPrice) {
+    matcher.set_self_trade_prevention(matching::SelfTradePrevention::CancelResting);
+    std::vector<std::pair<std::string, fix::FixMessage>> unsolicited;
+    mgr->set_report_sink([&](const std::string& session, const fix::FixMessage& report) {
+        unsolicited.emplace_back(session, report);
+    });
+    auto limit_order = [&](const std::string& cl_ord_id, fix::Side side, double qty,
+                           double price) {
+        auto msg = make_new_order_msg("MSFT", side, qty);
+        msg.mutable_new_order_single()->set_cl_ord_id(cl_ord_id);
+        msg.mutable_new_order_single()->set_ord_type(fix::ORD_TYPE_LIMIT);
+        msg.mutable_new_order_single()->set_price(price);
+        return msg;
+    };
+
+    // Own sell rests one tick beyond the buy's limit; another seller is inside it
+    mgr->handle_new_order(limit_order("own-sell", fix::SIDE_SELL, 50.0, 101.0), "desk");
+    auto other = limit_order("other-sell", fix::SIDE_SELL, 30.0, 100.0);
+    other.mutable_new_order_single()->set_text("other_strat");
+    mgr->handle_new_order(other, "other");
+    auto responses = mgr->handle_new_order(limit_order("own-buy", fix::SIDE_BUY, 80.0, 100.0),
+                                           "desk");
+
+    // Only the level inside the limit trades; the own sell beyond it is untouched
+    ASSERT_EQ(responses.size(), 1);
+    EXPECT_EQ(responses[0].execution_report().exec_type(), fix::EXEC_TYPE_PARTIAL_FILL);
+    EXPECT_EQ(responses[0].execution_report().last_qty(), 30.0);
+    for (const auto& [session, report] : unsolicited) {
+        EXPECT_NE(report.execution_report().cl_ord_id(), "own-sell");
+    }
+    EXPECT_EQ(mgr->find_order_by_cl_ord_id("own-sell")->status, OrderStatus::Accepted);
+    EXPECT_EQ(matcher.get_book("MSFT")->best_ask(), core::Price(101.0));
+}
+
+TEST_F(OrderManagerTest, OrdersUseInstrumentMaster) {
+    instrument::InstrumentRegistry instruments;
+    instrument::Instrument es;
+    es.symbol = "ESZ6";
+    es.asset_class = instrument::AssetClass::Future;
+    es.contract_size = 50.0;
+    es.tick_size = 0.25;
+    const auto& row = instruments.add(es);
+    mgr->set_instruments(&instruments);
+    matcher.update_market_price("ESZ6", 5000.0);
+
+    // The message's multiplier is ignored for a symbol the master knows
+    auto msg = make_new_order_msg("ESZ6", fix::SIDE_BUY, 2.0);
+    msg.mutable_new_order_single()->mutable_instrument()->set_contract_multiplier(5.0);
+    auto responses = mgr->handle_new_order(msg);
+    ASSERT_EQ(responses[0].execution_report().exec_type(), fix::EXEC_TYPE_FILL);
+
+    const auto* order = mgr->find_order_by_cl_ord_id("test-001");
+    ASSERT_NE(order, nullptr);
+    EXPECT_EQ(order->instrument, &row);
+    EXPECT_DOUBLE_EQ(book_keeper.get_position("ESZ6")->multiplier, 50.0);
+
+    // Rejected orders register nothing, an empty symbol included
+    auto bad = make_new_order_msg("NQZ6", fix::SIDE_BUY, -1.0);
+    EXPECT_TRUE(mgr->handle_new_order(bad)[0].has_reject());
+    EXPECT_TRUE(mgr->handle_new_order(make_new_order_msg(""))[0].has_reject());
+    EXPECT_EQ(instruments.size(), 1u);
+
+    // An accepted order for an unlisted symbol registers it from the message
+    auto nq = make_new_order_msg("NQZ6", fix::SIDE_BUY, 1.0);
+    nq.mutable_new_order_single()->set_cl_ord_id("nq-1");
+    nq.mutable_new_order_single()->set_ord_type(fix::ORD_TYPE_LIMIT);
+    nq.mutable_new_order_single()->set_price(100.0);
+    EXPECT_FALSE(mgr->handle_new_order(nq)[0].has_reject());
+    ASSERT_NE(instruments.find("NQZ6"), nullptr);
+    EXPECT_EQ(mgr->find_order_by_cl_ord_id("nq-1")->instrument, instruments.find("NQZ6"));
+
+    // With listed_only, the master is the whole universe
+    mgr->set_instruments(&instruments, true);
+    auto ym = make_new_order_msg("YMZ6", fix::SIDE_BUY, 1.0);
+    ym.mutable_new_order_single()->set_cl_ord_id("ym-1");
+    responses = mgr->handle_new_order(ym);
+    ASSERT_TRUE(responses[0].has_reject());
+    EXPECT_NE(responses[0].reject().text().find("Unknown symbol"), std::string::npos);
+    EXPECT_EQ(instruments.find("YMZ6"), nullptr);
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include "messaging/position_publisher.hpp"
+
+using namespace tradecore::booking;
+using namespace tradecore::messaging;
+using tradecore::orders::Side;
+
+namespace {
+
+Trade make_trade(const std::string& account, const std::string& symbol, Side side,
+                 double qty, double price) {
+    Trade trade;
+    trade.symbol = symbol;
+    trade.side = side;
+    trade.quantity = Qty(qty);
+    trade.price = Price(price);
+    trade.account = account;
+    trade.strategy_id = "s1";
+    return trade;
+}
+
+fix::FixMessage position_request(const std::string& id, const std::string& account,
+                                 fix::SubscriptionRequestType type) {
+    fix::FixMessage msg;
+    auto* req = msg.mutable_position_request();
+    req->set_pos_req_id(id);
+    req->set_account(account);
+    req->set_subscription_request_type(type);
+    return msg;
+}
+
+}  // namespace
+
+TEST(PositionPublisher, SnapshotThenOnlyChangedPositions) {
+    BookKeeper keeper;
+    MarkToMarket valuation;
+    PositionPublisher publisher(keeper, valuation);
+    std::vector<std::pair<std::string, fix::FixMessage>> pushed;
+    publisher.set_sink([&](const std::string& session, const fix::FixMessage& report) {
+        pushed.emplace_back(session, report);
+    });
+
+    keeper.book_trade(make_trade("ACC1", "AAPL", Side::Buy, 100, 150.0));
+    keeper.book_trade(make_trade("ACC1", "MSFT", Side::Buy, 10, 400.0));
+
+    auto snapshot = publisher.handle_request(
+        "c1", position_request("pr-1", "", fix::SUBSCRIPTION_SNAPSHOT_PLUS_UPDATES));
+    EXPECT_EQ(snapshot.position_report().positions_size(), 2);
+    EXPECT_FALSE(snapshot.position_report().unsolicited());
+    EXPECT_EQ(publisher.subscription_count(), 1);
+
+    publisher.publish();  // flushes changes the snapshot already covered
+    pushed.clear();
+
+    // Three fills on one symbol coalesce into one entry
+    keeper.book_trade(make_trade("ACC1", "AAPL", Side::Buy, 10, 151.0));
+    keeper.book_trade(make_trade("ACC1", "AAPL", Side::Sell, 20, 152.0));
+    keeper.book_trade(make_trade("ACC1", "AAPL", Side::Buy, 5, 150.0));
+    publisher.publish();
+    ASSERT_EQ(pushed.size(), 1);
+    EXPECT_EQ(pushed[0].first, "c1");
+    const auto& update = pushed[0].second.position_report();
+    EXPECT_TRUE(update.unsolicited());
+    EXPECT_EQ(update.pos_req_id(), "pr-1");
+    ASSERT_EQ(update.positions_size(), 1);
+    EXPECT_EQ(update.positions(0).instrument().symbol(), "AAPL");
+    EXPECT_DOUBLE_EQ(update.positions(0).long_qty(), 95.0);
+
+    publisher.publish();  // nothing changed, nothing sent
+    EXPECT_EQ(pushed.size(), 1);
+
+    publisher.handle_request("c1", position_request("pr-1", "", fix::SUBSCRIPTION_DISABLE));
+    EXPECT_EQ(publisher.subscription_count(), 0);
+}
+
+TEST(PositionPublisher, AccountSubscriptionStartsWithItsFirstTrade) {
+    BookKeeper keeper;
+    MarkToMarket valuation;
+    PositionPublisher publisher(keeper, valuation);
+    size_t pushed = 0;
+    publisher.set_sink([&](const std::string&, const fix::FixMessage& report) {
+        ++pushed;
+        EXPECT_EQ(report.position_report().positions_size(), 1);
+    });
+
+    auto snapshot = publisher.handle_request(
+        "c1", position_request("pr-2", "ACC2", fix::SUBSCRIPTION_SNAPSHOT_PLUS_UPDATES));
+    EXPECT_EQ(snapshot.position_report().positions_size(), 0);
+
+    keeper.book_trade(make_trade("ACC1", "AAPL", Side::Buy, 100, 150.0));  // other account
+    publisher.publish();
+    EXPECT_EQ(pushed, 0);
+
+    keeper.book_trade(make_trade("ACC2", "AAPL", Side::Buy, 5, 150.0));
+    publisher.publish();
+    EXPECT_EQ(pushed, 1);
+
+    publisher.unsubscribe("c1");
+    EXPECT_EQ(publisher.subscription_count(), 0);
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include "instrument/instrument_registry.hpp"
+#include "risk/risk_engine.hpp"
+
+using namespace tradecore;
+using namespace tradecore::risk;
+
+class RiskEngineTest : public ::testing::Test {
+protected:
+    booking::BookKeeper book_keeper;
+    instrument::InstrumentRegistry instruments;
+
+    orders::Order make_order(double qty, double limit_price = 0.0,
+                             orders::Side side = orders::Side::Buy,
+                             const std::string& account = "ACC1") {
+        orders::Order order;
+        order.cl_ord_id = "risk-001";
+        order.instrument = &instruments.intern("AAPL");
+        order.side = side;
+        order.quantity = orders::Qty(qty);
+        order.account = account;
+        if (limit_price > 0.0) {
+            order.order_type = orders::OrderType::Limit;
+            order.limit_price = orders::Price(limit_price);
+        }
+        return order;
+    }
+
+    void book(orders::Side side, double qty, double price) {
+        booking::Trade trade;
+        trade.symbol = "AAPL";
+        trade.side = side;
+        trade.quantity = booking::Qty(qty);
+        trade.price = booking::Price(price);
+        book_keeper.book_trade(trade);
+    }
+};
+
+TEST_F(RiskEngineTest, NoLimitsPassesEverything) {
+    RiskEngine risk(book_keeper);
+    EXPECT_EQ(risk.check(make_order(1e9), 150.0), "");
+    EXPECT_EQ(risk.generation(), 1u);
+}
+
+TEST_F(RiskEngineTest, FatFingerQuantity) {
+    LimitSet limits;
+    limits.defaults.max_order_qty = 1000.0;
+    limits.symbols["AAPL"].max_order_qty = 5000.0;
+    RiskEngine risk(book_keeper, limits);
+
+    EXPECT_EQ(risk.check(make_order(5000.0), 150.0), "");
+    EXPECT_NE(risk.check(make_order(5001.0), 150.0).find("OrderQty"), std::string::npos);
+
+    auto msft = make_order(1001.0);
+    msft.instrument = &instruments.intern("MSFT");
+    EXPECT_FALSE(risk.check(msft, 300.0).empty());
+}
+
+TEST_F(RiskEngineTest, NotionalUsesReferencePriceForMarketOrders) {
+    LimitSet limits;
+    limits.accounts["ACC1"].max_order_notional = 100000.0;
+    RiskEngine risk(book_keeper, limits);
+
+    EXPECT_EQ(risk.check(make_order(600.0), 150.0), "");
+    EXPECT_FALSE(risk.check(make_order(700.0), 150.0).empty());
+    EXPECT_EQ(risk.check(make_order(700.0), 0.0), "");             // no reference price
+    EXPECT_FALSE(risk.check(make_order(700.0, 150.0), 0.0).empty());  // limit price known
+    EXPECT_EQ(risk.check(make_order(700.0, 0.0, orders::Side::Buy, "ACC2"), 150.0), "");
+}
+
+TEST_F(RiskEngineTest, PriceCollar) {
+    LimitSet limits;
+    limits.defaults.price_collar_bps = 500.0;  // 5%
+    RiskEngine risk(book_keeper, limits);
+
+    EXPECT_EQ(risk.check(make_order(10.0, 157.0), 150.0), "");
+    EXPECT_FALSE(risk.check(make_order(10.0, 158.0), 150.0).empty());
+    EXPECT_FALSE(risk.check(make_order(10.0, 142.0, orders::Side::Sell), 150.0).empty());
+    EXPECT_EQ(risk.check(make_order(10.0), 150.0), "");  // market orders are not collared
+}
+
+TEST_F(RiskEngineTest, PositionLimitReadsLiveBookKeeperPosition) {
+    LimitSet limits;
+    limits.defaults.max_position = 1000.0;
+    RiskEngine risk(book_keeper, limits);
+
+    EXPECT_EQ(risk.check(make_order(1000.0), 150.0), "");
+    book(orders::Side::Buy, 800.0, 150.0);
+    EXPECT_FALSE(risk.check(make_order(300.0), 150.0).empty());
+    EXPECT_EQ(risk.check(make_order(200.0), 150.0), "");
+
+    book(orders::Side::Buy, 500.0, 150.0);  // now over the limit: reducing orders still pass
+    EXPECT_EQ(risk.check(make_order(300.0, 0.0, orders::Side::Sell), 150.0), "");
+    EXPECT_FALSE(risk.check(make_order(1.0), 150.0).empty());
+}
+
+TEST_F(RiskEngineTest, OrderRateThrottlePerAccount) {
+    LimitSet limits;
+    limits.defaults.max_orders_per_sec = 3;
+    RiskEngine risk(book_keeper, limits);
+
+    auto t0 = RiskEngine::Clock::now();
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(risk.check(make_order(1.0), 150.0, t0), "");
+    }
+    EXPECT_NE(risk.check(make_order(1.0), 150.0, t0).find("order rate"), std::string::npos);
+    EXPECT_EQ(risk.check(make_order(1.0, 0.0, orders::Side::Buy, "ACC2"), 150.0, t0), "");
+    EXPECT_EQ(risk.check(make_order(1.0), 150.0, t0 + std::chrono::seconds(1)), "");
+}
+
+TEST_F(RiskEngineTest, PublishSwapsLimits) {
+    RiskEngine risk(book_keeper);
+    EXPECT_EQ(risk.check(make_order(5000.0), 150.0), "");
+
+    LimitSet tighter;
+    tighter.defaults.max_order_qty = 100.0;
+    risk.publish(tighter);
+    EXPECT_EQ(risk.generation(), 2u);
+    EXPECT_FALSE(risk.check(make_order(5000.0), 150.0).empty());
+
+    risk.publish(LimitSet{});
+    EXPECT_EQ(risk.check(make_order(5000.0), 150.0), "");
+}
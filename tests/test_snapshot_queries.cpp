@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include "booking/book_keeper.hpp"
+#include "messaging/snapshot_queries.hpp"
+
+using namespace tradecore;
+using namespace tradecore::booking;
+using namespace tradecore::messaging;
+using tradecore::orders::Side;
+
+namespace {
+
+Trade make_trade(const std::string& account, const std::string& strategy,
+                 const std::string& symbol, double qty, double price) {
+    Trade trade;
+    trade.symbol = symbol;
+    trade.side = Side::Buy;
+    trade.quantity = Qty(qty);
+    trade.price = Price(price);
+    trade.account = account;
+    trade.strategy_id = strategy;
+    return trade;
+}
+
+fix::FixMessage position_request(const std::string& account, const std::string& strategy) {
+    fix::FixMessage msg;
+    auto* req = msg.mutable_position_request();
+    req->set_pos_req_id("q1");
+    req->set_account(account);
+    req->set_text(strategy);
+    return msg;
+}
+
+matching::BookSnapshot two_sided_book() {
+    matching::BookSnapshot book;
+    book.bid_levels = 2;
+    book.bids[0] = {Price(99.0), Qty(10.0), 1};
+    book.bids[1] = {Price(98.0), Qty(20.0), 2};
+    book.ask_levels = 1;
+    book.asks[0] = {Price(101.0), Qty(5.0), 1};
+    book.version = 7;
+    return book;
+}
+
+}  // namespace
+
+TEST(SnapshotQueries, DepthFromPublishedBook) {
+    matching::BookSnapshots books;
+    PositionSnapshots positions;
+    books.store("AAPL", two_sided_book());
+    SnapshotQueries queries(books, positions);
+
+    fix::FixMessage msg;
+    msg.set_sender_comp_id("CLIENT");
+    auto* req = msg.mutable_market_data_request();
+    req->set_md_req_id("md-1");
+    req->set_symbol("AAPL");
+    req->set_market_depth(1);
+
+    auto response = queries.answer(msg);
+    ASSERT_TRUE(response.has_market_data_snapshot());
+    const auto& snap = response.market_data_snapshot();
+    EXPECT_EQ(snap.md_req_id(), "md-1");
+    EXPECT_EQ(snap.rpt_seq(), 7u);
+    ASSERT_EQ(snap.entries_size(), 2);  // one level a side
+    EXPECT_EQ(snap.entries(0).price(), 99.0);
+    EXPECT_EQ(snap.entries(1).entry_type(), fix::MD_ENTRY_TYPE_OFFER);
+    EXPECT_EQ(snap.top_of_book().offer_px(), 101.0);
+    EXPECT_EQ(response.target_comp_id(), "CLIENT");
+
+    req->set_symbol("MSFT");
+    EXPECT_TRUE(queries.answer(msg).has_reject());
+}
+
+TEST(SnapshotQueries, PositionsAtEachLevel) {
+    matching::BookSnapshots books;
+    PositionSnapshots positions;
+    BookKeeper keeper;
+    keeper.set_snapshots(&positions);
+    keeper.book_trade(make_trade("ACC1", "momo", "AAPL", 10, 95.0));
+    keeper.book_trade(make_trade("ACC1", "mr", "AAPL", 5, 95.0));
+    keeper.book_trade(make_trade("ACC2", "momo", "MSFT", 3, 300.0));
+    books.store("AAPL", two_sided_book());
+    SnapshotQueries queries(books, positions);
+
+    auto firm = queries.answer(position_request("", ""));
+    ASSERT_TRUE(firm.has_position_report());
+    EXPECT_EQ(firm.position_report().pos_req_id(), "q1");
+    EXPECT_EQ(firm.position_report().positions_size(), 2);
+
+    auto account = queries.answer(position_request("ACC1", "")).position_report();
+    ASSERT_EQ(account.positions_size(), 1);
+    EXPECT_EQ(account.positions(0).instrument().symbol(), "AAPL");
+    EXPECT_EQ(account.positions(0).long_qty(), 15.0);
+    // Valued at the published mid, 100
+    EXPECT_DOUBLE_EQ(account.positions(0).unrealized_pnl(), 75.0);
+
+    auto strategy = queries.answer(position_request("ACC1", "mr")).position_report();
+    ASSERT_EQ(strategy.positions_size(), 1);
+    EXPECT_EQ(strategy.positions(0).long_qty(), 5.0);
+
+    EXPECT_EQ(queries.answer(position_request("NOPE", "")).position_report().positions_size(), 0);
+
+    // Subscriptions need the change feed, which only the order session has
+    auto subscribe = position_request("ACC1", "");
+    subscribe.mutable_position_request()->set_subscription_request_type(
+        fix::SUBSCRIPTION_SNAPSHOT_PLUS_UPDATES);
+    EXPECT_TRUE(queries.answer(subscribe).has_reject());
+}
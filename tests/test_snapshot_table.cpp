@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "core/snapshot_table.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+using namespace tradecore::core;
+
+namespace {
+
+// Every field derives from n, so a torn read shows up as a mismatch
+struct Sample {
+    uint64_t n = 0;
+    uint64_t twice = 0;
+    double half = 0.0;
+    char tag[13] = {};
+};
+
+Sample sample(uint64_t n) {
+    Sample s;
+    s.n = n;
+    s.twice = n * 2;
+    s.half = static_cast<double>(n) / 2;
+    s.tag[n % 12] = 'x';
+    return s;
+}
+
+bool consistent(const Sample& s) {
+    return s.twice == s.n * 2 && s.half == static_cast<double>(s.n) / 2 && s.tag[s.n % 12] == 'x';
+}
+
+}  // namespace
+
+TEST(SnapshotTable, StoresAndLoadsByKey) {
+    SnapshotTable<Sample> table(4);
+    Sample out;
+    EXPECT_FALSE(table.load("AAPL", out));
+
+    EXPECT_TRUE(table.store("AAPL", sample(7)));
+    EXPECT_TRUE(table.store("MSFT", sample(9)));
+    EXPECT_TRUE(table.store("AAPL", sample(8)));
+    ASSERT_TRUE(table.load("AAPL", out));
+    EXPECT_EQ(out.n, 8u);
+    ASSERT_TRUE(table.load("MSFT", out));
+    EXPECT_EQ(out.n, 9u);
+    EXPECT_EQ(table.size(), 2u);
+
+    size_t seen = 0;
+    table.for_each([&](const std::string&, const Sample& s) { seen += consistent(s); });
+    EXPECT_EQ(seen, 2u);
+}
+
+TEST(SnapshotTable, FullTableRefusesNewKeys) {
+    SnapshotTable<Sample> table(2);
+    EXPECT_TRUE(table.store("A", sample(1)));
+    EXPECT_TRUE(table.store("B", sample(2)));
+    EXPECT_FALSE(table.store("C", sample(3)));
+    EXPECT_EQ(table.slot("C"), SnapshotTable<Sample>::kFull);
+    EXPECT_TRUE(table.store("A", sample(4)));  // existing keys still update
+}
+
+TEST(SnapshotTable, ReadersNeverSeeTornValues) {
+    SnapshotTable<Sample> table(64);
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> torn{0};
+
+    std::thread reader([&] {
+        Sample s;
+        uint64_t last = 0;
+        while (!done.load(std::memory_order_acquire)) {
+            if (!table.load("K7", s)) continue;
+            if (!consistent(s) || s.n < last) torn.fetch_add(1);
+            last = s.n;
+        }
+    });
+
+    for (uint64_t n = 1; n <= 200000; ++n) {
+        table.store("K" + std::to_string(n % 16), sample(n));
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+    EXPECT_EQ(torn.load(), 0u);
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include "core/timer_wheel.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace tradecore::core;
+using namespace std::chrono_literals;
+
+class TimerWheelTest : public ::testing::Test {
+protected:
+    TimerWheel<std::string>::Clock::time_point t0 = TimerWheel<std::string>::Clock::now();
+    TimerWheel<std::string> wheel{10ms, 8, t0};
+    std::vector<std::string> fired;
+
+    void advance(std::chrono::milliseconds to) {
+        wheel.advance(t0 + to, [&](const std::string& key) { fired.push_back(key); });
+    }
+};
+
+TEST_F(TimerWheelTest, FiresAtDeadlineNotBefore) {
+    wheel.schedule("a", t0 + 25ms);
+    wheel.schedule("b", t0 + 40ms);
+    advance(20ms);
+    EXPECT_TRUE(fired.empty());
+    advance(30ms);
+    ASSERT_EQ(fired, std::vector<std::string>{"a"});
+    EXPECT_FALSE(wheel.contains("a"));
+    advance(40ms);
+    EXPECT_EQ(fired.size(), 2u);
+    EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST_F(TimerWheelTest, RescheduleDefersExpiry) {
+    wheel.schedule("hb", t0 + 30ms);
+    for (int ms = 20; ms <= 200; ms += 20) {
+        wheel.schedule("hb", t0 + std::chrono::milliseconds(ms + 30));
+        advance(std::chrono::milliseconds(ms));
+    }
+    EXPECT_TRUE(fired.empty());
+    advance(240ms);
+    ASSERT_EQ(fired, std::vector<std::string>{"hb"});
+}
+
+TEST_F(TimerWheelTest, EarlierDeadlineAndCancel) {
+    wheel.schedule("x", t0 + 70ms);
+    wheel.schedule("x", t0 + 15ms);
+    wheel.schedule("y", t0 + 15ms);
+    EXPECT_TRUE(wheel.cancel("y"));
+    EXPECT_FALSE(wheel.cancel("y"));
+    advance(20ms);
+    ASSERT_EQ(fired, std::vector<std::string>{"x"});
+    advance(100ms);  // the superseded entry for x does not fire again
+    EXPECT_EQ(fired.size(), 1u);
+}
+
+TEST_F(TimerWheelTest, DeadlinesBeyondOneLapAndStalls) {
+    wheel.schedule("far", t0 + 250ms);  // three laps of an 80ms wheel
+    advance(240ms);
+    EXPECT_TRUE(fired.empty());
+    advance(250ms);
+    ASSERT_EQ(fired, std::vector<std::string>{"far"});
+
+    // A poll loop stalled for many laps still fires everything due
+    fired.clear();
+    wheel.schedule("p", t0 + 300ms);
+    wheel.schedule("q", t0 + 5000ms);
+    advance(2000ms);
+    ASSERT_EQ(fired, std::vector<std::string>{"p"});
+    advance(5000ms);
+    EXPECT_EQ(fired.size(), 2u);
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include "booking/trade_archive.hpp"
+
+using namespace tradecore::booking;
+using namespace tradecore::core;
+using tradecore::orders::Side;
+
+class TradeArchiveTest : public ::testing::Test {
+protected:
+    std::string temp_dir_;
+
+    void SetUp() override {
+        temp_dir_ = std::filesystem::temp_directory_path() / "tradecore_test_archive";
+        std::filesystem::create_directories(temp_dir_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(temp_dir_);
+    }
+
+    static std::vector<Trade> make_trades(size_t n) {
+        const char* symbols[] = {"AAPL", "MSFT", "EURUSD"};
+        std::vector<Trade> trades;
+        for (size_t i = 0; i < n; ++i) {
+            Trade t;
+            t.trade_id = "T-" + std::to_string(100000 + i);
+            t.order_id = "O-" + std::to_string(50000 + i / 3);
+            t.cl_ord_id = "C-" + std::to_string(i / 3);
+            t.symbol = symbols[i % 3];
+            t.side = i % 2 ? Side::Sell : Side::Buy;
+            t.quantity = Qty(static_cast<double>(100 + i % 7));
+            t.price = Price(150.0 + static_cast<double>(i % 11) * 0.01);
+            t.commission = 0.25 * static_cast<double>(i % 4);
+            char ts[32];
+            std::snprintf(ts, sizeof(ts), "20240315-14:%02zu:%02zu.%03zu",
+                          i / 60000 % 60, i / 1000 % 60, i % 1000);
+            t.timestamp = ts;
+            t.strategy_id = i % 5 ? "momentum" : "";
+            t.account = "ACC-1";
+            trades.push_back(t);
+        }
+        return trades;
+    }
+
+    static void expect_equal(const Trade& a, const Trade& b) {
+        EXPECT_EQ(a.trade_id, b.trade_id);
+        EXPECT_EQ(a.order_id, b.order_id);
+        EXPECT_EQ(a.cl_ord_id, b.cl_ord_id);
+        EXPECT_EQ(a.symbol, b.symbol);
+        EXPECT_EQ(a.side, b.side);
+        EXPECT_EQ(a.quantity, b.quantity);
+        EXPECT_EQ(a.price, b.price);
+        EXPECT_DOUBLE_EQ(a.commission, b.commission);
+        EXPECT_EQ(a.timestamp, b.timestamp);
+        EXPECT_EQ(a.strategy_id, b.strategy_id);
+        EXPECT_EQ(a.account, b.account);
+    }
+};
+
+TEST_F(TradeArchiveTest, RoundTripAcrossChunks) {
+    auto trades = make_trades(2500);
+    auto path = temp_dir_ + "/trades.tca";
+
+    TradeArchiveWriter writer(1000);
+    ASSERT_EQ(writer.open(path), "");
+    writer.append_all(trades);
+    ASSERT_EQ(writer.close(), "");
+    EXPECT_EQ(writer.rows_written(), 2500u);
+    EXPECT_EQ(writer.bytes_written(), std::filesystem::file_size(path));
+
+    TradeArchiveReader reader;
+    ASSERT_EQ(reader.open(path), "");
+    EXPECT_EQ(reader.chunk_count(), 3u);
+    EXPECT_EQ(reader.row_count(), 2500u);
+
+    size_t i = 0;
+    ASSERT_TRUE(reader.for_each([&](const Trade& t) { expect_equal(t, trades[i++]); }));
+    EXPECT_EQ(i, trades.size());
+
+    // Columns are usable directly, without building Trades
+    TradeColumns cols;
+    ASSERT_TRUE(reader.read_chunk(2, cols));
+    ASSERT_EQ(cols.size(), 500u);
+    EXPECT_TRUE(cols.timestamp.empty());
+    EXPECT_EQ(cols.symbols.size(), 3u);
+    EXPECT_EQ(cols.symbols[cols.symbol[0]], trades[2000].symbol);
+    EXPECT_EQ(cols.time_ms[1] - cols.time_ms[0], 1);
+}
+
+TEST_F(TradeArchiveTest, ColumnsAreSmallerThanRows) {
+    auto trades = make_trades(10000);
+    auto path = temp_dir_ + "/trades.tca";
+    TradeArchiveWriter writer;
+    ASSERT_EQ(writer.open(path), "");
+    writer.append_all(trades);
+    ASSERT_EQ(writer.close(), "");
+
+    size_t row_bytes = 0;
+    for (const auto& t : trades) {
+        row_bytes += t.trade_id.size() + t.order_id.size() + t.cl_ord_id.size() +
+                     t.symbol.size() + t.timestamp.size() + t.strategy_id.size() +
+                     t.account.size() + 1 + 3 * 8;
+    }
+    EXPECT_LT(writer.bytes_written() * 8, row_bytes);
+}
+
+TEST_F(TradeArchiveTest, KeepsTimestampsItCannotParse) {
+    auto trades = make_trades(4);
+    trades[1].timestamp = "";
+    trades[2].timestamp = "2024-03-15T14:00:00Z";
+    auto path = temp_dir_ + "/trades.tca";
+    TradeArchiveWriter writer;
+    ASSERT_EQ(writer.open(path), "");
+    writer.append_all(trades);
+    ASSERT_EQ(writer.close(), "");
+
+    TradeArchiveReader reader;
+    ASSERT_EQ(reader.open(path), "");
+    size_t i = 0;
+    ASSERT_TRUE(reader.for_each([&](const Trade& t) { expect_equal(t, trades[i++]); }));
+    EXPECT_EQ(i, 4u);
+}
+
+TEST_F(TradeArchiveTest, RejectsForeignAndTruncatedFiles) {
+    TradeArchiveReader reader;
+    EXPECT_NE(reader.open(temp_dir_ + "/missing.tca"), "");
+
+    auto junk = temp_dir_ + "/junk.tca";
+    std::ofstream(junk) << "not an archive at all";
+    EXPECT_NE(reader.open(junk), "");
+
+    auto path = temp_dir_ + "/trades.tca";
+    TradeArchiveWriter writer;
+    ASSERT_EQ(writer.open(path), "");
+    writer.append_all(make_trades(100));
+    ASSERT_EQ(writer.close(), "");
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 10);
+    EXPECT_NE(reader.open(path), "");
+}